@@ -10,6 +10,10 @@
 #include "../src/core/utils/console.h"
 #include "../src/core/diagnostics/diagnostics.h"
 #include "../src/core/rendering/primitives/global_quad.h"
+#include "../src/core/rendering/instancing/instancing.h"
+#include "../src/core/rendering/texture/upload_ring.h"
+#include "../src/core/rendering/texture/texture_streaming.h"
+#include "../src/core/rendering/geometry/geometry_arena.h"
 
 namespace ApplicationContext {
 
@@ -135,10 +139,21 @@ namespace ApplicationContext {
 
 		// Create essential primitives
 		GlobalQuad::create();
+		Instancing::create();
+		GeometryArena::create();
+		UploadRing::create();
+
+		// Setup texture streaming
+		TextureStreaming::setBudget(configuration.textureBudget);
 	}
 
 	void destroy()
 	{
+		// Destroy essential primitives
+		UploadRing::destroy();
+		GeometryArena::destroy();
+		Instancing::destroy();
+
 		// Destroy window and terminate glfw
 		if (gWindow != nullptr)
 		{
@@ -152,6 +167,12 @@ namespace ApplicationContext {
 		// Update glfw events
 		glfwPollEvents();
 
+		// Reclaim upload ring regions the gpu finished reading from
+		UploadRing::retire();
+
+		// Stream texture levels requested during the last frame in and out
+		TextureStreaming::update();
+
 		// Make global resource loader dispatch next pending resource to gpu
 		gResourceLoader.dispatchNext();
 
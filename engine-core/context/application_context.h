@@ -2,6 +2,7 @@
 
 #include <glm.hpp>
 #include <string>
+#include <cstddef>
 
 #include "../src/core/backend/api.h"
 #include "../src/core/resource/resource_loader.h"
@@ -22,6 +23,7 @@ namespace ApplicationContext
 		bool vsync = true;
 		bool resizeable = true;
 		bool visible = true;
+		size_t textureBudget = 2ull * 1024 * 1024 * 1024;
 	};
 
 	// Creates application context with given configuration
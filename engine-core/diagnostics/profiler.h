@@ -13,6 +13,9 @@ namespace Profiler
 	// Stops profiling for given identifier and returns time
 	double stop(const std::string& identifier);
 
+	// Caches the given time in microseconds for given identifier, for timings measured elsewhere
+	void record(const std::string& identifier, double time);
+
 	// Returns last cached time for given identifier in milliseconds
 	double getMs(const std::string& identifier);
 
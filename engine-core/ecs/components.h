@@ -27,9 +27,6 @@ struct TransformComponent {
 	// Optional parent
 	const TransformComponent* parent = nullptr;
 
-	// Latest computed model-view-projection matrix
-	glm::mat4 mvp = glm::mat4(1.0f);
-
 	// Latest computed model matrix
 	glm::mat4 model = glm::mat4(1.0f);
 
@@ -53,6 +50,16 @@ struct MeshRendererComponent {
 	const IMaterial* material;
 };
 
+struct BoundsComponent {
+
+	// Minimum point of the world space bounding box
+	glm::vec3 min = glm::vec3(0.0f);
+
+	// Maximum point of the world space bounding box
+	glm::vec3 max = glm::vec3(0.0f);
+
+};
+
 struct CameraComponent {
 
 	// Set if component is enabled
@@ -3,17 +3,66 @@
 #include <random>
 #include <glm.hpp>
 #include <algorithm>
+#include <unordered_map>
 
 #include "../src/core/utils/console.h"
 #include "../src/core/ecs/reflection.h"
 #include "../src/core/transform/transform.h"
+#include "../src/core/transform/transform_system.h"
 
 namespace ECS {
 
+	// Global render queue containing all mesh renderers
 	RenderQueue gRenderQueue;
 
+	// Index of each queued entity within the global render queue
+	std::unordered_map<Entity, size_t> gRenderQueueSlots;
+
+	// Appends an entity to the global render queue
+	void _enqueue(Registry& /*registry*/, Entity entity)
+	{
+		gRenderQueueSlots[entity] = gRenderQueue.size();
+		gRenderQueue.push_back({ 0, entity });
+	}
+
+	// Removes an entity from the global render queue by swapping it with the last entry
+	void _dequeue(Registry& /*registry*/, Entity entity)
+	{
+		auto slot = gRenderQueueSlots.find(entity);
+		if (slot == gRenderQueueSlots.end()) return;
+
+		// Move last entry into the freed slot
+		RenderQueueItem last = gRenderQueue.back();
+		gRenderQueue[slot->second] = last;
+		gRenderQueueSlots[last.entity] = slot->second;
+		gRenderQueue.pop_back();
+
+		gRenderQueueSlots.erase(slot);
+	}
+
+	// Attaches a bounds component to each entity with a mesh renderer
+	void _attachBounds(Registry& registry, Entity entity)
+	{
+		registry.emplace_or_replace<BoundsComponent>(entity);
+	}
+
+	// Detaches the bounds component once the mesh renderer of an entity is removed
+	void _detachBounds(Registry& registry, Entity entity)
+	{
+		registry.remove<BoundsComponent>(entity);
+	}
+
 	void setup() {
 		Reflection::setup();
+		TransformSystem::setup();
+
+		// Keep world bounds alongside mesh renderers
+		gRegistry.on_construct<MeshRendererComponent>().connect<&_attachBounds>();
+		gRegistry.on_destroy<MeshRendererComponent>().connect<&_detachBounds>();
+
+		// Maintain render queue incrementally
+		gRegistry.on_construct<MeshRendererComponent>().connect<&_enqueue>();
+		gRegistry.on_destroy<MeshRendererComponent>().connect<&_dequeue>();
 	}
 
 	std::tuple<Entity, TransformComponent&> createEntity(TransformComponent* parent)
@@ -25,48 +74,18 @@ namespace ECS {
 		// Add parent if set
 		if (parent) transform.parent = parent;
 
-		// Perform initial transform evaluation with empty perspective matrix
-		Transform::evaluate(transform, glm::perspective(0.0f, 0.0f, 0.0f, 0.0f));
+		// Perform initial transform evaluation
+		Transform::evaluate(transform);
 
 		// Return entity and transform component
 		return std::tuple<Entity, TransformComponent&>(entity, transform);
 	}
 
-	RenderQueue& getRenderQueue()
+	const RenderQueue& getRenderQueue()
 	{
 		return gRenderQueue;
 	}
 
-	void generateRenderQueue()
-	{
-		// Fill target queue
-		std::vector<Entity> targetQueue;
-
-		gRegistry.view<MeshRendererComponent>().each([&](auto entity, const auto&) { 
-			targetQueue.push_back(entity); 
-		});
-
-		// Sort targets by shader and material
-		std::sort(targetQueue.begin(), targetQueue.end(), [&](auto lhsEntity, auto rhsEntity) {
-			MeshRendererComponent& lhs = gRegistry.get<MeshRendererComponent>(lhsEntity);
-			auto lhsShaderId = lhs.material ? lhs.material->getShaderId() : -1;
-			auto lhsMaterialId = lhs.material ? lhs.material->getId() : -1;
-
-			MeshRendererComponent& rhs = gRegistry.get<MeshRendererComponent>(rhsEntity);
-			auto rhsShaderId = rhs.material ? rhs.material->getShaderId() : -1;
-			auto rhsMaterialId = rhs.material ? rhs.material->getId() : -1;
-
-			return std::tie(lhsShaderId, lhsMaterialId) < std::tie(rhsShaderId, rhsMaterialId);
-		});
-
-		// Fill render queue
-		gRenderQueue.clear();
-
-		for (auto entity : targetQueue) {
-			gRenderQueue.emplace_back(entity, gRegistry.get<TransformComponent>(entity), gRegistry.get<MeshRendererComponent>(entity));
-		}
-	}
-
 	std::optional<Camera> getLatestCamera() {
 		auto group = gRegistry.group<TransformComponent>(entt::get<CameraComponent>);
 		for (auto entity : group) {
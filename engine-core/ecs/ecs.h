@@ -12,7 +12,14 @@ using namespace entt::literals;
 
 using Entity = entt::entity;
 using Registry = entt::registry;
-using RenderQueue = std::vector<std::tuple<Entity, TransformComponent&, MeshRendererComponent&>>;
+
+// Entry of a render queue, ordered by its packed render key
+struct RenderQueueItem {
+	uint64_t key;
+	Entity entity;
+};
+
+using RenderQueue = std::vector<RenderQueueItem>;
 using Camera = std::tuple<TransformComponent&, CameraComponent&>;
 
 namespace ECS {
@@ -33,11 +40,9 @@ namespace ECS {
 	// Creates an entity
 	std::tuple<Entity, TransformComponent&> createEntity(TransformComponent* parent = nullptr);
 
-	// Returns the global render queue
-	RenderQueue& getRenderQueue();
-
-	// (Re-)Generates the global render queue
-	void generateRenderQueue();
+	// Returns the global render queue containing all mesh renderers
+	// (Maintained by mesh renderer construction and destruction, unsorted; keys are assigned per view)
+	const RenderQueue& getRenderQueue();
 
 	//
 	// HELPER FUNCTIONS
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <PxPhysicsAPI.h>
+
+// Cpu dispatcher running physx tasks on the engines job system
+class PxJobDispatcher : public physx::PxCpuDispatcher
+{
+public:
+	// Queues the given physx task on the job system
+	void submitTask(physx::PxBaseTask& task) override;
+
+	// Returns the amount of threads executing jobs
+	uint32_t getWorkerCount() const override;
+};
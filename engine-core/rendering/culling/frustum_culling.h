@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm.hpp>
+
+namespace FrustumCulling
+{
+	// View frustum represented by six normalized planes (xyz = normal pointing inwards, w = distance)
+	struct Frustum
+	{
+		enum Plane
+		{
+			LEFT_PLANE,
+			RIGHT_PLANE,
+			BOTTOM_PLANE,
+			TOP_PLANE,
+			NEAR_PLANE,
+			FAR_PLANE,
+			N_PLANES
+		};
+
+		glm::vec4 planes[N_PLANES];
+	};
+
+	// Structure of arrays holding axis aligned bounding boxes as centers and half extents for batched testing
+	struct BoundsBatch
+	{
+		std::vector<float> centerX;
+		std::vector<float> centerY;
+		std::vector<float> centerZ;
+
+		std::vector<float> extentX;
+		std::vector<float> extentY;
+		std::vector<float> extentZ;
+
+		// Removes all bounds from the batch
+		void clear();
+
+		// Reserves memory for given amount of bounds
+		void reserve(size_t capacity);
+
+		// Resizes the batch to hold given amount of bounds
+		void resize(size_t size);
+
+		// Adds an axis aligned bounding box by its minimum and maximum point
+		void add(const glm::vec3& min, const glm::vec3& max);
+
+		// Overwrites the axis aligned bounding box at given index by its minimum and maximum point
+		void set(size_t index, const glm::vec3& min, const glm::vec3& max);
+
+		// Returns the amount of bounds in the batch
+		size_t size() const;
+	};
+
+	// Extracts the view frustum planes from a view-projection matrix
+	Frustum extract(const glm::mat4& viewProjection);
+
+	// Tests all bounds of the batch against the frustum and writes the indices of all visible bounds to the output
+	void test(const Frustum& frustum, const BoundsBatch& batch, std::vector<uint32_t>& visible);
+};
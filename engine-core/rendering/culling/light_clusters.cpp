@@ -0,0 +1,198 @@
+#include "light_clusters.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#include "../src/core/jobs/job_system.h"
+#include "../src/core/rendering/uniforms/light_uniforms.h"
+
+LightClusters::LightClusters() : clusterBuffer(),
+indexBuffer(),
+bounds(),
+slices(SLICES),
+clusters(),
+indices()
+{
+}
+
+void LightClusters::create()
+{
+	clusterBuffer.create();
+	indexBuffer.create();
+}
+
+void LightClusters::destroy()
+{
+	clusterBuffer.destroy();
+	indexBuffer.destroy();
+}
+
+void LightClusters::update(const LightUniforms& lights, const glm::mat4& view, const glm::mat4& projection, const glm::vec2& resolution)
+{
+	//
+	// SETUP GRID
+	//
+
+	// Tiles covering the view
+	glm::vec2 size = glm::max(resolution, glm::vec2(1.0f));
+	glm::uvec2 tiles = glm::uvec2(glm::ceil(size / static_cast<float>(TILE_SIZE)));
+
+	// Near and far plane of the perspective projection
+	float near = projection[3][2] / (projection[2][2] - 1.0f);
+	float far = projection[3][2] / (projection[2][2] + 1.0f);
+
+	// Slices are spaced logarithmically, keeping clusters roughly as deep as they are wide
+	float logRatio = std::log(far / near);
+	Header header;
+	header.grid = glm::uvec4(tiles, SLICES, TILE_SIZE);
+	header.slicing = glm::vec4(SLICES / logRatio, -(SLICES * std::log(near)) / logRatio, 0.0f, 0.0f);
+
+	//
+	// BOUND LIGHTS
+	//
+
+	// Returns the slice of the given view depth and the tile of the given normalized device coordinates
+	auto getSlice = [&](float depth) { return static_cast<uint32_t>(glm::clamp(std::log(depth) * header.slicing.x + header.slicing.y, 0.0f, SLICES - 1.0f)); };
+	auto getTile = [&](glm::vec2 ndc) { return glm::min(glm::uvec2((ndc * 0.5f + 0.5f) * size / static_cast<float>(TILE_SIZE)), tiles - 1u); };
+
+	// Bounds of the lights within the view, bounds past the point lights belong to spotlights
+	const std::vector<LightUniforms::PointLight>& pointLights = lights.getPointLights();
+	const std::vector<LightUniforms::Spotlight>& spotlights = lights.getSpotlights();
+	bounds.clear();
+	auto boundLight = [&](const glm::vec3& position, float range) {
+		LightBounds& light = bounds.emplace_back();
+		light.center = glm::vec3(view * glm::vec4(position, 1.0f));
+		light.radius = range;
+
+		// Lights outside of the depth range reach no cluster
+		float depth = -light.center.z;
+		light.firstSlice = 1;
+		light.lastSlice = 0;
+		if (depth + range < near || depth - range > far) return;
+
+		// Screen rectangle of the bounds, lights reaching the near plane may cover the whole view
+		glm::vec2 rectMin = glm::vec2(-1.0f);
+		glm::vec2 rectMax = glm::vec2(1.0f);
+		if (depth - range > near) {
+			rectMin = glm::vec2(FLT_MAX);
+			rectMax = glm::vec2(-FLT_MAX);
+			for (uint32_t corner = 0; corner < 8; corner++) {
+				glm::vec3 sign = glm::vec3(corner & 1 ? 1.0f : -1.0f, corner & 2 ? 1.0f : -1.0f, corner & 4 ? 1.0f : -1.0f);
+				glm::vec4 clip = projection * glm::vec4(light.center + range * sign, 1.0f);
+				rectMin = glm::min(rectMin, glm::vec2(clip) / clip.w);
+				rectMax = glm::max(rectMax, glm::vec2(clip) / clip.w);
+			}
+			rectMin = glm::max(rectMin, glm::vec2(-1.0f));
+			rectMax = glm::min(rectMax, glm::vec2(1.0f));
+			if (rectMin.x > rectMax.x || rectMin.y > rectMax.y) return;
+		}
+
+		// Clusters overlapped
+		light.firstSlice = getSlice(std::max(depth - range, near));
+		light.lastSlice = getSlice(std::min(depth + range, far));
+		light.firstTile = getTile(rectMin);
+		light.lastTile = getTile(rectMax);
+	};
+	for (const LightUniforms::PointLight& pointLight : pointLights) boundLight(pointLight.position, pointLight.range);
+	for (const LightUniforms::Spotlight& spotlight : spotlights) boundLight(spotlight.position, spotlight.range);
+
+	//
+	// BIN LIGHTS
+	//
+
+	// Bin each slice in parallel
+	uint32_t nPointLights = static_cast<uint32_t>(pointLights.size());
+	JobSystem::parallelFor(SLICES, 1, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t slice = begin; slice < end; slice++) {
+			binSlice(slice, nPointLights, tiles, size, projection, near, far);
+		}
+	});
+
+	// Merge slices behind the header
+	uint32_t tilesPerSlice = tiles.x * tiles.y;
+	clusters.resize(HEADER_CLUSTERS + tilesPerSlice * SLICES);
+	std::memcpy(clusters.data(), &header, sizeof(Header));
+	indices.clear();
+	for (uint32_t slice = 0; slice < SLICES; slice++) {
+		const SliceBins& bins = slices[slice];
+		uint32_t base = static_cast<uint32_t>(indices.size());
+		for (uint32_t tile = 0; tile < tilesPerSlice; tile++) {
+			Cluster cluster = bins.clusters[tile];
+			cluster.offset += base;
+			clusters[HEADER_CLUSTERS + slice * tilesPerSlice + tile] = cluster;
+		}
+		indices.insert(indices.end(), bins.indices.begin(), bins.indices.end());
+	}
+
+	// Upload and bind clusters
+	clusterBuffer.upload(clusters.data(), clusters.size() * sizeof(Cluster));
+	indexBuffer.upload(indices.data(), indices.size() * sizeof(uint32_t));
+	bind();
+}
+
+void LightClusters::bind() const
+{
+	clusterBuffer.bind(StorageBinding::LIGHT_CLUSTERS);
+	indexBuffer.bind(StorageBinding::LIGHT_INDICES);
+}
+
+void LightClusters::binSlice(uint32_t slice, uint32_t nPointLights, glm::uvec2 tiles, glm::vec2 size, const glm::mat4& projection, float near, float far)
+{
+	SliceBins& bins = slices[slice];
+	bins.hits.clear();
+
+	// Depth range of the slice
+	float sliceNear = near * std::pow(far / near, static_cast<float>(slice) / SLICES);
+	float sliceFar = near * std::pow(far / near, static_cast<float>(slice + 1) / SLICES);
+
+	// Returns the distance of a coordinate to the given range
+	auto getDistance = [](float coordinate, float min, float max) { return std::max({ min - coordinate, coordinate - max, 0.0f }); };
+
+	// Returns the view space range of the given tile row or column over the slices depth range
+	auto getRange = [&](uint32_t tile, float pixels, float scale) {
+		float ndcMin = static_cast<float>(tile * TILE_SIZE) / pixels * 2.0f - 1.0f;
+		float ndcMax = std::min(static_cast<float>((tile + 1) * TILE_SIZE) / pixels * 2.0f - 1.0f, 1.0f);
+		return std::make_pair(std::min(ndcMin * sliceNear, ndcMin * sliceFar) / scale, std::max(ndcMax * sliceNear, ndcMax * sliceFar) / scale);
+	};
+
+	// Collect overlaps of the lights bounding spheres with the slices clusters
+	for (uint32_t i = 0; i < bounds.size(); i++) {
+		const LightBounds& light = bounds[i];
+		if (slice < light.firstSlice || slice > light.lastSlice) continue;
+
+		float dz = getDistance(light.center.z, -sliceFar, -sliceNear);
+		for (uint32_t y = light.firstTile.y; y <= light.lastTile.y; y++) {
+			auto [minY, maxY] = getRange(y, size.y, projection[1][1]);
+			float dy = getDistance(light.center.y, minY, maxY);
+			for (uint32_t x = light.firstTile.x; x <= light.lastTile.x; x++) {
+				auto [minX, maxX] = getRange(x, size.x, projection[0][0]);
+				float dx = getDistance(light.center.x, minX, maxX);
+				if (dx * dx + dy * dy + dz * dz <= light.radius * light.radius) bins.hits.emplace_back(y * tiles.x + x, i);
+			}
+		}
+	}
+
+	// Count lights of each tile
+	bins.clusters.assign(tiles.x * tiles.y, Cluster{});
+	for (auto [tile, light] : bins.hits) {
+		if (light < nPointLights) bins.clusters[tile].pointLights++;
+		else bins.clusters[tile].spotlights++;
+	}
+
+	// Offset of each tiles light indices within the slice
+	uint32_t offset = 0;
+	for (Cluster& cluster : bins.clusters) {
+		cluster.offset = offset;
+		offset += cluster.pointLights + cluster.spotlights;
+	}
+
+	// Sort light indices by tile, hits are in light order so point lights precede spotlights within each tile
+	bins.indices.resize(offset);
+	bins.filled.assign(bins.clusters.size(), 0);
+	for (auto [tile, light] : bins.hits) {
+		uint32_t index = bins.clusters[tile].offset + bins.filled[tile]++;
+		bins.indices[index] = light < nPointLights ? light : light - nPointLights;
+	}
+}
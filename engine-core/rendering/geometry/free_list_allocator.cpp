@@ -0,0 +1,78 @@
+#include "free_list_allocator.h"
+
+#include <iterator>
+
+FreeListAllocator::FreeListAllocator(uint32_t capacity) : freeRanges(),
+capacity(0),
+used(0)
+{
+	grow(capacity);
+}
+
+uint32_t FreeListAllocator::allocate(uint32_t count)
+{
+	if (count == 0) return INVALID_OFFSET;
+
+	// Find first free range large enough
+	for (auto it = freeRanges.begin(); it != freeRanges.end(); it++) {
+		if (it->second < count) continue;
+
+		// Take allocation from the front of the free range
+		uint32_t offset = it->first;
+		uint32_t remaining = it->second - count;
+		freeRanges.erase(it);
+		if (remaining > 0) freeRanges.emplace(offset + count, remaining);
+
+		used += count;
+		return offset;
+	}
+
+	return INVALID_OFFSET;
+}
+
+void FreeListAllocator::release(uint32_t offset, uint32_t count)
+{
+	if (count == 0 || offset == INVALID_OFFSET) return;
+	used -= count;
+
+	// Insert released range
+	auto it = freeRanges.emplace(offset, count).first;
+
+	// Merge with following free range
+	auto next = std::next(it);
+	if (next != freeRanges.end() && it->first + it->second == next->first) {
+		it->second += next->second;
+		freeRanges.erase(next);
+	}
+
+	// Merge with preceding free range
+	if (it != freeRanges.begin()) {
+		auto previous = std::prev(it);
+		if (previous->first + previous->second == it->first) {
+			previous->second += it->second;
+			freeRanges.erase(it);
+		}
+	}
+}
+
+void FreeListAllocator::grow(uint32_t _capacity)
+{
+	if (_capacity <= capacity) return;
+
+	// Release added elements, merging them with a free range at the end of the region
+	uint32_t added = _capacity - capacity;
+	uint32_t offset = capacity;
+	capacity = _capacity;
+	used += added;
+	release(offset, added);
+}
+
+uint32_t FreeListAllocator::getCapacity() const
+{
+	return capacity;
+}
+
+uint32_t FreeListAllocator::getUsed() const
+{
+	return used;
+}
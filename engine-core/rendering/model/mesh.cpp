@@ -1,50 +1,107 @@
 #include "mesh.h"
 
-Mesh::Mesh() : vao(0),
-vbo(0),
-ebo(0),
-nVertices(0),
-nIndices(0),
-materialIndex(0)
+uint32_t Mesh::idCounter = 0;
+
+Mesh::Mesh() : id(0),
+vertices(),
+indices(),
+indexType(GeometryArena::IndexType::UINT32),
+materialIndex(0),
+minPoint(0.0f),
+maxPoint(0.0f),
+dequantization(1.0f),
+uvDensity(0.0f)
 {
 }
 
-void Mesh::setData(uint32_t _vao, uint32_t _vbo, uint32_t _ebo, uint32_t _nVertices, uint32_t _nIndices, uint32_t _materialIndex)
+void Mesh::setData(GeometryArena::Allocation _vertices, GeometryArena::Allocation _indices, GeometryArena::IndexType _indexType, uint32_t _materialIndex)
 {
-	vao = _vao;
-	vbo = _vbo;
-	ebo = _ebo;
-	nVertices = _nVertices;
-	nIndices = _nIndices;
+	id = ++idCounter;
+	vertices = _vertices;
+	indices = _indices;
+	indexType = _indexType;
 	materialIndex = _materialIndex;
 }
 
+uint32_t Mesh::getId() const
+{
+	return id;
+}
+
 uint32_t Mesh::getVAO() const
 {
-	return vao;
+	return GeometryArena::getVAO();
+}
+
+GeometryArena::Allocation Mesh::getVertices() const
+{
+	return vertices;
+}
+
+GeometryArena::Allocation Mesh::getIndices() const
+{
+	return indices;
+}
+
+GeometryArena::IndexType Mesh::getIndexType() const
+{
+	return indexType;
 }
 
-uint32_t Mesh::getVBO() const
+uint32_t Mesh::getBaseVertex() const
 {
-	return vbo;
+	return vertices.offset;
 }
 
-uint32_t Mesh::getEBO() const
+uint32_t Mesh::getFirstIndex() const
 {
-	return ebo;
+	return indices.offset;
 }
 
 uint32_t Mesh::getVerticeCount() const
 {
-	return nVertices;
+	return vertices.count;
 }
 
 uint32_t Mesh::getIndiceCount() const
 {
-	return nIndices;
+	return indices.count;
 }
 
 uint32_t Mesh::getMaterialIndex() const
 {
 	return materialIndex;
 }
+
+
+void Mesh::setBounds(glm::vec3 _minPoint, glm::vec3 _maxPoint)
+{
+	minPoint = _minPoint;
+	maxPoint = _maxPoint;
+	dequantization = GeometryArena::getDequantization(minPoint, maxPoint);
+}
+
+glm::vec3 Mesh::getMinPoint() const
+{
+	return minPoint;
+}
+
+glm::vec3 Mesh::getMaxPoint() const
+{
+	return maxPoint;
+}
+
+void Mesh::setUVDensity(float _uvDensity)
+{
+	uvDensity = _uvDensity;
+}
+
+float Mesh::getUVDensity() const
+{
+	return uvDensity;
+}
+
+const glm::mat4& Mesh::getDequantization() const
+{
+	return dequantization;
+}
\ No newline at end of file
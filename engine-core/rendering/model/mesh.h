@@ -4,22 +4,36 @@
 #include <vector>
 #include <glm.hpp>
 
+#include "../src/core/rendering/geometry/geometry_arena.h"
+
 class Mesh
 {
 public:
 	Mesh();
 
-	// Sets the meshes existing backend buffers and metrics
-	void setData(uint32_t vao, uint32_t vbo, uint32_t ebo, uint32_t nVertices, uint32_t nIndices, uint32_t materialIndex);
-	
-	// Returns the meshes vertex array object
+	// Sets the meshes geometry arena allocations and material index, assigning the mesh a new id
+	void setData(GeometryArena::Allocation vertices, GeometryArena::Allocation indices, GeometryArena::IndexType indexType, uint32_t materialIndex);
+
+	// Returns the meshes unique id
+	uint32_t getId() const;
+
+	// Returns the vertex array object referencing the meshes geometry
 	uint32_t getVAO() const;
 
-	// Returns the meshes vertex buffer object
-	uint32_t getVBO() const;
+	// Returns the meshes vertex allocation within the geometry arena
+	GeometryArena::Allocation getVertices() const;
+
+	// Returns the meshes index allocation within the geometry arena
+	GeometryArena::Allocation getIndices() const;
 
-	// Return the meshes element buffer object
-	uint32_t getEBO() const;
+	// Returns the type of the meshes indices
+	GeometryArena::IndexType getIndexType() const;
+
+	// Returns the offset of the meshes first vertex within the geometry arena
+	uint32_t getBaseVertex() const;
+
+	// Returns the offset of the meshes first index within the geometry arena
+	uint32_t getFirstIndex() const;
 
 	// Returns the meshes amount of vertices
 	uint32_t getVerticeCount() const;
@@ -30,12 +44,37 @@ public:
 	// Returns the meshes material index related to the parent model
 	uint32_t getMaterialIndex() const;
 
+	// Sets the meshes object space bounding box
+	void setBounds(glm::vec3 minPoint, glm::vec3 maxPoint);
+
+	// Returns the minimum point of the meshes object space bounding box
+	glm::vec3 getMinPoint() const;
+
+	// Returns the maximum point of the meshes object space bounding box
+	glm::vec3 getMaxPoint() const;
+
+	// Sets the meshes average amount of uv units per object space unit
+	void setUVDensity(float uvDensity);
+
+	// Returns the meshes average amount of uv units per object space unit (0 if the mesh has no uvs)
+	float getUVDensity() const;
+
+	// Returns the matrix mapping the meshes quantized vertex positions to object space
+	const glm::mat4& getDequantization() const;
+
 private:
-	uint32_t vao;
-	uint32_t vbo;
-	uint32_t ebo;
+	// Amount of mesh ids assigned
+	static uint32_t idCounter;
+
+	uint32_t id;
 
-	uint32_t nVertices;
-	uint32_t nIndices;
+	GeometryArena::Allocation vertices;
+	GeometryArena::Allocation indices;
+	GeometryArena::IndexType indexType;
 	uint32_t materialIndex;
+
+	glm::vec3 minPoint;
+	glm::vec3 maxPoint;
+	glm::mat4 dequantization;
+	float uvDensity;
 };
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include "mesh_cache.h"
+
+#include <thread>
+#include <fstream>
+#include <cstring>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace MeshCache {
+
+	// Identifier at the start of every cache
+	constexpr char MAGIC[4] = { 'N', 'M', 'S', 'H' };
+
+	// Version of the cache layout itself
+	constexpr uint32_t FORMAT_VERSION = 2;
+
+	// Alignment of every section within the cache
+	constexpr uint64_t SECTION_ALIGNMENT = 8;
+
+	struct Header
+	{
+		char magic[4];
+		uint32_t formatVersion;
+		uint32_t importerVersion;
+		uint32_t vertexSize;
+		uint64_t sourceHash;
+		uint32_t meshCount;
+		uint32_t metricsSize;
+	};
+
+	// Entry of the sub mesh table, stream offsets are relative to the start of the cache
+	struct SubMesh
+	{
+		uint32_t materialIndex;
+		uint32_t indexType;
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		uint64_t vertexOffset;
+		uint64_t indexOffset;
+		float minPoint[3];
+		float maxPoint[3];
+		float uvDensity;
+		uint32_t padding;
+	};
+
+	// Returns the given offset rounded up to the section alignment
+	uint64_t _align(uint64_t offset)
+	{
+		return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+	}
+
+	// Returns if the given range lies within the cache
+	bool _inBounds(const MappedFile& file, uint64_t offset, uint64_t size)
+	{
+		return offset <= file.getSize() && size <= file.getSize() - offset;
+	}
+
+	std::string getCachePath(const std::string& sourcePath)
+	{
+		return sourcePath + ".nmesh";
+	}
+
+	bool read(const MappedFile& file, uint64_t sourceHash, std::vector<MeshStreams>& meshes, void* metrics, uint32_t metricsSize)
+	{
+		meshes.clear();
+		if (!file.isOpen() || !_inBounds(file, 0, sizeof(Header))) return false;
+
+		// Validate header
+		const uint8_t* data = file.getData();
+		Header header;
+		std::memcpy(&header, data, sizeof(Header));
+		if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+		if (header.formatVersion != FORMAT_VERSION || header.importerVersion != IMPORTER_VERSION) return false;
+		if (header.vertexSize != sizeof(GeometryArena::Vertex) || header.metricsSize != metricsSize) return false;
+		if (header.sourceHash != sourceHash) return false;
+
+		// Read metrics
+		uint64_t metricsOffset = _align(sizeof(Header));
+		if (!_inBounds(file, metricsOffset, metricsSize)) return false;
+		std::memcpy(metrics, data + metricsOffset, metricsSize);
+
+		// Read sub mesh table
+		uint64_t tableOffset = _align(metricsOffset + metricsSize);
+		if (!_inBounds(file, tableOffset, static_cast<uint64_t>(header.meshCount) * sizeof(SubMesh))) return false;
+
+		meshes.reserve(header.meshCount);
+		for (uint32_t i = 0; i < header.meshCount; i++) {
+			SubMesh subMesh;
+			std::memcpy(&subMesh, data + tableOffset + i * sizeof(SubMesh), sizeof(SubMesh));
+
+			// Validate streams
+			GeometryArena::IndexType indexType = static_cast<GeometryArena::IndexType>(subMesh.indexType);
+			if (indexType != GeometryArena::IndexType::UINT16 && indexType != GeometryArena::IndexType::UINT32) return false;
+			uint64_t vertexSize = static_cast<uint64_t>(subMesh.vertexCount) * sizeof(GeometryArena::Vertex);
+			uint64_t indexSize = static_cast<uint64_t>(subMesh.indexCount) * GeometryArena::getIndexSize(indexType);
+			if (!_inBounds(file, subMesh.vertexOffset, vertexSize) || !_inBounds(file, subMesh.indexOffset, indexSize)) return false;
+
+			// Point streams into mapping
+			MeshStreams streams;
+			streams.materialIndex = subMesh.materialIndex;
+			streams.indexType = indexType;
+			streams.vertices = reinterpret_cast<const GeometryArena::Vertex*>(data + subMesh.vertexOffset);
+			streams.vertexCount = subMesh.vertexCount;
+			streams.indices = data + subMesh.indexOffset;
+			streams.indexCount = subMesh.indexCount;
+			streams.minPoint = glm::vec3(subMesh.minPoint[0], subMesh.minPoint[1], subMesh.minPoint[2]);
+			streams.maxPoint = glm::vec3(subMesh.maxPoint[0], subMesh.maxPoint[1], subMesh.maxPoint[2]);
+			streams.uvDensity = subMesh.uvDensity;
+			meshes.push_back(streams);
+		}
+
+		return true;
+	}
+
+	bool write(const std::string& path, uint64_t sourceHash, const std::vector<MeshStreams>& meshes, const void* metrics, uint32_t metricsSize)
+	{
+		//
+		// LAYOUT
+		//
+
+		Header header = {};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.formatVersion = FORMAT_VERSION;
+		header.importerVersion = IMPORTER_VERSION;
+		header.vertexSize = sizeof(GeometryArena::Vertex);
+		header.sourceHash = sourceHash;
+		header.meshCount = static_cast<uint32_t>(meshes.size());
+		header.metricsSize = metricsSize;
+
+		uint64_t metricsOffset = _align(sizeof(Header));
+		uint64_t tableOffset = _align(metricsOffset + metricsSize);
+		uint64_t offset = _align(tableOffset + meshes.size() * sizeof(SubMesh));
+
+		std::vector<SubMesh> table;
+		table.reserve(meshes.size());
+		for (size_t i = 0; i < meshes.size(); i++) {
+			const MeshStreams& streams = meshes[i];
+
+			// Zero initialize entries so padding is written deterministically
+			SubMesh subMesh = {};
+			subMesh.materialIndex = streams.materialIndex;
+			subMesh.indexType = static_cast<uint32_t>(streams.indexType);
+			subMesh.vertexCount = streams.vertexCount;
+			subMesh.indexCount = streams.indexCount;
+			for (uint32_t j = 0; j < 3; j++) {
+				subMesh.minPoint[j] = streams.minPoint[j];
+				subMesh.maxPoint[j] = streams.maxPoint[j];
+			}
+			subMesh.uvDensity = streams.uvDensity;
+
+			subMesh.vertexOffset = offset;
+			offset = _align(offset + static_cast<uint64_t>(streams.vertexCount) * sizeof(GeometryArena::Vertex));
+			subMesh.indexOffset = offset;
+			offset = _align(offset + static_cast<uint64_t>(streams.indexCount) * GeometryArena::getIndexSize(streams.indexType));
+
+			table.push_back(subMesh);
+		}
+
+		//
+		// WRITE
+		//
+
+		// Write to temporary file first so readers never map a partially written cache (unique per thread as loaders may cook the same source concurrently)
+		std::string temporaryPath = path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+		{
+			std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+			if (!stream.is_open()) return false;
+
+			// Writes the given bytes at the given offset, padding up to it
+			auto writeAt = [&stream](uint64_t at, const void* bytes, uint64_t size) {
+				static const char padding[SECTION_ALIGNMENT] = {};
+				uint64_t position = static_cast<uint64_t>(stream.tellp());
+				if (at > position) stream.write(padding, at - position);
+				if (size > 0) stream.write(static_cast<const char*>(bytes), size);
+			};
+
+			writeAt(0, &header, sizeof(Header));
+			writeAt(metricsOffset, metrics, metricsSize);
+			writeAt(tableOffset, table.data(), table.size() * sizeof(SubMesh));
+			for (size_t i = 0; i < meshes.size(); i++) {
+				writeAt(table[i].vertexOffset, meshes[i].vertices, static_cast<uint64_t>(meshes[i].vertexCount) * sizeof(GeometryArena::Vertex));
+				writeAt(table[i].indexOffset, meshes[i].indices, static_cast<uint64_t>(meshes[i].indexCount) * GeometryArena::getIndexSize(meshes[i].indexType));
+			}
+
+			if (!stream.good()) {
+				stream.close();
+				std::error_code error;
+				fs::remove(temporaryPath, error);
+				return false;
+			}
+		}
+
+		// Replace previous cache
+		std::error_code error;
+		fs::rename(temporaryPath, path, error);
+		if (error) {
+			fs::remove(temporaryPath, error);
+			return false;
+		}
+
+		return true;
+	}
+
+}
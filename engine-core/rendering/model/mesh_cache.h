@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <glm.hpp>
+
+#include "../src/core/utils/mapped_file.h"
+#include "../src/core/rendering/geometry/geometry_arena.h"
+
+// Cooked binary mesh files (.nmesh) next to model sources, holding the final streams of all meshes of a model
+namespace MeshCache
+{
+
+	// Version of the model import pipeline, caches cooked by another version are stale
+	constexpr uint32_t IMPORTER_VERSION = 1;
+
+	// Final vertex and index streams of a single mesh
+	struct MeshStreams
+	{
+		uint32_t materialIndex = 0;
+		GeometryArena::IndexType indexType = GeometryArena::IndexType::UINT32;
+
+		const GeometryArena::Vertex* vertices = nullptr;
+		uint32_t vertexCount = 0;
+
+		const void* indices = nullptr;
+		uint32_t indexCount = 0;
+
+		// Object space bounding box
+		glm::vec3 minPoint = glm::vec3(0.0f);
+		glm::vec3 maxPoint = glm::vec3(0.0f);
+
+		// Average amount of uv units per object space unit (0 if the mesh has no uvs)
+		float uvDensity = 0.0f;
+	};
+
+	// Returns the path of the cache belonging to the given model source
+	std::string getCachePath(const std::string& sourcePath);
+
+	// Reads the mesh streams and metrics of the given mapped cache, the streams point into the mapping
+	// Returns false if the cache is malformed, stale or doesn't match the source hash
+	bool read(const MappedFile& file, uint64_t sourceHash, std::vector<MeshStreams>& meshes, void* metrics, uint32_t metricsSize);
+
+	// Writes the given mesh streams and metrics to a cache at the given path, returns if the cache could be written
+	bool write(const std::string& path, uint64_t sourceHash, const std::vector<MeshStreams>& meshes, const void* metrics, uint32_t metricsSize);
+
+};
@@ -1,7 +1,10 @@
 #include "model.h"
 
+#include <cmath>
 #include <vector>
 #include <sstream>
+#include <filesystem>
+#include <type_traits>
 #include <glad/glad.h>
 
 #include <assimp/scene.h>
@@ -12,11 +15,14 @@
 #include "../src/core/utils/console.h"
 #include "../src/core/utils/iohandler.h"
 #include "../src/core/utils/string_helper.h"
+#include "../src/core/rendering/geometry/geometry_arena.h"
+#include "../src/core/rendering/geometry/mesh_optimizer.h"
 
-#include <iostream>
+namespace fs = std::filesystem;
 
 Model::Model() : path(),
 meshData(),
+cache(),
 meshes(),
 metrics()
 {
@@ -50,6 +56,11 @@ std::string Model::sourcePath()
 
 void Model::loadData()
 {
+	// Load cooked mesh data if the mesh cache is up to date
+	std::string cachePath = MeshCache::getCachePath(path);
+	uint64_t sourceHash = IOHandler::hashFile(path);
+	if (sourceHash && loadCache(cachePath, sourceHash)) return;
+
 	// Read file
 	Assimp::Importer import;
 	const uint32_t importSettings = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace;
@@ -74,11 +85,15 @@ void Model::loadData()
 
 	// Finalize the metrics
 	finalizeMetrics();
+
+	// Cook mesh cache for the next load
+	if (sourceHash) writeCache(cachePath, sourceHash);
 }
 
 void Model::releaseData()
 {
 	meshData.clear();
+	cache.close();
 }
 
 void Model::dispatchGPU()
@@ -88,59 +103,76 @@ void Model::dispatchGPU()
 
 	// Dispatch each mesh
 	for (uint32_t i = 0; i < meshData.size(); i++) {
-		// Get mesh data metrics
-		uint32_t nVertices = meshData[i].vertices.size();
-		uint32_t nIndices = meshData[i].indices.size();
-		uint32_t materialIndex = meshData[i].materialIndex;
-
-		// VAO, VBO and EBO backend ids
-		uint32_t vao, vbo, ebo;
-
-		// Generate VAO, VBO and EBO
-		glGenVertexArrays(1, &vao);
-		glGenBuffers(1, &vbo);
-		glGenBuffers(1, &ebo);
-
-		// Bind VAO
-		glBindVertexArray(vao);
-
-		// Bind VBO, allocate its memory send vertex data
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-		glBufferData(GL_ARRAY_BUFFER, nVertices * sizeof(VertexData), meshData[i].vertices.data(), GL_STATIC_DRAW);
-
-		// Bind EBO, allocate its memory and send indice data
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, nIndices * sizeof(uint32_t), meshData[i].indices.data(), GL_STATIC_DRAW);
-
-		// Set attributes for VAO
-		// Vertex position attribute (location = 0)
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, position));
-		// Normal attribute (location = 1)
-		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, normal));
-		// Texture coordinates attribute (location = 2)
-		glEnableVertexAttribArray(2);
-		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, uv));
-		// Tangent attribute (location = 3)
-		glEnableVertexAttribArray(3);
-		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, tangent));
-		// Bitangent attribute (location = 3)
-		glEnableVertexAttribArray(4);
-		glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(VertexData), (void*)offsetof(VertexData, bitangent));
-
-		// Unbind VAO, ABO and EBO
-		glBindVertexArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
 		// Mesh is not existing yet, create empty mesh
 		if (meshes.find(i) == meshes.end()) {
 			meshes[i] = Mesh();
 		}
+		Mesh& mesh = meshes[i];
+
+		// Release geometry of previous dispatch
+		GeometryArena::removeVertices(mesh.getVertices());
+		GeometryArena::removeIndices(mesh.getIndices(), mesh.getIndexType());
+
+		// Allocate and upload geometry within the geometry arena (straight from the mesh cache mapping if loaded from it)
+		const MeshCache::MeshStreams& streams = meshData[i].streams;
+		GeometryArena::Allocation vertices = GeometryArena::addVertices(streams.vertices, streams.vertexCount);
+		GeometryArena::Allocation indices = GeometryArena::addIndices(streams.indices, streams.indexCount, streams.indexType);
 
 		// Update mesh
-		meshes[i].setData(vao, vbo, ebo, nVertices, nIndices, materialIndex);
+		mesh.setData(vertices, indices, streams.indexType, streams.materialIndex);
+		mesh.setBounds(streams.minPoint, streams.maxPoint);
+		mesh.setUVDensity(streams.uvDensity);
+	}
+}
+
+size_t Model::getChunkSize()
+{
+	// Models are dispatched at once, sized by all their streams
+	size_t size = 0;
+	for (const MeshData& data : meshData) {
+		size += static_cast<size_t>(data.streams.vertexCount) * sizeof(VertexData);
+		size += static_cast<size_t>(data.streams.indexCount) * GeometryArena::getIndexSize(data.streams.indexType);
+	}
+	return size;
+}
+
+bool Model::loadCache(const std::string& cachePath, uint64_t sourceHash)
+{
+	// No cache cooked yet
+	if (!fs::exists(cachePath)) return false;
+
+	// Map cache and read its streams
+	std::vector<MeshCache::MeshStreams> streams;
+	Metrics cachedMetrics;
+	if (!cache.open(cachePath) || !MeshCache::read(cache, sourceHash, streams, &cachedMetrics, sizeof(Metrics))) {
+		cache.close();
+		return false;
+	}
+
+	// Reference mapped streams
+	meshData.clear();
+	meshData.reserve(streams.size());
+	for (const MeshCache::MeshStreams& meshStreams : streams) {
+		meshData.emplace_back(meshStreams);
+	}
+	metrics = cachedMetrics;
+
+	return true;
+}
+
+void Model::writeCache(const std::string& cachePath, uint64_t sourceHash)
+{
+	static_assert(std::is_trivially_copyable<Metrics>::value, "Model metrics are cached as raw bytes");
+
+	// Collect streams of imported meshes
+	std::vector<MeshCache::MeshStreams> streams;
+	streams.reserve(meshData.size());
+	for (const MeshData& data : meshData) {
+		streams.push_back(data.streams);
+	}
+
+	if (!MeshCache::write(cachePath, sourceHash, streams, &metrics, sizeof(Metrics))) {
+		Console::out::warning("Model", "Couldn't write mesh cache for model '" + IOHandler::getFilename(path) + "'");
 	}
 }
 
@@ -172,15 +204,32 @@ Model::MeshData Model::processMesh(aiMesh* mesh, const aiScene* scene)
 
 	vertices.reserve(mesh->mNumVertices);
 
+	// Object space bounding box of mesh, needed upfront for quantizing positions
+	glm::vec3 minPoint = glm::vec3(FLT_MAX);
+	glm::vec3 maxPoint = glm::vec3(-FLT_MAX);
+
+	std::vector<glm::vec3> positions;
+	positions.reserve(mesh->mNumVertices);
+
 	for (uint32_t i = 0; i < mesh->mNumVertices; i++)
 	{
-		vertices.emplace_back(
-			glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z), // POSITION
+		positions.emplace_back(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+
+		// Extend bounding box
+		minPoint = glm::min(minPoint, positions.back());
+		maxPoint = glm::max(maxPoint, positions.back());
+	}
+
+	for (uint32_t i = 0; i < mesh->mNumVertices; i++)
+	{
+		vertices.push_back(GeometryArena::pack(
+			positions[i], // POSITION
 			glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z), // NORMAL
 			mesh->mTextureCoords[0] ? glm::vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y) : glm::vec2(0.0f, 0.0f), // UV
 			glm::vec3(mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z), // TANGENT
-			glm::vec3(mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z) // BITANGENT
-		);
+			glm::vec3(mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z), // BITANGENT
+			minPoint, maxPoint
+		));
 	}
 
 	//
@@ -208,8 +257,44 @@ Model::MeshData Model::processMesh(aiMesh* mesh, const aiScene* scene)
 	// Get meshes material index
 	materialIndex = mesh->mMaterialIndex;
 
+	//
+	// MEASURE UV DENSITY
+	//
+
+	// Sum up object space and uv space areas of all triangles
+	float area = 0.0f;
+	float uvArea = 0.0f;
+	if (mesh->mTextureCoords[0]) {
+		for (uint32_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			const aiVector3D& uv0 = mesh->mTextureCoords[0][indices[i]];
+			const aiVector3D& uv1 = mesh->mTextureCoords[0][indices[i + 1]];
+			const aiVector3D& uv2 = mesh->mTextureCoords[0][indices[i + 2]];
+			area += glm::length(glm::cross(positions[indices[i + 1]] - positions[indices[i]], positions[indices[i + 2]] - positions[indices[i]])) * 0.5f;
+			uvArea += std::abs((uv1.x - uv0.x) * (uv2.y - uv0.y) - (uv2.x - uv0.x) * (uv1.y - uv0.y)) * 0.5f;
+		}
+	}
+
+	// Average amount of uv units per object space unit, used for picking the texture levels needed on screen
+	float uvDensity = area > 0.0f && uvArea > 0.0f ? std::sqrt(uvArea / area) : 0.0f;
+
 	// Implement texture name linking here
 
+	//
+	// OPTIMIZE MESH
+	//
+
+	optimizeMesh(vertices, positions, indices);
+
+	// Narrow indices to 16-bit if possible
+	std::vector<uint16_t> shortIndices;
+	if (MeshOptimizer::fitsShortIndices(static_cast<uint32_t>(vertices.size()))) {
+		shortIndices = MeshOptimizer::toShortIndices(indices);
+		indices.clear();
+		indices.shrink_to_fit();
+		metrics.nShortIndexMeshes++;
+	}
+
 	//
 	// HANDLE MESH METRICS
 	//
@@ -218,30 +303,57 @@ Model::MeshData Model::processMesh(aiMesh* mesh, const aiScene* scene)
 	metrics.nMaterials = std::max(metrics.nMaterials, materialIndex + 1);
 
 	// Add mesh to metrics
-	addMeshToMetrics(vertices, mesh->mNumFaces);
+	addMeshToMetrics(positions, mesh->mNumFaces);
 
 	// Construct and return mesh data
-	return MeshData(std::move(vertices), std::move(indices), materialIndex);
+	return MeshData(std::move(vertices), std::move(indices), std::move(shortIndices), materialIndex, minPoint, maxPoint, uvDensity);
 }
 
-void Model::addMeshToMetrics(const std::vector<VertexData>& vertices, uint32_t nFaces)
+void Model::optimizeMesh(std::vector<VertexData>& vertices, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices)
+{
+	uint32_t nSourceVertices = static_cast<uint32_t>(vertices.size());
+	metrics.nCacheMissesBefore += MeshOptimizer::countCacheMisses(indices, nSourceVertices);
+
+	// Weld duplicate vertices
+	std::vector<uint32_t> remap;
+	uint32_t nVertices = MeshOptimizer::generateWeldRemap(vertices, remap);
+	MeshOptimizer::remapIndices(indices, remap);
+	MeshOptimizer::remapVertices(vertices, remap, nVertices);
+	MeshOptimizer::remapVertices(positions, remap, nVertices);
+	metrics.nWeldedVertices += nSourceVertices - nVertices;
+
+	// Reorder triangles for vertex cache efficiency, then reorder clusters of them for less overdraw (triangle lists only)
+	if (indices.size() % 3 == 0) {
+		MeshOptimizer::optimizeVertexCache(indices, nVertices);
+		MeshOptimizer::optimizeOverdraw(indices, positions);
+	}
+	metrics.nCacheMissesAfter += MeshOptimizer::countCacheMisses(indices, nVertices);
+
+	// Reorder vertices by first use for vertex fetch efficiency, dropping unreferenced vertices
+	nVertices = MeshOptimizer::generateFetchRemap(indices, nVertices, remap);
+	MeshOptimizer::remapIndices(indices, remap);
+	MeshOptimizer::remapVertices(vertices, remap, nVertices);
+	MeshOptimizer::remapVertices(positions, remap, nVertices);
+}
+
+void Model::addMeshToMetrics(const std::vector<glm::vec3>& positions, uint32_t nFaces)
 {
 	// Add number of vertices and faces to metrics
-	metrics.nVertices += vertices.size();
+	metrics.nVertices += positions.size();
 	metrics.nFaces += nFaces;
 
 	// Loop through all mesh vertices
-	for (const VertexData& vertex : vertices)
+	for (const glm::vec3& position : positions)
 	{
 		// Update min and max point
-		metrics.minPoint = glm::min(metrics.minPoint, vertex.position);
-		metrics.maxPoint = glm::max(metrics.maxPoint, vertex.position);
+		metrics.minPoint = glm::min(metrics.minPoint, position);
+		metrics.maxPoint = glm::max(metrics.maxPoint, position);
 
 		// Add vertex position to centroid
-		metrics.centroid += vertex.position;
+		metrics.centroid += position;
 
 		// Calculate furthest distance
-		metrics.furthest = glm::max(metrics.furthest, glm::distance(glm::vec3(0.0f), vertex.position));
+		metrics.furthest = glm::max(metrics.furthest, glm::distance(glm::vec3(0.0f), position));
 	}
 }
 
@@ -254,4 +366,10 @@ void Model::finalizeMetrics()
 	// Average centroid and transform to world space
 	metrics.centroid /= metrics.nVertices;
 	metrics.centroid = Transformation::toBackendPosition(metrics.centroid);
+
+	// Average vertex cache miss ratios
+	if (metrics.nFaces > 0) {
+		metrics.acmrBefore = static_cast<float>(metrics.nCacheMissesBefore) / metrics.nFaces;
+		metrics.acmrAfter = static_cast<float>(metrics.nCacheMissesAfter) / metrics.nFaces;
+	}
 }
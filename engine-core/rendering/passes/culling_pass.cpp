@@ -0,0 +1,205 @@
+#include "culling_pass.h"
+
+#include <glad/glad.h>
+
+#include "../src/core/ecs/ecs_collection.h"
+#include "../src/core/rendering/model/mesh.h"
+#include "../src/core/rendering/shader/shader.h"
+#include "../src/core/rendering/shader/shader_pool.h"
+#include "../src/core/rendering/material/imaterial.h"
+
+CullingPass::CullingPass() : instanceBuffer(0),
+boundsBuffer(0),
+batchBuffer(0),
+commandBuffer(0),
+drawCountBuffer(0),
+instances(),
+bounds(),
+batches(),
+buckets(),
+cullingShader(ShaderPool::empty()),
+compactShader(ShaderPool::empty())
+{
+}
+
+void CullingPass::create()
+{
+	// Get culling shaders
+	cullingShader = ShaderPool::get("culling_pass");
+	cullingShader->bind();
+	cullingShader->setInt("depthPyramid", DEPTH_PYRAMID_UNIT);
+	compactShader = ShaderPool::get("culling_compact_pass");
+
+	// Generate buffers
+	glGenBuffers(1, &instanceBuffer);
+	glGenBuffers(1, &boundsBuffer);
+	glGenBuffers(1, &batchBuffer);
+	glGenBuffers(1, &commandBuffer);
+	glGenBuffers(1, &drawCountBuffer);
+}
+
+void CullingPass::destroy()
+{
+	// Delete buffers
+	glDeleteBuffers(1, &instanceBuffer);
+	glDeleteBuffers(1, &boundsBuffer);
+	glDeleteBuffers(1, &batchBuffer);
+	glDeleteBuffers(1, &commandBuffer);
+	glDeleteBuffers(1, &drawCountBuffer);
+	instanceBuffer = 0;
+	boundsBuffer = 0;
+	batchBuffer = 0;
+	commandBuffer = 0;
+	drawCountBuffer = 0;
+
+	// Forget buckets of the latest culling
+	buckets.clear();
+
+	// Remove shaders
+	cullingShader = nullptr;
+	compactShader = nullptr;
+}
+
+bool CullingPass::supported()
+{
+	// Compute shaders, shader storage buffers and multi draw indirect are core since 4.3
+	return GLAD_GL_VERSION_4_3;
+}
+
+void CullingPass::perform(const RenderQueue& renderQueue, const glm::mat4& viewProjection, uint32_t depthPyramid)
+{
+	instances.clear();
+	bounds.clear();
+	batches.clear();
+	buckets.clear();
+
+	//
+	// GATHER INSTANCES
+	//
+
+	const Mesh* currentMesh = nullptr;
+	for (const RenderQueueItem& item : renderQueue) {
+		auto [transform, renderer, worldBounds] = ECS::gRegistry.get<TransformComponent, MeshRendererComponent, BoundsComponent>(item.entity);
+		if (!renderer.enabled || !renderer.mesh || !renderer.material) continue;
+		const Mesh* mesh = renderer.mesh;
+
+		// Start a new bucket if material or index type differ from the current bucket
+		bool sameMaterial = !buckets.empty() && buckets.back().material == renderer.material;
+		bool sameIndexType = !buckets.empty() && buckets.back().indexType == mesh->getIndexType();
+		bool newBucket = !sameMaterial || !sameIndexType;
+		if (newBucket) {
+			buckets.push_back({ renderer.material, mesh->getIndexType(), static_cast<uint32_t>(batches.size()), 0 });
+		}
+
+		// Start a new batch if mesh or bucket differ from the current batch
+		if (newBucket || mesh != currentMesh) {
+			uint32_t bucket = static_cast<uint32_t>(buckets.size() - 1);
+			Instancing::DrawCommand command = { mesh->getIndiceCount(), 0, mesh->getFirstIndex(), static_cast<int32_t>(mesh->getBaseVertex()), static_cast<uint32_t>(instances.size()) };
+			batches.push_back({ command, bucket, buckets.back().firstBatch, 0 });
+			buckets.back().count++;
+			currentMesh = mesh;
+		}
+
+		// Add instance and its bounds to current batch (model matrix also dequantizes the meshes packed positions)
+		instances.push_back({ transform.model * mesh->getDequantization(), transform.normal });
+		bounds.push_back({ (worldBounds.min + worldBounds.max) * 0.5f, static_cast<uint32_t>(batches.size() - 1), (worldBounds.max - worldBounds.min) * 0.5f, 0 });
+	}
+	if (instances.empty()) return;
+
+	//
+	// UPLOAD BUFFERS
+	//
+
+	uint32_t nInstances = static_cast<uint32_t>(instances.size());
+	uint32_t nBatches = static_cast<uint32_t>(batches.size());
+	write(instanceBuffer, instances.data(), instances.size() * sizeof(Instancing::Instance));
+	write(boundsBuffer, bounds.data(), bounds.size() * sizeof(Bounds));
+	write(batchBuffer, batches.data(), batches.size() * sizeof(BatchCommand));
+
+	// Clear compacted commands and draw counts (unused command slots draw nothing if draw counts aren't supported)
+	clear(commandBuffer, batches.size() * sizeof(Instancing::DrawCommand));
+	clear(drawCountBuffer, buckets.size() * sizeof(uint32_t));
+
+	// Surviving instances are written to the instance buffer read by the instance attributes
+	uint32_t visibleInstanceBuffer = Instancing::allocate(nInstances);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCE_BINDING, instanceBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BOUNDS_BINDING, boundsBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BATCH_BINDING, batchBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMAND_BINDING, commandBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_COUNT_BINDING, drawCountBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VISIBLE_INSTANCE_BINDING, visibleInstanceBuffer);
+
+	//
+	// CULL INSTANCES
+	//
+
+	cullingShader->bind();
+	cullingShader->setInt("instanceCount", static_cast<int32_t>(nInstances));
+	cullingShader->setMatrix4("viewProjection", viewProjection);
+	cullingShader->setBool("occlusion", depthPyramid != 0);
+	glActiveTexture(GL_TEXTURE0 + DEPTH_PYRAMID_UNIT);
+	glBindTexture(GL_TEXTURE_2D, depthPyramid);
+	glDispatchCompute((nInstances + GROUP_SIZE - 1) / GROUP_SIZE, 1, 1);
+
+	// Wait for instance counts of the batches
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	//
+	// COMPACT DRAW COMMANDS
+	//
+
+	compactShader->bind();
+	compactShader->setInt("batchCount", static_cast<int32_t>(nBatches));
+	glDispatchCompute((nBatches + GROUP_SIZE - 1) / GROUP_SIZE, 1, 1);
+
+	// Make commands, draw counts and surviving instances visible to upcoming draws
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+
+	// Unbind buffers
+	for (uint32_t binding = INSTANCE_BINDING; binding <= VISIBLE_INSTANCE_BINDING; binding++) {
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, 0);
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+const std::vector<CullingPass::Bucket>& CullingPass::getBuckets() const
+{
+	return buckets;
+}
+
+void CullingPass::drawBucket(uint32_t index) const
+{
+	const Bucket& bucket = buckets[index];
+	GeometryArena::bindIndexBuffer(bucket.indexType);
+	uint32_t elementType = GeometryArena::getElementType(bucket.indexType);
+	const void* commands = GeometryArena::bufferOffset(bucket.firstBatch * sizeof(Instancing::DrawCommand));
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+	if (GLAD_GL_VERSION_4_6) {
+		// Draw as many commands as survived culling
+		glBindBuffer(GL_PARAMETER_BUFFER, drawCountBuffer);
+		glMultiDrawElementsIndirectCount(GL_TRIANGLES, elementType, commands, index * sizeof(uint32_t), bucket.count, 0);
+		glBindBuffer(GL_PARAMETER_BUFFER, 0);
+	}
+	else {
+		// Draw all command slots of the bucket, unused slots hold no instances
+		glMultiDrawElementsIndirect(GL_TRIANGLES, elementType, commands, bucket.count, 0);
+	}
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void CullingPass::write(uint32_t buffer, const void* data, size_t size)
+{
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, size, data, GL_STREAM_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void CullingPass::clear(uint32_t buffer, size_t size)
+{
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+	glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
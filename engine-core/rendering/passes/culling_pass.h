@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm.hpp>
+
+#include "../src/core/ecs/ecs.h"
+#include "../src/core/rendering/instancing/instancing.h"
+#include "../src/core/rendering/geometry/geometry_arena.h"
+
+class Shader;
+class IMaterial;
+
+class CullingPass
+{
+public:
+	// Run of batches sharing material and index type, drawn with a single indirect draw call
+	struct Bucket
+	{
+		const IMaterial* material;
+		GeometryArena::IndexType indexType;
+
+		// Index of the buckets first batch and amount of batches in bucket
+		uint32_t firstBatch;
+		uint32_t count;
+	};
+
+	CullingPass();
+
+	void create();
+	void destroy();
+
+	// Returns if the gpu supports culling with compute shaders
+	static bool supported();
+
+	// Uploads the instances of the given render queue and culls them against the view frustum and the given depth pyramid (0 if none, rendered with the same view projection) on the gpu
+	// Indirect draw commands of the surviving instances are compacted per bucket
+	void perform(const RenderQueue& renderQueue, const glm::mat4& viewProjection, uint32_t depthPyramid);
+
+	// Returns the buckets of the latest culling
+	const std::vector<Bucket>& getBuckets() const;
+
+	// Draws the surviving instances of the bucket at the given index, the geometry arena vao must be bound
+	void drawBucket(uint32_t bucket) const;
+
+private:
+	// World space bounds of an instance and the batch it belongs to, laid out as read by the culling shader
+	struct Bounds
+	{
+		glm::vec3 center;
+		uint32_t batch;
+		glm::vec3 extent;
+		uint32_t padding;
+	};
+
+	// Draw command of a batch and the commands of its bucket, laid out as read by the culling shaders
+	struct BatchCommand
+	{
+		Instancing::DrawCommand command;
+		uint32_t bucket;
+		uint32_t bucketFirst;
+		uint32_t padding;
+	};
+
+	// Amount of invocations per work group of the culling shaders
+	static constexpr uint32_t GROUP_SIZE = 64;
+
+	// Shader storage buffer binding points used by the culling shaders
+	enum Bindings
+	{
+		INSTANCE_BINDING,
+		BOUNDS_BINDING,
+		BATCH_BINDING,
+		COMMAND_BINDING,
+		DRAW_COUNT_BINDING,
+		VISIBLE_INSTANCE_BINDING
+	};
+
+	enum TextureUnits
+	{
+		DEPTH_PYRAMID_UNIT
+	};
+
+	uint32_t instanceBuffer; // Instances of the render queue before culling
+	uint32_t boundsBuffer; // World bounds of the instances
+	uint32_t batchBuffer; // Draw commands of the batches, counting surviving instances
+	uint32_t commandBuffer; // Compacted draw commands of the batches with surviving instances
+	uint32_t drawCountBuffer; // Amount of compacted draw commands of each bucket
+
+	std::vector<Instancing::Instance> instances; // Instances of the render queue, reused across frames
+	std::vector<Bounds> bounds; // World bounds of the instances, reused across frames
+	std::vector<BatchCommand> batches; // Draw commands of the batches, reused across frames
+	std::vector<Bucket> buckets; // Buckets of the latest culling
+
+	Shader* cullingShader;
+	Shader* compactShader;
+
+	// Replaces the contents of the given buffer, orphaning its previous storage
+	void write(uint32_t buffer, const void* data, size_t size);
+
+	// Replaces the contents of the given buffer with the given amount of zeroed bytes
+	void clear(uint32_t buffer, size_t size);
+};
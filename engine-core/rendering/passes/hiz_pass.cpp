@@ -0,0 +1,221 @@
+#include "hiz_pass.h"
+
+#include <glad/glad.h>
+#include <algorithm>
+
+#include "../src/core/utils/console.h"
+#include "../src/core/rendering/shader/shader.h"
+#include "../src/core/rendering/shader/shader_pool.h"
+#include "../src/core/rendering/primitives/global_quad.h"
+
+HiZPass::HiZPass(const Viewport& viewport) : viewport(viewport),
+fbo(0),
+output(0),
+width(0),
+height(0),
+levelCount(0),
+readbackLevel(0),
+readbackWidth(0),
+readbackHeight(0),
+readbacks(),
+renders(0),
+occluders(),
+occludersRender(0),
+hizShader(ShaderPool::empty())
+{
+}
+
+void HiZPass::create()
+{
+	// Get hi-z pass shader
+	hizShader = ShaderPool::get("hiz_pass");
+	hizShader->bind();
+	hizShader->setInt("depthInput", DEPTH_UNIT);
+
+	// Get pyramid dimensions, the first level at half resolution
+	width = std::max(viewport.getWidth_i() / 2, 1u);
+	height = std::max(viewport.getHeight_i() / 2, 1u);
+	levelCount = 1;
+	while ((std::max(width, height) >> levelCount) > 0) levelCount++;
+
+	// Generate framebuffer
+	glGenFramebuffers(1, &fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+	// Generate depth pyramid output
+	glGenTextures(1, &output);
+	glBindTexture(GL_TEXTURE_2D, output);
+	glTexStorage2D(GL_TEXTURE_2D, static_cast<GLsizei>(levelCount), GL_R32F, width, height);
+
+	// Set depth pyramid output parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	// Set first level as rendering target
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, output, 0);
+
+	// Check for framebuffer errors
+	GLenum fboStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if (fboStatus != GL_FRAMEBUFFER_COMPLETE)
+	{
+		Console::out::warning("Hi-Z Pass", "Issue while generating framebuffer: " + std::to_string(fboStatus));
+	}
+
+	// Unbind fbo
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	// Pick the level read back for occlusion culling
+	readbackLevel = 0;
+	while (readbackLevel + 1 < levelCount && (std::max(width, height) >> readbackLevel) > READBACK_DIMENSION) readbackLevel++;
+	readbackWidth = std::max(width >> readbackLevel, 1u);
+	readbackHeight = std::max(height >> readbackLevel, 1u);
+
+	// Generate readback buffers
+	for (Readback& readback : readbacks) {
+		glGenBuffers(1, &readback.buffer);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+		glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(readbackWidth) * readbackHeight * sizeof(float), nullptr, GL_STREAM_READ);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void HiZPass::destroy()
+{
+	// Delete readbacks
+	for (Readback& readback : readbacks) {
+		if (readback.fence) glDeleteSync(readback.fence);
+		glDeleteBuffers(1, &readback.buffer);
+		readback = Readback();
+	}
+
+	// Forget read back depth pyramid
+	occluders = OcclusionCulling::DepthPyramid();
+	occludersRender = 0;
+
+	// Delete depth pyramid output
+	glDeleteTextures(1, &output);
+	output = 0;
+
+	// Delete framebuffer
+	glDeleteFramebuffers(1, &fbo);
+	fbo = 0;
+
+	// Remove shaders
+	hizShader = nullptr;
+}
+
+void HiZPass::render(uint32_t depthInput, const glm::mat4& viewProjection)
+{
+	renders++;
+
+	// Disable depth testing and culling
+	glDisable(GL_DEPTH_TEST);
+	glDisable(GL_CULL_FACE);
+
+	// Bind framebuffer and hi-z pass shader
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	hizShader->bind();
+	glActiveTexture(GL_TEXTURE0 + DEPTH_UNIT);
+	GlobalQuad::bind();
+
+	//
+	// REDUCE LEVELS
+	//
+
+	for (uint32_t level = 0; level < levelCount; level++) {
+		// Reduce depth input into the first level and each further level from the previous level
+		if (level == 0) {
+			glBindTexture(GL_TEXTURE_2D, depthInput);
+		}
+		else {
+			// Clamp the pyramid to the previous level while rendering the next one, so the level read isn't the level written
+			glBindTexture(GL_TEXTURE_2D, output);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level - 1);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level - 1);
+		}
+
+		// Render level
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, output, level);
+		glViewport(0, 0, std::max(width >> level, 1u), std::max(height >> level, 1u));
+		GlobalQuad::render();
+	}
+
+	// Restore access to all levels
+	glBindTexture(GL_TEXTURE_2D, output);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+	// Unbind framebuffer and restore viewport for upcoming passes
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(0, 0, viewport.getWidth_gl(), viewport.getHeight_gl());
+
+	// Re-Enable depth testing and culling
+	glEnable(GL_DEPTH_TEST);
+	glEnable(GL_CULL_FACE);
+
+	//
+	// QUEUE READBACK
+	//
+
+	// Reuse slot of the oldest readback, dropping it if it's still pending
+	Readback& readback = readbacks[renders % READBACK_SLOTS];
+	if (readback.fence) glDeleteSync(readback.fence);
+
+	// Copy coarse level into the readback buffer without stalling
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+	glGetTexImage(GL_TEXTURE_2D, readbackLevel, GL_RED, GL_FLOAT, nullptr);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	readback.render = renders;
+	readback.viewProjection = viewProjection;
+}
+
+const OcclusionCulling::DepthPyramid* HiZPass::readOccluders()
+{
+	// Take the latest readback the gpu finished
+	Readback* latest = nullptr;
+	for (Readback& readback : readbacks) {
+		if (!readback.fence || (latest && readback.render < latest->render)) continue;
+		GLenum status = glClientWaitSync(readback.fence, 0, 0);
+		if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) latest = &readback;
+	}
+
+	// Build depth pyramid from the read back level
+	if (latest && latest->render > occludersRender) {
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, latest->buffer);
+		const float* depths = static_cast<const float*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(readbackWidth) * readbackHeight * sizeof(float), GL_MAP_READ_BIT));
+		if (depths) {
+			occluders.build(depths, readbackWidth, readbackHeight, latest->viewProjection);
+			occludersRender = latest->render;
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+
+	// Release finished readbacks up to the latest one
+	if (latest) {
+		for (Readback& readback : readbacks) {
+			if (!readback.fence || readback.render > latest->render) continue;
+			glDeleteSync(readback.fence);
+			readback.fence = nullptr;
+		}
+	}
+
+	// Skip occlusion culling if the latest depth pyramid is outdated
+	if (occluders.empty() || renders - occludersRender > MAX_LATENCY) return nullptr;
+	return &occluders;
+}
+
+uint32_t HiZPass::getOutput() const
+{
+	return output;
+}
+
+uint32_t HiZPass::getLevelCount() const
+{
+	return levelCount;
+}
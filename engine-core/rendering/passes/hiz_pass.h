@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <glm.hpp>
+
+#include "../src/core/viewport/viewport.h"
+#include "../src/core/rendering/culling/occlusion_culling.h"
+
+class Shader;
+
+class HiZPass
+{
+public:
+	explicit HiZPass(const Viewport& viewport);
+
+	void create();
+	void destroy();
+
+	// Builds the maximum depth pyramid of the given depth input rendered with the given view projection and queues reading back a coarse level of it
+	void render(uint32_t depthInput, const glm::mat4& viewProjection);
+
+	// Returns the latest depth pyramid read back for occlusion culling (nullptr if there is no recent depth pyramid)
+	const OcclusionCulling::DepthPyramid* readOccluders();
+
+	// Returns the depth pyramid texture, its first level at half the viewport resolution
+	uint32_t getOutput() const;
+
+	// Returns the amount of levels of the depth pyramid texture
+	uint32_t getLevelCount() const;
+
+private:
+	// Pending readback of the coarse pyramid level
+	struct Readback
+	{
+		// Pixel pack buffer the level is read into
+		uint32_t buffer = 0;
+
+		// Fence signaled once the level was written to the buffer (nullptr if there is no pending readback)
+		GLsync fence = nullptr;
+
+		// Render the readback was queued in and its view projection
+		uint64_t render = 0;
+		glm::mat4 viewProjection = glm::mat4(1.0f);
+	};
+
+	// Amount of readbacks in flight
+	static constexpr uint32_t READBACK_SLOTS = 3;
+
+	// Maximum dimension of the level read back
+	static constexpr uint32_t READBACK_DIMENSION = 128;
+
+	// Maximum amount of renders a read back depth pyramid may lag behind to be used for occlusion culling
+	static constexpr uint64_t MAX_LATENCY = 3;
+
+	enum TextureUnits
+	{
+		DEPTH_UNIT
+	};
+
+	const Viewport& viewport;
+
+	uint32_t fbo;
+	uint32_t output;
+
+	// Dimensions of the first pyramid level and amount of pyramid levels
+	uint32_t width;
+	uint32_t height;
+	uint32_t levelCount;
+
+	// Pyramid level read back and its dimensions
+	uint32_t readbackLevel;
+	uint32_t readbackWidth;
+	uint32_t readbackHeight;
+
+	Readback readbacks[READBACK_SLOTS];
+
+	// Amount of renders so far
+	uint64_t renders;
+
+	// Latest depth pyramid read back and the render it was queued in
+	OcclusionCulling::DepthPyramid occluders;
+	uint64_t occludersRender;
+
+	Shader* hizShader;
+};
@@ -6,14 +6,17 @@
 #include "../src/core/utils/console.h"
 #include "../src/core/rendering/transformation/transformation.h"
 #include "../src/core/rendering/model/mesh.h"
-#include "../src/core/transform/transform.h"
+#include "../src/core/rendering/instancing/instancing.h"
+#include "../src/core/rendering/geometry/geometry_arena.h"
 #include "../src/core/ecs/ecs_collection.h"
 
 PrePass::PrePass(const Viewport& viewport) : viewport(viewport),
 fbo(0),
 depthOutput(0),
 normalOutput(0),
-prePassShader(ShaderPool::empty())
+prePassShader(ShaderPool::empty()),
+instances(),
+batches()
 {
 }
 
@@ -82,7 +85,7 @@ void PrePass::destroy() {
 	prePassShader = nullptr;
 }
 
-void PrePass::render(glm::mat4 viewProjection, glm::mat3 viewNormal)
+void PrePass::render(const RenderQueue& renderQueue)
 {
 	// Set viewport for upcoming pre pass
 	glViewport(0, 0, viewport.getWidth_gl(), viewport.getHeight_gl());
@@ -104,21 +107,13 @@ void PrePass::render(glm::mat4 viewProjection, glm::mat3 viewNormal)
 	// Bind pre pass shader
 	prePassShader->bind();
 
-	// Pre pass render each entity
-	auto targets = ECS::gRegistry.view<TransformComponent, MeshRendererComponent>();
-	for (auto [entity, transform, renderer] : targets.each()) {
-		if (!renderer.mesh) return;
+	// Collect instances of identical mesh runs
+	Instancing::gather(renderQueue, false, instances, batches);
+	Instancing::upload(instances, batches);
 
-		// Bind mesh
-		glBindVertexArray(renderer.mesh->getVAO());
-
-		// Set depth pre pass shader uniforms
-		prePassShader->setMatrix4("mvpMatrix", transform.mvp);
-		prePassShader->setMatrix3("viewNormalMatrix", viewNormal);
-
-		// Render mesh
-		glDrawElements(GL_TRIANGLES, renderer.mesh->getIndiceCount(), GL_UNSIGNED_INT, 0);
-	}
+	// Pre pass render all batches with a single indirect draw call
+	glBindVertexArray(GeometryArena::getVAO());
+	Instancing::drawBatches(0, static_cast<uint32_t>(batches.size()));
 }
 
 uint32_t PrePass::getDepthOutput()
@@ -4,8 +4,10 @@
 #include <vector>
 #include <glm.hpp>
 
+#include "../src/core/ecs/ecs.h"
 #include "../src/core/viewport/viewport.h"
 #include "../src/core/rendering/shader/shader.h"
+#include "../src/core/rendering/instancing/instancing.h"
 
 class PrePass
 {
@@ -15,7 +17,7 @@ public:
 	void create();
 	void destroy();
 
-	void render(glm::mat4 viewProjection, glm::mat3 viewNormal);
+	void render(const RenderQueue& renderQueue);
 
 	uint32_t getDepthOutput();
 	uint32_t getNormalOutput();
@@ -28,4 +30,7 @@ private:
 	uint32_t normalOutput;
 
 	Shader* prePassShader;
+
+	std::vector<Instancing::Instance> instances;
+	std::vector<Instancing::Batch> batches;
 };
\ No newline at end of file
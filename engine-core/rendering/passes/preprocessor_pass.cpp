@@ -1,14 +1,126 @@
 #include "preprocessor_pass.h"
 
+#include <string>
+
 #include "../src/core/ecs/ecs_collection.h"
-#include "../src/core/transform/transform.h"
+#include "../src/core/jobs/job_system.h"
+#include "../src/core/diagnostics/profiler.h"
+#include "../src/core/transform/transform_system.h"
+#include "../src/core/rendering/model/mesh.h"
+#include "../src/core/rendering/renderqueue/render_key.h"
+
+// Amount of entities processed per job
+constexpr uint32_t BATCH_SIZE = 256;
+
+std::vector<std::string> PreprocessorPass::threadTimingNames;
+
+void PreprocessorPass::prepareFrame()
+{
+	JobSystem::resetThreadTimes();
+
+	// Evaluate changed transform hierarchies
+	TransformSystem::update();
+
+	// Update world bounds of each entity
+	auto targets = ECS::gRegistry.view<TransformComponent, MeshRendererComponent, BoundsComponent>();
+	JobSystem::parallelEach(targets, [](Entity /*entity*/, TransformComponent& transform, MeshRendererComponent& renderer, BoundsComponent& bounds) {
+		updateBounds(transform, renderer, bounds);
+	}, BATCH_SIZE);
+
+	// Build timing names of threads once
+	uint32_t nThreads = JobSystem::getThreadCount();
+	while (threadTimingNames.size() < nThreads) threadTimingNames.push_back("prepare_frame_thread_" + std::to_string(threadTimingNames.size()));
+
+	// Report time each thread spent preparing the frame
+	for (uint32_t i = 0; i < nThreads; i++) {
+		Profiler::record(threadTimingNames[i], JobSystem::getThreadTime(i));
+	}
+}
+
+void PreprocessorPass::perform(glm::mat4 viewProjection, const OcclusionCulling::DepthPyramid* occluders)
+{
+	// Gather bounds of render queue entries
+	const RenderQueue& renderQueue = ECS::getRenderQueue();
+	boundsBatch.resize(renderQueue.size());
+	JobSystem::parallelFor(static_cast<uint32_t>(renderQueue.size()), BATCH_SIZE, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; i++) {
+			const BoundsComponent& bounds = ECS::gRegistry.get<BoundsComponent>(renderQueue[i].entity);
+			boundsBatch.set(i, bounds.min, bounds.max);
+		}
+	});
+
+	// Cull bounds against view frustum
+	FrustumCulling::Frustum frustum = FrustumCulling::extract(viewProjection);
+	FrustumCulling::test(frustum, boundsBatch, visibleIndices);
 
-void PreprocessorPass::perform(glm::mat4 viewProjection)
+	// Cull bounds hidden behind the occluders (depth pyramid of a previous frame, bounds are reprojected into its view)
+	if (occluders && !occluders->empty()) {
+		occludedFlags.resize(visibleIndices.size());
+		JobSystem::parallelFor(static_cast<uint32_t>(visibleIndices.size()), BATCH_SIZE, [&](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; i++) {
+				occludedFlags[i] = OcclusionCulling::isOccluded(*occluders, boundsBatch, visibleIndices[i]);
+			}
+		});
+
+		// Keep indices of unoccluded bounds
+		size_t nVisible = 0;
+		for (size_t i = 0; i < visibleIndices.size(); i++) {
+			if (!occludedFlags[i]) visibleIndices[nVisible++] = visibleIndices[i];
+		}
+		visibleIndices.resize(nVisible);
+	}
+
+	// Fill visible queue with render keys of visible entities
+	visibleQueue.resize(visibleIndices.size());
+	JobSystem::parallelFor(static_cast<uint32_t>(visibleIndices.size()), BATCH_SIZE, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; i++) {
+			uint32_t index = visibleIndices[i];
+			Entity entity = renderQueue[index].entity;
+			const MeshRendererComponent& renderer = ECS::gRegistry.get<MeshRendererComponent>(entity);
+
+			// View depth of bounds center (clip space w)
+			glm::vec3 center = glm::vec3(boundsBatch.centerX[index], boundsBatch.centerY[index], boundsBatch.centerZ[index]);
+			float viewDepth = (viewProjection * glm::vec4(center, 1.0f)).w;
+
+			// Pack render key
+			uint32_t shaderId = renderer.material ? renderer.material->getShaderId() : UINT32_MAX;
+			uint32_t materialId = renderer.material ? renderer.material->getId() : UINT32_MAX;
+			uint32_t meshId = renderer.mesh ? renderer.mesh->getId() : 0;
+			uint64_t key = RenderKey::pack(RenderKey::Pass::SOLID_GEOMETRY, shaderId, materialId, meshId, viewDepth);
+
+			visibleQueue[i] = { key, entity };
+		}
+	});
+
+	// Sort visible queue by render keys
+	RenderKey::sort(visibleQueue, sortScratch);
+}
+
+const RenderQueue& PreprocessorPass::getVisibleQueue() const
+{
+	return visibleQueue;
+}
+
+void PreprocessorPass::updateBounds(const TransformComponent& transform, const MeshRendererComponent& renderer, BoundsComponent& bounds)
 {
-	// Pre pass render each entity
-	auto targets = ECS::gRegistry.view<TransformComponent, MeshRendererComponent>();
-	for (auto [entity, transform, renderer] : targets.each()) {
-		// Compute transform matrices
-		Transform::evaluate(transform, viewProjection);
+	// Collapse bounds to the transforms origin if there is no mesh
+	if (!renderer.mesh) {
+		bounds.min = glm::vec3(transform.model[3]);
+		bounds.max = bounds.min;
+		return;
 	}
-}
\ No newline at end of file
+
+	// Object space center and half extents
+	glm::vec3 center = (renderer.mesh->getMinPoint() + renderer.mesh->getMaxPoint()) * 0.5f;
+	glm::vec3 extents = (renderer.mesh->getMaxPoint() - renderer.mesh->getMinPoint()) * 0.5f;
+
+	// Transform center and project extents onto world axes
+	glm::mat3 basis = glm::mat3(transform.model);
+	glm::mat3 absoluteBasis = glm::mat3(glm::abs(basis[0]), glm::abs(basis[1]), glm::abs(basis[2]));
+	glm::vec3 worldCenter = glm::vec3(transform.model * glm::vec4(center, 1.0f));
+	glm::vec3 worldExtents = absoluteBasis * extents;
+
+	// Set world bounds
+	bounds.min = worldCenter - worldExtents;
+	bounds.max = worldCenter + worldExtents;
+}
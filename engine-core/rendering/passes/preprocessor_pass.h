@@ -1,10 +1,46 @@
 #pragma once
 
+#include <string>
+#include <vector>
+#include <cstdint>
 #include <glm.hpp>
 
+#include "../src/core/ecs/ecs.h"
+#include "../src/core/rendering/culling/frustum_culling.h"
+#include "../src/core/rendering/culling/occlusion_culling.h"
+
 class PreprocessorPass
 {
 public:
-	// Performs the preprocessing needed before rendering for all entities
-	void perform(glm::mat4 viewProjection);
+	// Evaluates transforms and world bounds of all entities in parallel, once per frame before any view is rendered
+	static void prepareFrame();
+
+	// Culls and sorts the render queue for the given view, gathering bounds and render keys in parallel
+	// Entities hidden behind the given occluders are culled too if there are any
+	void perform(glm::mat4 viewProjection, const OcclusionCulling::DepthPyramid* occluders = nullptr);
+
+	// Returns the render queue filtered by visibility and sorted by render keys during the latest preprocessing
+	const RenderQueue& getVisibleQueue() const;
+
+private:
+	// Updates the world space bounds of an entity using its meshes object space bounds
+	static void updateBounds(const TransformComponent& transform, const MeshRendererComponent& renderer, BoundsComponent& bounds);
+
+	// Profiler timing names of each threads share of frame preparation, built once instead of each frame
+	static std::vector<std::string> threadTimingNames;
+
+	// Batched world space bounds of all render queue entries
+	FrustumCulling::BoundsBatch boundsBatch;
+
+	// Indices of visible render queue entries
+	std::vector<uint32_t> visibleIndices;
+
+	// Occlusion test results of the render queue entries within the view frustum
+	std::vector<uint8_t> occludedFlags;
+
+	// Render queue containing visible entities only
+	RenderQueue visibleQueue;
+
+	// Scratch buffer for sorting the visible queue
+	RenderQueue sortScratch;
 };
@@ -41,10 +41,7 @@ void SSAOPass::create(float aoScale, int32_t maxKernelSamples, float noiseResolu
 	aoPassShader->setInt("normalInput", NORMAL_UNIT);
 	aoPassShader->setInt("noiseTexture", NOISE_UNIT);
 	aoPassShader->setFloat("noiseSize", noiseResolution);
-	for (int32_t i = 0; i < maxKernelSamples; ++i)
-	{
-		aoPassShader->setVec3("samples[" + std::to_string(i) + "]", kernel[i]);
-	}
+	aoPassShader->setVec3Array("samples", kernel.data(), maxKernelSamples);
 
 	// Set ambient occlusion blur shaders static uniforms
 	aoBlurShader = ShaderPool::get("ssao_blur");
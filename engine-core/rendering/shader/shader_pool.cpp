@@ -44,7 +44,7 @@ namespace ShaderPool {
 
 			// Create shader
 			if (async) {
-				loader.createAsync(shader);
+				loader.createAsync(shader, ResourcePriority::CRITICAL);
 			}
 			else {
 				loader.createSync(shader);
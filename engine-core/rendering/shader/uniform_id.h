@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Identifies a shader uniform by the hash of its name, string literals are hashed at compile time
+struct UniformId
+{
+	// Creates the id of the uniform with the given name literal
+	template <size_t N>
+	constexpr UniformId(const char(&name)[N]) : hash(fnv1a(name, N - 1))
+	{
+	}
+
+	// Creates the id of the uniform with the given name at runtime (avoid in per frame code)
+	explicit UniformId(const std::string& name) : hash(fnv1a(name.data(), name.size()))
+	{
+	}
+
+	// Returns the 32-bit FNV-1a hash of the given characters
+	static constexpr uint32_t fnv1a(const char* data, size_t length)
+	{
+		uint32_t value = 2166136261u;
+		for (size_t i = 0; i < length; i++) {
+			value ^= static_cast<uint8_t>(data[i]);
+			value *= 16777619u;
+		}
+		return value;
+	}
+
+	constexpr bool operator==(const UniformId& other) const { return hash == other.hash; }
+	constexpr bool operator<(const UniformId& other) const { return hash < other.hash; }
+
+	// Hash of the uniforms name
+	uint32_t hash;
+};
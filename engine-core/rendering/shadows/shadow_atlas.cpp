@@ -0,0 +1,406 @@
+#include "shadow_atlas.h"
+
+#include <glad/glad.h>
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+#include <gtc/matrix_transform.hpp>
+
+#include "../src/core/utils/console.h"
+#include "../src/core/rendering/shader/shader_pool.h"
+#include "../src/core/rendering/transformation/transformation.h"
+
+// Per pass uniforms, hashed at compile time
+constexpr UniformId LIGHT_SPACE_MATRIX = "lightSpaceMatrix";
+
+// Near plane of the light projections
+constexpr float NEAR_PLANE = 0.1f;
+
+// Factor the targeted tile size has to leave the current tile size by before a light is moved to a differently sized tile
+constexpr float RESIZE_MARGIN = 1.25f;
+
+// Maximum field of view of spotlight projections in degrees
+constexpr float MAX_ANGLE = 170.0f;
+
+ShadowAtlas::ShadowAtlas(uint32_t resolution) : resolution(resolution),
+texture(0),
+framebuffer(0),
+freeBlocks(),
+entries(),
+order(),
+tiles(),
+tileIndices(),
+updates(0),
+shadowPassShader(nullptr)
+{
+}
+
+void ShadowAtlas::create()
+{
+	// Get shader
+	shadowPassShader = ShaderPool::get("shadow_pass");
+
+	// Generate framebuffer
+	glGenFramebuffers(1, &framebuffer);
+
+	// Generate texture
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, resolution, resolution, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+
+	// Set texture parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// Set framebuffer attachments
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture, 0);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+
+	// Check for framebuffer errors
+	GLenum fboStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if (fboStatus != GL_FRAMEBUFFER_COMPLETE)
+	{
+		Console::out::warning("Shadow Atlas", "Issue while generating framebuffer: " + std::to_string(fboStatus));
+	}
+
+	// Unbind framebuffer
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	// Start with the whole atlas free, one level per block size down to the smallest tiles
+	uint32_t nLevels = 1;
+	while ((resolution >> nLevels) >= MIN_TILE_SIZE) nLevels++;
+	freeBlocks.assign(nLevels, {});
+	freeBlocks[0].push_back(glm::uvec2(0));
+}
+
+void ShadowAtlas::destroy()
+{
+	// Delete texture
+	glDeleteTextures(1, &texture);
+	texture = 0;
+
+	// Delete framebuffer
+	glDeleteFramebuffers(1, &framebuffer);
+	framebuffer = 0;
+
+	// Forget all lights and tiles
+	freeBlocks.clear();
+	entries.clear();
+	order.clear();
+	tiles.clear();
+	tileIndices.clear();
+
+	// Reset shader
+	shadowPassShader = nullptr;
+}
+
+void ShadowAtlas::castShadows(ShadowCasters& casters, const glm::vec3& cameraPosition)
+{
+	updates++;
+
+	gatherLights(cameraPosition);
+	assignTiles();
+	renderTiles(casters);
+	buildTiles();
+}
+
+void ShadowAtlas::bind(uint32_t unit)
+{
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+uint32_t ShadowAtlas::getTexture() const
+{
+	return texture;
+}
+
+uint32_t ShadowAtlas::getResolution() const
+{
+	return resolution;
+}
+
+const std::vector<ShadowAtlas::Tile>& ShadowAtlas::getTiles() const
+{
+	return tiles;
+}
+
+int32_t ShadowAtlas::getTile(Entity light) const
+{
+	auto it = tileIndices.find(light);
+	return it != tileIndices.end() ? it->second : -1;
+}
+
+void ShadowAtlas::gatherLights(const glm::vec3& cameraPosition)
+{
+	order.clear();
+
+	// Adds a light, its importance given by the share of the view its range may cover
+	auto add = [&](Entity entity, const TransformComponent& transform, bool point, float intensity, float range, float angle) {
+		if (range <= 0.0f || intensity <= 0.0f) return;
+
+		Entry& entry = entries[entity];
+		if (entry.point != point) releaseTiles(entry);
+		entry.point = point;
+		entry.position = Transformation::toBackendPosition(transform.position);
+		entry.direction = point ? glm::vec3(0.0f) : Transformation::direction(transform.model);
+		entry.range = range;
+		entry.angle = angle;
+
+		float coverage = range / std::max(glm::length(entry.position - cameraPosition), range);
+		entry.targetSize = coverage * MAX_TILE_SIZE;
+		entry.importance = coverage * intensity;
+		entry.seenUpdate = updates;
+		order.push_back(entity);
+	};
+
+	auto pointLights = ECS::gRegistry.view<TransformComponent, PointLightComponent>();
+	for (auto [entity, transform, pointLight] : pointLights.each()) {
+		if (pointLight.enabled) add(entity, transform, true, pointLight.intensity, pointLight.range, 90.0f);
+	}
+
+	auto spotlights = ECS::gRegistry.view<TransformComponent, SpotlightComponent>();
+	for (auto [entity, transform, spotlight] : spotlights.each()) {
+		if (spotlight.enabled) add(entity, transform, false, spotlight.intensity, spotlight.range, std::clamp(spotlight.outerAngle, 1.0f, MAX_ANGLE));
+	}
+
+	// Order lights by importance
+	std::sort(order.begin(), order.end(), [&](Entity a, Entity b) { return entries[a].importance > entries[b].importance; });
+}
+
+void ShadowAtlas::assignTiles()
+{
+	// Release tiles of lights gone
+	for (auto it = entries.begin(); it != entries.end();) {
+		if (it->second.seenUpdate == updates) {
+			it++;
+			continue;
+		}
+		releaseTiles(it->second);
+		it = entries.erase(it);
+	}
+
+	for (size_t i = 0; i < order.size(); i++) {
+		Entry& entry = entries[order[i]];
+
+		// Get smallest tile size covering the targeted size
+		float targetSize = std::clamp(entry.targetSize, static_cast<float>(MIN_TILE_SIZE), static_cast<float>(MAX_TILE_SIZE));
+		uint32_t size = MIN_TILE_SIZE;
+		while (static_cast<float>(size) < targetSize) size *= 2;
+
+		// Move lights to new tiles once their targeted size left their tiles size, keeping their tiles if there is no room
+		if (entry.size) {
+			bool grow = targetSize > entry.size * RESIZE_MARGIN;
+			bool shrink = targetSize * RESIZE_MARGIN < entry.size * 0.5f;
+			if (!grow && !shrink) continue;
+
+			Entry resized = entry;
+			if (!allocateTiles(resized, size)) continue;
+			releaseTiles(entry);
+			entry.size = resized.size;
+			std::copy(std::begin(resized.positions), std::end(resized.positions), std::begin(entry.positions));
+			continue;
+		}
+
+		// Try decreasing sizes for lights without tiles
+		uint32_t fitting = size;
+		while (fitting >= MIN_TILE_SIZE && !allocateTiles(entry, fitting)) fitting /= 2;
+		if (entry.size) continue;
+
+		// Dry run evicting the least important lights until releasing their tiles lets the light fit at the smallest tile size
+		FreeBlocks trial = freeBlocks;
+		size_t evicted = order.size();
+		while (evicted > i + 1 && countFree(trial, MIN_TILE_SIZE) < entry.faces()) {
+			const Entry& candidate = entries[order[--evicted]];
+			for (uint32_t face = 0; candidate.size && face < candidate.faces(); face++) release(trial, candidate.size, candidate.positions[face]);
+		}
+
+		// Keep all tiles if evicting wouldn't make room
+		if (countFree(trial, MIN_TILE_SIZE) < entry.faces()) continue;
+
+		// Evict lights and take the largest tiles fitting now
+		for (size_t j = evicted; j < order.size(); j++) releaseTiles(entries[order[j]]);
+		fitting = size;
+		while (fitting >= MIN_TILE_SIZE && !allocateTiles(entry, fitting)) fitting /= 2;
+	}
+}
+
+void ShadowAtlas::renderTiles(ShadowCasters& casters)
+{
+	// Lights holding tiles ordered by refresh priority, lights changed since their latest render first and others by importance weighted by the time since their latest render
+	std::vector<std::pair<float, Entity>> due;
+	for (Entity entity : order) {
+		const Entry& entry = entries[entity];
+		if (!entry.size) continue;
+
+		bool changed = !entry.renderedUpdate || entry.position != entry.renderedPosition || entry.direction != entry.renderedDirection || entry.range != entry.renderedRange || entry.angle != entry.renderedAngle;
+		float staleness = static_cast<float>(updates - entry.renderedUpdate);
+		due.emplace_back(changed ? FLT_MAX : entry.importance * staleness, entity);
+	}
+	std::stable_sort(due.begin(), due.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+	// Bind framebuffer and shadow pass shader
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glEnable(GL_DEPTH_TEST);
+	glEnable(GL_CULL_FACE);
+	glCullFace(GL_FRONT);
+	glEnable(GL_SCISSOR_TEST);
+	shadowPassShader->bind();
+
+	// Render lights as long as their faces fit the budget
+	uint32_t budget = RENDER_BUDGET;
+	for (auto [priority, entity] : due) {
+		Entry& entry = entries[entity];
+		if (entry.faces() > budget) continue;
+		budget -= entry.faces();
+
+		entry.renderedPosition = entry.position;
+		entry.renderedDirection = entry.direction;
+		entry.renderedRange = entry.range;
+		entry.renderedAngle = entry.angle;
+		entry.renderedUpdate = updates;
+
+		for (uint32_t face = 0; face < entry.faces(); face++) {
+			// Restrict rendering to the tile
+			glm::uvec2 position = entry.positions[face];
+			glViewport(position.x, position.y, entry.size, entry.size);
+			glScissor(position.x, position.y, entry.size, entry.size);
+			glClear(GL_DEPTH_BUFFER_BIT);
+
+			// Render casters within the faces light space
+			glm::mat4 lightSpace = getLightSpace(entry, face);
+			shadowPassShader->setMatrix4(LIGHT_SPACE_MATRIX, lightSpace);
+			casters.draw(lightSpace);
+		}
+	}
+
+	// Disable scissor test and unbind framebuffer
+	glDisable(GL_SCISSOR_TEST);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void ShadowAtlas::buildTiles()
+{
+	tiles.clear();
+	tileIndices.clear();
+
+	// Lights sample their tiles once they hold a render of the light
+	for (Entity entity : order) {
+		const Entry& entry = entries[entity];
+		if (!entry.size || !entry.renderedUpdate) continue;
+
+		float fov = glm::radians(entry.renderedAngle);
+		tileIndices[entity] = static_cast<int32_t>(tiles.size());
+		for (uint32_t face = 0; face < entry.faces(); face++) {
+			Tile& tile = tiles.emplace_back();
+			tile.lightSpace = getLightSpace(entry, face);
+			tile.rect = glm::vec4(glm::vec2(entry.positions[face]), glm::vec2(static_cast<float>(entry.size))) / static_cast<float>(resolution);
+			tile.texelScale = 2.0f * std::tan(fov * 0.5f) / static_cast<float>(entry.size);
+		}
+	}
+}
+
+glm::mat4 ShadowAtlas::getLightSpace(const Entry& entry, uint32_t face) const
+{
+	// Directions and up vectors of the cube faces
+	static const glm::vec3 faceDirections[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+	static const glm::vec3 faceUps[6] = { { 0, -1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }, { 0, -1, 0 }, { 0, -1, 0 } };
+
+	// Spotlights look along their direction, point lights along the given cube face
+	glm::vec3 direction = entry.point ? faceDirections[face] : entry.renderedDirection;
+	glm::vec3 up = entry.point ? faceUps[face] : (std::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f));
+
+	glm::mat4 view = glm::lookAt(entry.renderedPosition, entry.renderedPosition + direction, up);
+	glm::mat4 projection = glm::perspective(glm::radians(entry.renderedAngle), 1.0f, NEAR_PLANE, entry.renderedRange);
+	return projection * view;
+}
+
+bool ShadowAtlas::allocate(uint32_t size, glm::uvec2& position)
+{
+	// Get level of block size
+	uint32_t level = 0;
+	while ((resolution >> level) > size) level++;
+	if (level >= freeBlocks.size()) return false;
+
+	// Find the smallest free block at least as large
+	int32_t source = static_cast<int32_t>(level);
+	while (source >= 0 && freeBlocks[source].empty()) source--;
+	if (source < 0) return false;
+
+	glm::uvec2 block = freeBlocks[source].back();
+	freeBlocks[source].pop_back();
+
+	// Split block down to the requested size, keeping the other quarters free
+	for (uint32_t splitLevel = static_cast<uint32_t>(source); splitLevel < level; splitLevel++) {
+		uint32_t half = resolution >> (splitLevel + 1);
+		freeBlocks[splitLevel + 1].push_back(block + glm::uvec2(half, 0));
+		freeBlocks[splitLevel + 1].push_back(block + glm::uvec2(0, half));
+		freeBlocks[splitLevel + 1].push_back(block + glm::uvec2(half, half));
+	}
+
+	position = block;
+	return true;
+}
+
+void ShadowAtlas::release(FreeBlocks& blocks, uint32_t size, glm::uvec2 position) const
+{
+	// Get level of block size
+	uint32_t level = 0;
+	while ((resolution >> level) > size) level++;
+
+	// Merge block with its siblings as long as all of them are free
+	while (level > 0) {
+		uint32_t parentSize = resolution >> (level - 1);
+		glm::uvec2 parent = position / parentSize * parentSize;
+
+		std::vector<glm::uvec2>& levelBlocks = blocks[level];
+		auto isSibling = [&](const glm::uvec2& block) { return block / parentSize * parentSize == parent; };
+		if (std::count_if(levelBlocks.begin(), levelBlocks.end(), isSibling) < 3) break;
+
+		levelBlocks.erase(std::remove_if(levelBlocks.begin(), levelBlocks.end(), isSibling), levelBlocks.end());
+		position = parent;
+		level--;
+	}
+
+	blocks[level].push_back(position);
+}
+
+uint32_t ShadowAtlas::countFree(const FreeBlocks& blocks, uint32_t size) const
+{
+	// Each free block at least as large splits into blocks of the given size, smaller free blocks can't hold one
+	uint32_t count = 0;
+	for (uint32_t level = 0; level < blocks.size() && (resolution >> level) >= size; level++) {
+		uint32_t split = (resolution >> level) / size;
+		count += static_cast<uint32_t>(blocks[level].size()) * split * split;
+	}
+	return count;
+}
+
+bool ShadowAtlas::allocateTiles(Entry& entry, uint32_t size)
+{
+	for (uint32_t face = 0; face < entry.faces(); face++) {
+		if (allocate(size, entry.positions[face])) continue;
+
+		// Release faces allocated so far if the light doesn't fit
+		for (uint32_t allocated = 0; allocated < face; allocated++) release(freeBlocks, size, entry.positions[allocated]);
+		return false;
+	}
+
+	entry.size = size;
+	entry.renderedUpdate = 0;
+	return true;
+}
+
+void ShadowAtlas::releaseTiles(Entry& entry)
+{
+	if (!entry.size) return;
+
+	for (uint32_t face = 0; face < entry.faces(); face++) release(freeBlocks, entry.size, entry.positions[face]);
+	entry.size = 0;
+	entry.renderedUpdate = 0;
+}
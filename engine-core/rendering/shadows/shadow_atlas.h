@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <glm.hpp>
+
+#include "../src/core/ecs/ecs_collection.h"
+#include "../src/core/rendering/shader/shader.h"
+#include "../src/core/rendering/shadows/shadow_casters.h"
+
+// Single depth texture holding the shadow maps of point lights and spotlights in tiles sized by their screen coverage, refreshing a limited amount of tiles per update
+class ShadowAtlas
+{
+public:
+	// Layout of a tile within the "ShadowTiles" storage block (std430)
+	struct Tile {
+		glm::mat4 lightSpace;
+		glm::vec4 rect; // Offset and size of the tile in atlas uv space
+		float texelScale; // World space size of a tile texel per unit of distance to the light
+		float _padding[3];
+	};
+
+	explicit ShadowAtlas(uint32_t resolution);
+
+	// Create the shadow atlas
+	void create();
+
+	// Destroy the shadow atlas
+	void destroy();
+
+	// Assigns tiles to the enabled point lights and spotlights of the global registry as seen from the given camera position and renders the given casters into the tiles due
+	void castShadows(ShadowCasters& casters, const glm::vec3& cameraPosition);
+
+	// Bind the atlas texture to a given unit
+	void bind(uint32_t unit);
+
+	// Returns the texture of the atlas
+	uint32_t getTexture() const;
+
+	// Returns the resolution of the atlas
+	uint32_t getResolution() const;
+
+	// Returns the tiles of the latest update, a point lights tiles hold its cube faces in the order +x, -x, +y, -y, +z, -z
+	const std::vector<Tile>& getTiles() const;
+
+	// Returns the index of the first tile of the given light during the latest update (-1 if the light casts no shadows)
+	int32_t getTile(Entity light) const;
+
+	// Maximum amount of faces rendered per update
+	static constexpr uint32_t RENDER_BUDGET = 12;
+
+	// Resolution bounds of tiles
+	static constexpr uint32_t MIN_TILE_SIZE = 128;
+	static constexpr uint32_t MAX_TILE_SIZE = 1024;
+
+private:
+	// Free blocks per block size level, level 0 being the whole atlas
+	using FreeBlocks = std::vector<std::vector<glm::uvec2>>;
+
+	// Shadow casting light and its tiles
+	struct Entry
+	{
+		bool point = false;
+
+		// Light source parameters of the current update and the latest render
+		glm::vec3 position = glm::vec3(0.0f);
+		glm::vec3 direction = glm::vec3(0.0f);
+		float range = 0.0f;
+		float angle = 0.0f;
+		glm::vec3 renderedPosition = glm::vec3(0.0f);
+		glm::vec3 renderedDirection = glm::vec3(0.0f);
+		float renderedRange = 0.0f;
+		float renderedAngle = 0.0f;
+
+		// Screen coverage scaled by intensity, lights with higher importance keep their tiles and refresh first
+		float importance = 0.0f;
+
+		// Tile resolution targeted by screen coverage
+		float targetSize = 0.0f;
+
+		// Resolution and atlas positions of the tiles (size is 0 while the light has no tiles)
+		uint32_t size = 0;
+		glm::uvec2 positions[6] = {};
+
+		// Update the tiles were rendered in last (0 if they hold no render of the light)
+		uint64_t renderedUpdate = 0;
+
+		// Update the light was seen in last
+		uint64_t seenUpdate = 0;
+
+		// Returns the amount of tiles of the light
+		uint32_t faces() const { return point ? 6 : 1; }
+	};
+
+	// Gathers the shadow casting lights of the global registry
+	void gatherLights(const glm::vec3& cameraPosition);
+
+	// Assigns tiles to the lights by importance, releasing tiles of lights gone or resized
+	void assignTiles();
+
+	// Renders the tiles due within the render budget
+	void renderTiles(ShadowCasters& casters);
+
+	// Builds the tiles of the lights holding a render
+	void buildTiles();
+
+	// Returns the light space matrix of the given face of a light
+	glm::mat4 getLightSpace(const Entry& entry, uint32_t face) const;
+
+	// Allocates a square block of the given size, returns false if there is no free block
+	bool allocate(uint32_t size, glm::uvec2& position);
+
+	// Releases a block of the given size into the given free blocks, merging it with its free siblings
+	void release(FreeBlocks& blocks, uint32_t size, glm::uvec2 position) const;
+
+	// Returns the amount of blocks of the given size the given free blocks can hold
+	uint32_t countFree(const FreeBlocks& blocks, uint32_t size) const;
+
+	// Allocates tiles of the given size for all faces of a light, returns false if they don't fit
+	bool allocateTiles(Entry& entry, uint32_t size);
+
+	// Releases all tiles of a light
+	void releaseTiles(Entry& entry);
+
+	// Resolution of the atlas
+	uint32_t resolution;
+
+	// Atlas backend texture id
+	uint32_t texture;
+
+	// Atlas backend framebuffer id
+	uint32_t framebuffer;
+
+	// Free blocks of the atlas
+	FreeBlocks freeBlocks;
+
+	// Shadow casting lights
+	std::unordered_map<Entity, Entry> entries;
+
+	// Lights of the current update ordered by importance
+	std::vector<Entity> order;
+
+	// Tiles of the latest update and the index of the first tile of each light
+	std::vector<Tile> tiles;
+	std::unordered_map<Entity, int32_t> tileIndices;
+
+	// Amount of updates so far
+	uint64_t updates;
+
+	// Shadow pass shader
+	Shader* shadowPassShader;
+};
@@ -0,0 +1,191 @@
+#include "mip_generator.h"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MIP_GENERATOR_SSE2
+#endif
+
+namespace MipGenerator {
+
+	// Resolution of the table encoding linear values to srgb
+	constexpr uint32_t LINEAR_TO_SRGB_STEPS = 4096;
+
+	// Returns the table decoding srgb encoded values to linear values
+	const std::array<float, 256>& _srgbToLinear()
+	{
+		static const std::array<float, 256> table = []() {
+			std::array<float, 256> values;
+			for (uint32_t i = 0; i < 256; i++) {
+				float value = i / 255.0f;
+				values[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+			}
+			return values;
+		}();
+		return table;
+	}
+
+	// Returns the table encoding linear values in equal steps to srgb
+	const std::array<uint8_t, LINEAR_TO_SRGB_STEPS>& _linearToSrgb()
+	{
+		static const std::array<uint8_t, LINEAR_TO_SRGB_STEPS> table = []() {
+			std::array<uint8_t, LINEAR_TO_SRGB_STEPS> values;
+			for (uint32_t i = 0; i < LINEAR_TO_SRGB_STEPS; i++) {
+				float value = i / static_cast<float>(LINEAR_TO_SRGB_STEPS - 1);
+				float encoded = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+				values[i] = static_cast<uint8_t>(std::round(std::clamp(encoded, 0.0f, 1.0f) * 255.0f));
+			}
+			return values;
+		}();
+		return table;
+	}
+
+	// Returns the given value within [0, 255] as rounded 8-bit value
+	uint8_t _unorm8(float value)
+	{
+		return static_cast<uint8_t>(std::clamp(value + 0.5f, 0.0f, 255.0f));
+	}
+
+	// Box filters a row of the next level from the given two source rows averaging channels as they are
+	void _downsampleRowLinear(const uint8_t* row0, const uint8_t* row1, uint32_t width, uint32_t channels, uint32_t nextWidth, uint8_t* destination)
+	{
+		uint32_t x = 0;
+
+#ifdef MIP_GENERATOR_SSE2
+		// Two rgba pixels per iteration, as long as four source pixels can be loaded
+		if (channels == 4) {
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i rounding = _mm_set1_epi16(2);
+			for (; x + 2 <= nextWidth && x * 2 + 4 <= width; x += 2) {
+				__m128i top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+				__m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+
+				// Sum vertical pairs as 16-bit values, low half holds source pixels 0 and 1, high half pixels 2 and 3
+				__m128i low = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+				__m128i high = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+
+				// Sum horizontal pairs
+				low = _mm_add_epi16(low, _mm_srli_si128(low, 8));
+				high = _mm_add_epi16(high, _mm_srli_si128(high, 8));
+				__m128i sum = _mm_unpacklo_epi64(low, high);
+
+				// Average and pack both pixels
+				__m128i average = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2);
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(destination + x * 4), _mm_packus_epi16(average, average));
+			}
+		}
+#endif
+
+		for (; x < nextWidth; x++) {
+			const uint32_t x0 = std::min(x * 2, width - 1) * channels;
+			const uint32_t x1 = std::min(x * 2 + 1, width - 1) * channels;
+			for (uint32_t c = 0; c < channels; c++) {
+				uint32_t sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+				destination[x * channels + c] = static_cast<uint8_t>((sum + 2) / 4);
+			}
+		}
+	}
+
+	// Box filters a row of the next level from the given two source rows averaging srgb encoded color channels in linear space
+	void _downsampleRowSrgb(const uint8_t* row0, const uint8_t* row1, uint32_t width, uint32_t channels, uint32_t nextWidth, uint8_t* destination)
+	{
+		const std::array<float, 256>& toLinear = _srgbToLinear();
+		const std::array<uint8_t, LINEAR_TO_SRGB_STEPS>& toSrgb = _linearToSrgb();
+		const uint32_t colorChannels = std::min(channels, 3u);
+
+		for (uint32_t x = 0; x < nextWidth; x++) {
+			const uint32_t x0 = std::min(x * 2, width - 1) * channels;
+			const uint32_t x1 = std::min(x * 2 + 1, width - 1) * channels;
+			for (uint32_t c = 0; c < channels; c++) {
+				if (c < colorChannels) {
+					float average = (toLinear[row0[x0 + c]] + toLinear[row0[x1 + c]] + toLinear[row1[x0 + c]] + toLinear[row1[x1 + c]]) * 0.25f;
+					destination[x * channels + c] = toSrgb[static_cast<uint32_t>(average * (LINEAR_TO_SRGB_STEPS - 1) + 0.5f)];
+				}
+				else {
+					uint32_t sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+					destination[x * channels + c] = static_cast<uint8_t>((sum + 2) / 4);
+				}
+			}
+		}
+	}
+
+	// Box filters a row of the next level from the given two source rows renormalizing the averaged vectors
+	void _downsampleRowNormal(const uint8_t* row0, const uint8_t* row1, uint32_t width, uint32_t channels, uint32_t nextWidth, uint8_t* destination)
+	{
+		for (uint32_t x = 0; x < nextWidth; x++) {
+			const uint32_t x0 = std::min(x * 2, width - 1) * channels;
+			const uint32_t x1 = std::min(x * 2 + 1, width - 1) * channels;
+
+			// Average decoded vectors
+			float vector[3];
+			for (uint32_t c = 0; c < 3; c++) {
+				float sum = static_cast<float>(row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c]);
+				vector[c] = sum / 510.0f - 1.0f;
+			}
+
+			// Renormalize vector (vectors cancelling out fall back to up)
+			float length = std::sqrt(vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2]);
+			if (length <= 1e-6f) {
+				vector[0] = 0.0f;
+				vector[1] = 0.0f;
+				vector[2] = 1.0f;
+				length = 1.0f;
+			}
+			for (uint32_t c = 0; c < 3; c++) {
+				destination[x * channels + c] = _unorm8((vector[c] / length * 0.5f + 0.5f) * 255.0f);
+			}
+
+			// Average remaining channels as they are
+			for (uint32_t c = 3; c < channels; c++) {
+				uint32_t sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+				destination[x * channels + c] = static_cast<uint8_t>((sum + 2) / 4);
+			}
+		}
+	}
+
+	uint32_t getLevelCount(uint32_t width, uint32_t height)
+	{
+		uint32_t count = 1;
+		while ((std::max(width, height) >> count) > 0) count++;
+		return count;
+	}
+
+	uint32_t getNextDimension(uint32_t dimension)
+	{
+		return std::max(dimension / 2, 1u);
+	}
+
+	void downsample(const uint8_t* source, uint32_t width, uint32_t height, uint32_t channels, Encoding encoding, uint8_t* destination)
+	{
+		// Vectors need at least three channels
+		if (encoding == Encoding::NORMAL && channels < 3) encoding = Encoding::LINEAR;
+
+		const uint32_t nextWidth = getNextDimension(width);
+		const uint32_t nextHeight = getNextDimension(height);
+		const size_t rowSize = static_cast<size_t>(width) * channels;
+		const size_t nextRowSize = static_cast<size_t>(nextWidth) * channels;
+
+		for (uint32_t y = 0; y < nextHeight; y++) {
+			const uint8_t* row0 = source + std::min(y * 2, height - 1) * rowSize;
+			const uint8_t* row1 = source + std::min(y * 2 + 1, height - 1) * rowSize;
+			uint8_t* row = destination + y * nextRowSize;
+
+			switch (encoding) {
+			case Encoding::LINEAR:
+				_downsampleRowLinear(row0, row1, width, channels, nextWidth, row);
+				break;
+			case Encoding::SRGB:
+				_downsampleRowSrgb(row0, row1, width, channels, nextWidth, row);
+				break;
+			case Encoding::NORMAL:
+				_downsampleRowNormal(row0, row1, width, channels, nextWidth, row);
+				break;
+			}
+		}
+	}
+
+}
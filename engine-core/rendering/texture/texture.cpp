@@ -2,23 +2,45 @@
 
 #include <glad/glad.h>
 #include <stb_image.h>
+#include <cmath>
+#include <algorithm>
 
 #include "../src/core/utils/console.h"
 #include "../src/core/utils/iohandler.h"
+#include "../src/core/utils/mapped_file.h"
 #include "../src/core/context/application_context.h"
+#include "../src/core/rendering/texture/mip_generator.h"
+#include "../src/core/rendering/texture/texture_cache.h"
+#include "../src/core/rendering/texture/texture_streaming.h"
 
 uint32_t Texture::defaultTextureId = 0;
 
 Texture::Texture() : type(TextureType::EMPTY),
 path(),
+compression(TextureCompression::BlockFormat::NONE),
+levels(),
+data(),
+region(),
 width(0),
 height(0),
 channels(0),
-data(nullptr),
+levelCount(0),
+streamed(false),
+sourceHash(0),
+residentLevel(0),
+targetLevel(0),
+dispatchedLevels(0),
+dispatchedRows(0),
+pendingId(0),
 _id(defaultTextureId)
 {
 }
 
+Texture::~Texture()
+{
+	TextureStreaming::remove(this);
+}
+
 void Texture::setSource(TextureType _type, const std::string& _path)
 {
 	type = _type;
@@ -40,12 +62,93 @@ std::string Texture::sourcePath()
 	return path;
 }
 
+bool Texture::isStreamed() const
+{
+	return streamed;
+}
+
+uint32_t Texture::getLevelCount() const
+{
+	return levelCount;
+}
+
+uint32_t Texture::getResidentLevel() const
+{
+	return residentLevel;
+}
+
+uint32_t Texture::getPinnedLevel() const
+{
+	uint32_t level = 0;
+	while (level + 1 < levelCount && (std::max(width, height) >> level) > PINNED_DIMENSION) level++;
+	return level;
+}
+
+uint32_t Texture::getRequiredLevel(float uvPerPixel) const
+{
+	// Amount of texels of the finest level covered by a screen pixel, halved by each coarser level
+	float texelsPerPixel = uvPerPixel * static_cast<float>(std::max(width, height));
+	if (!(texelsPerPixel > 1.0f) || levelCount == 0) return 0;
+
+	uint32_t level = static_cast<uint32_t>(std::min(std::floor(std::log2(texelsPerPixel)), 31.0f));
+	return std::min(level, levelCount - 1);
+}
+
+size_t Texture::getLevelSize(uint32_t level) const
+{
+	uint32_t levelWidth = std::max(width >> level, 1u);
+	uint32_t levelHeight = std::max(height >> level, 1u);
+	if (compression != TextureCompression::BlockFormat::NONE) return TextureCompression::getImageSize(compression, levelWidth, levelHeight);
+	return static_cast<size_t>(levelWidth) * levelHeight * channels;
+}
+
+void Texture::streamIn(uint32_t level, ResourcePriority priority)
+{
+	// [MAIN THREAD]
+
+	if (!streamed || level >= residentLevel) return;
+
+	// Load missing levels from the texture cache, the resident levels are used until the finer levels are dispatched
+	targetLevel = level;
+	ApplicationContext::getResourceLoader().createAsync(this, priority);
+}
+
+void Texture::evict(uint32_t level)
+{
+	// [MAIN THREAD]
+
+	// Pinned levels are always kept resident
+	level = std::min(level, getPinnedLevel());
+	if (!streamed || level <= residentLevel || _id == defaultTextureId) return;
+
+	// Immutable storage can't shrink, move the levels kept into a smaller texture
+	uint32_t evictedId = createStorage(level);
+	copyLevels(_id, residentLevel, evictedId, level, level);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glDeleteTextures(1, &_id);
+	_id = evictedId;
+	residentLevel = level;
+}
+
 void Texture::loadData()
 {
-	// Load image data
+	TextureCompression::BlockFormat blockFormat = getBlockFormat(type);
+	std::string cachePath = TextureCache::getCachePath(path);
+
+	// Stream levels of a resident texture in from its texture cache, reload the texture if the cache changed since
+	if (streamed && targetLevel < residentLevel && loadCache(cachePath, true)) return;
+	streamed = false;
+
+	// Load cooked texture if the texture cache is up to date
+	sourceHash = blockFormat != TextureCompression::BlockFormat::NONE ? IOHandler::hashFile(path) : 0;
+	if (sourceHash && loadCache(cachePath, false)) return;
+
+	// Load image data (expanded to rgba if it's cooked)
 	int _width, _height, _channels;
-	stbi_set_flip_vertically_on_load(true);
-	unsigned char* _data = stbi_load(path.c_str(), &_width, &_height, &_channels, 0);
+	int desiredChannels = blockFormat != TextureCompression::BlockFormat::NONE ? 4 : 0;
+	stbi_set_flip_vertically_on_load_thread(true);
+	unsigned char* _data = stbi_load(path.c_str(), &_width, &_height, &_channels, desiredChannels);
 	if (!_data)
 	{
 		Console::out::warning("Texture", "Couldn't load data for texture '" + IOHandler::getFilename(path) + "'");
@@ -55,88 +158,422 @@ void Texture::loadData()
 	// Sync loaded data
 	width = _width;
 	height = _height;
-	channels = _channels;
-	data = _data;
+	channels = desiredChannels ? desiredChannels : _channels;
+
+	// Generate mip chain
+	compression = TextureCompression::BlockFormat::NONE;
+	std::vector<uint8_t> mipChain = generateMipChain(_data);
+
+	// Free memory allocated for image data
+	stbi_image_free(_data);
+
+	if (blockFormat != TextureCompression::BlockFormat::NONE) {
+		// Cook block compressed mip chain, writing the texture cache for the next load and for streaming
+		cook(mipChain, cachePath);
+	}
+	else {
+		// Keep uncompressed mip chain
+		storeLevels(mipChain.data(), 0, levelCount);
+	}
 }
 
 void Texture::releaseData()
 {
-	// Don't release data if there is none
-	if (!data) return;
+	// Release upload ring region if the texture wasn't dispatched from it
+	UploadRing::release(region);
+	region = UploadRing::Region();
 
-	// Free memory allocated for image data
-	stbi_image_free(data);
+	// Free loaded data
+	levels.clear();
+	std::vector<uint8_t>().swap(data);
 }
 
 void Texture::dispatchGPU()
+{
+	// Dispatch all chunks at once
+	while (!dispatchChunk());
+}
+
+bool Texture::dispatchChunk()
 {
 	// Don't dispatch texture if there is no data
-	if (!data) return;
+	if (!hasData()) return true;
 
-	// Generate texture
-	glGenTextures(1, &_id);
-	glBindTexture(GL_TEXTURE_2D, _id);
+	// Get texture backend formats
+	uint32_t internalFormat = 0;
+	uint32_t format = 0;
+	getBackendFormats(internalFormat, format);
+	bool compressed = compression != TextureCompression::BlockFormat::NONE;
 
-	// Set texture parameters
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	// Levels of the backend texture start at the finest loaded level
+	uint32_t baseLevel = levels.front().level;
 
-	// Anisotropic filtering
-	GLfloat maxAniso = 0.0f;
-	glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &maxAniso);
-	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY, maxAniso);
+	// First chunk, generate texture
+	if (dispatchedLevels == 0 && dispatchedRows == 0) {
+		pendingId = createStorage(baseLevel);
+
+		// Copy coarser levels still resident instead of loading them again when streaming
+		uint32_t loadedEnd = levels.back().level + 1;
+		if (loadedEnd < levelCount && _id != defaultTextureId) copyLevels(_id, residentLevel, pendingId, baseLevel, loadedEnd);
+		glBindTexture(GL_TEXTURE_2D, pendingId);
+	}
+	else {
+		glBindTexture(GL_TEXTURE_2D, pendingId);
+	}
+
+	// Bind upload ring if the data is held within it
+	if (region.id) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, UploadRing::getBuffer());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	// Upload bands of rows until the chunk is filled (small levels share a chunk)
+	size_t chunkSize = 0;
+	while (dispatchedLevels < levels.size() && chunkSize < CHUNK_BYTES) {
+		const LevelData& level = levels[dispatchedLevels];
+		uint32_t rows = std::min(getBandRows(level, CHUNK_BYTES - chunkSize), level.height - dispatchedRows);
+		size_t bandSize = getRowsSize(level, rows);
+
+		// Get source of band (offset within the upload ring or pointer to data in memory, rows are tightly packed)
+		size_t bandOffset = level.offset + getRowsSize(level, dispatchedRows);
+		const void* pixels = nullptr;
+		if (region.id) {
+			pixels = reinterpret_cast<const void*>(region.offset + bandOffset);
+		}
+		else {
+			pixels = data.data() + bandOffset;
+		}
+
+		// Buffer band to texture
+		if (compressed) {
+			glCompressedTexSubImage2D(GL_TEXTURE_2D, level.level - baseLevel, 0, dispatchedRows, level.width, rows, internalFormat, static_cast<GLsizei>(bandSize), pixels);
+		}
+		else {
+			glTexSubImage2D(GL_TEXTURE_2D, level.level - baseLevel, 0, dispatchedRows, level.width, rows, format, GL_UNSIGNED_BYTE, pixels);
+		}
+		chunkSize += bandSize;
+
+		// Continue with next level once current level is complete
+		dispatchedRows += rows;
+		if (dispatchedRows >= level.height) {
+			dispatchedLevels++;
+			dispatchedRows = 0;
+		}
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	if (region.id) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	// Texture incomplete, continue with next chunk
+	if (dispatchedLevels < levels.size()) {
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return false;
+	}
+
+	// Undbind texture
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// Upload ring region may be reused once the gpu finished reading from it
+	UploadRing::release(region);
+	region = UploadRing::Region();
+
+	// Texture complete, use it from now on replacing the previously resident levels
+	if (_id != defaultTextureId) glDeleteTextures(1, &_id);
+	_id = pendingId;
+	pendingId = 0;
+	residentLevel = baseLevel;
+	dispatchedLevels = 0;
+	dispatchedRows = 0;
+
+	// Stream finer levels of streamed textures on demand
+	if (streamed) {
+		TextureStreaming::add(this);
+	}
+	else {
+		TextureStreaming::remove(this);
+	}
+
+	return true;
+}
+
+size_t Texture::getChunkSize()
+{
+	if (!hasData()) return 0;
+
+	// Sum up bands the next chunk uploads
+	size_t chunkSize = 0;
+	uint32_t level = dispatchedLevels;
+	uint32_t rows = dispatchedRows;
+	while (level < levels.size() && chunkSize < CHUNK_BYTES) {
+		uint32_t bandRows = std::min(getBandRows(levels[level], CHUNK_BYTES - chunkSize), levels[level].height - rows);
+		chunkSize += getRowsSize(levels[level], bandRows);
+		rows += bandRows;
+		if (rows >= levels[level].height) {
+			level++;
+			rows = 0;
+		}
+	}
+	return chunkSize;
+}
+
+TextureCompression::BlockFormat Texture::getBlockFormat(TextureType type)
+{
+	switch (type)
+	{
+	case TextureType::ALBEDO:
+		return TextureCompression::BlockFormat::BC7_SRGB;
+	case TextureType::ROUGHNESS:
+	case TextureType::METALLIC:
+	case TextureType::OCCLUSION:
+	case TextureType::HEIGHT:
+		return TextureCompression::BlockFormat::BC4;
+	case TextureType::NORMAL:
+		return TextureCompression::BlockFormat::BC5;
+	case TextureType::EMISSIVE:
+		return TextureCompression::BlockFormat::BC1;
+	default:
+		// Images (e.g. editor icons) stay uncompressed
+		return TextureCompression::BlockFormat::NONE;
+	}
+}
+
+bool Texture::loadCache(const std::string& cachePath, bool streaming)
+{
+	// Map and validate cache
+	MappedFile cache;
+	if (!cache.open(cachePath)) return false;
+
+	TextureCompression::BlockFormat blockFormat = getBlockFormat(type);
+	std::vector<TextureCache::Level> cachedLevels;
+	if (!TextureCache::read(cache, sourceHash, blockFormat, cachedLevels)) return false;
+
+	// Validate mip chain
+	if (cachedLevels.size() != MipGenerator::getLevelCount(cachedLevels[0].width, cachedLevels[0].height)) return false;
+	for (uint32_t i = 0; i < cachedLevels.size(); i++) {
+		if (cachedLevels[i].width != std::max(cachedLevels[0].width >> i, 1u)) return false;
+		if (cachedLevels[i].height != std::max(cachedLevels[0].height >> i, 1u)) return false;
+	}
+
+	// Streamed levels have to continue the resident mip chain
+	if (streaming && (cachedLevels[0].width != width || cachedLevels[0].height != height)) return false;
+
+	// Sync loaded data
+	width = cachedLevels[0].width;
+	height = cachedLevels[0].height;
+	channels = 4;
+	compression = blockFormat;
+	levelCount = static_cast<uint32_t>(cachedLevels.size());
+
+	// Lay out levels relative to the first level (levels are stored consecutively)
+	const uint8_t* first = cachedLevels.front().data;
+	levels.clear();
+	for (uint32_t i = 0; i < levelCount; i++) {
+		levels.push_back(LevelData{ i, cachedLevels[i].width, cachedLevels[i].height, static_cast<size_t>(cachedLevels[i].data - first), cachedLevels[i].size });
+	}
+
+	// Keep the missing levels when streaming, the pinned levels on initial loads
+	if (streaming) {
+		storeLevels(first, targetLevel, residentLevel);
+	}
+	else {
+		streamed = true;
+		storeLevels(first, getPinnedLevel(), levelCount);
+	}
+
+	return true;
+}
+
+void Texture::cook(const std::vector<uint8_t>& mipChain, const std::string& cachePath)
+{
+	TextureCompression::BlockFormat blockFormat = getBlockFormat(type);
+
+	// Encode each level of the mip chain
+	std::vector<uint8_t> cooked;
+	std::vector<LevelData> cookedLevels;
+	for (const LevelData& level : levels) {
+		size_t size = TextureCompression::getImageSize(blockFormat, level.width, level.height);
+		cookedLevels.push_back(LevelData{ level.level, level.width, level.height, cooked.size(), size });
+		cooked.resize(cooked.size() + size);
+		TextureCompression::encode(blockFormat, mipChain.data() + level.offset, level.width, level.height, cooked.data() + cookedLevels.back().offset);
+	}
+	levels = std::move(cookedLevels);
+	compression = blockFormat;
+
+	// Write texture cache for the next load
+	if (sourceHash) {
+		std::vector<TextureCache::Level> cachedLevels;
+		for (const LevelData& levelData : levels) {
+			TextureCache::Level cachedLevel;
+			cachedLevel.width = levelData.width;
+			cachedLevel.height = levelData.height;
+			cachedLevel.data = cooked.data() + levelData.offset;
+			cachedLevel.size = levelData.size;
+			cachedLevels.push_back(cachedLevel);
+		}
+		streamed = TextureCache::write(cachePath, sourceHash, blockFormat, cachedLevels);
+		if (!streamed) {
+			Console::out::warning("Texture", "Couldn't write texture cache for texture '" + IOHandler::getFilename(path) + "'");
+		}
+	}
+
+	// Keep pinned levels only if the finer levels can be streamed from the texture cache
+	storeLevels(cooked.data(), streamed ? getPinnedLevel() : 0, levelCount);
+}
+
+std::vector<uint8_t> Texture::generateMipChain(const uint8_t* pixels)
+{
+	// Get encoding of texture channels
+	MipGenerator::Encoding encoding = MipGenerator::Encoding::LINEAR;
+	if (type == TextureType::ALBEDO) encoding = MipGenerator::Encoding::SRGB;
+	if (type == TextureType::NORMAL) encoding = MipGenerator::Encoding::NORMAL;
+
+	// Lay out levels consecutively
+	levelCount = MipGenerator::getLevelCount(width, height);
+	uint32_t levelWidth = width;
+	uint32_t levelHeight = height;
+	size_t size = 0;
+	levels.clear();
+	for (uint32_t i = 0; i < levelCount; i++) {
+		size_t levelSize = static_cast<size_t>(levelWidth) * levelHeight * channels;
+		levels.push_back(LevelData{ i, levelWidth, levelHeight, size, levelSize });
+		size += levelSize;
+		levelWidth = MipGenerator::getNextDimension(levelWidth);
+		levelHeight = MipGenerator::getNextDimension(levelHeight);
+	}
+
+	// Copy base level and downsample each further level from the previous one
+	std::vector<uint8_t> mipChain(size);
+	std::copy(pixels, pixels + levels[0].size, mipChain.begin());
+	for (uint32_t i = 1; i < levelCount; i++) {
+		const LevelData& previous = levels[i - 1];
+		MipGenerator::downsample(mipChain.data() + previous.offset, previous.width, previous.height, channels, encoding, mipChain.data() + levels[i].offset);
+	}
+
+	return mipChain;
+}
+
+void Texture::storeLevels(const uint8_t* bytes, uint32_t first, uint32_t end)
+{
+	// Keep given range of levels, relative to the first level kept
+	size_t begin = levels[first].offset;
+	size_t size = levels[end - 1].offset + levels[end - 1].size - begin;
+	levels = std::vector<LevelData>(levels.begin() + first, levels.begin() + end);
+	for (LevelData& level : levels) {
+		level.offset -= begin;
+	}
+
+	storeData(bytes + begin, size);
+}
 
+void Texture::storeData(const uint8_t* bytes, size_t size)
+{
+	// Write data to the upload ring so it's dispatched straight from gpu visible memory, keep it in memory if it doesn't fit
+	region = UploadRing::write(bytes, size);
+	if (!region.id) data.assign(bytes, bytes + size);
+}
+
+void Texture::getBackendFormats(uint32_t& internalFormat, uint32_t& format) const
+{
 	// Get texture backend format from texture type
-	GLenum internalFormat = GL_SRGB;
-	GLenum format = GL_RGB;
+	internalFormat = GL_SRGB8;
+	format = GL_RGB;
 	switch (type)
 	{
 	case TextureType::ALBEDO:
-		internalFormat = GL_SRGB;
+		internalFormat = GL_SRGB8;
 		format = GL_RGB;
 		break;
 	case TextureType::ROUGHNESS:
-		internalFormat = GL_RED;
+		internalFormat = GL_R8;
 		format = GL_RED;
 		break;
 	case TextureType::METALLIC:
-		internalFormat = GL_RED;
+		internalFormat = GL_R8;
 		format = GL_RED;
 		break;
 	case TextureType::NORMAL:
-		internalFormat = GL_RGB;
+		internalFormat = GL_RGB8;
 		format = GL_RGB;
 		break;
 	case TextureType::OCCLUSION:
-		internalFormat = GL_RED;
+		internalFormat = GL_R8;
 		format = GL_RED;
 		break;
 	case TextureType::EMISSIVE:
-		internalFormat = GL_RGB;
+		internalFormat = GL_RGB8;
 		format = GL_RGB;
 		break;
 	case TextureType::HEIGHT:
-		internalFormat = GL_RED;
+		internalFormat = GL_R8;
 		format = GL_RED;
 		break;
 	case TextureType::IMAGE_RGB:
-		internalFormat = GL_RGB;
+		internalFormat = GL_RGB8;
 		format = GL_RGB;
 		break;
 	case TextureType::IMAGE_RGBA:
-		internalFormat = GL_RGBA;
+		internalFormat = GL_RGBA8;
 		format = GL_RGBA;
 		break;
 	}
 
-	// Buffer image data to texture
-	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+	// Block compressed data overrides the internal format
+	if (compression != TextureCompression::BlockFormat::NONE) internalFormat = TextureCompression::getInternalFormat(compression);
+}
 
-	// Generate textures mipmap
-	glGenerateMipmap(GL_TEXTURE_2D);
+uint32_t Texture::createStorage(uint32_t baseLevel) const
+{
+	uint32_t internalFormat = 0;
+	uint32_t format = 0;
+	getBackendFormats(internalFormat, format);
 
-	// Undbind texture
-	glBindTexture(GL_TEXTURE_2D, 0);
-}
\ No newline at end of file
+	uint32_t id = 0;
+	glGenTextures(1, &id);
+	glBindTexture(GL_TEXTURE_2D, id);
+
+	// Set texture parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	// Anisotropic filtering
+	GLfloat maxAniso = 0.0f;
+	glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &maxAniso);
+	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY, maxAniso);
+
+	// Allocate storage for the levels from the base level on
+	glTexStorage2D(GL_TEXTURE_2D, static_cast<GLsizei>(levelCount - baseLevel), internalFormat, std::max(width >> baseLevel, 1u), std::max(height >> baseLevel, 1u));
+
+	return id;
+}
+
+void Texture::copyLevels(uint32_t source, uint32_t sourceBase, uint32_t destination, uint32_t destinationBase, uint32_t first) const
+{
+	for (uint32_t level = first; level < levelCount; level++) {
+		GLsizei levelWidth = std::max(width >> level, 1u);
+		GLsizei levelHeight = std::max(height >> level, 1u);
+		glCopyImageSubData(source, GL_TEXTURE_2D, level - sourceBase, 0, 0, 0, destination, GL_TEXTURE_2D, level - destinationBase, 0, 0, 0, levelWidth, levelHeight, 1);
+	}
+}
+
+bool Texture::hasData() const
+{
+	return !levels.empty() && (region.id || !data.empty());
+}
+
+size_t Texture::getRowsSize(const LevelData& level, uint32_t rows) const
+{
+	if (compression != TextureCompression::BlockFormat::NONE) {
+		size_t blocksX = (level.width + 3) / 4;
+		size_t blocksY = (rows + 3) / 4;
+		return blocksX * blocksY * TextureCompression::getBlockSize(compression);
+	}
+	return static_cast<size_t>(rows) * level.width * channels;
+}
+
+uint32_t Texture::getBandRows(const LevelData& level, size_t bytes) const
+{
+	// Rows of block compressed levels are uploaded in whole blocks
+	uint32_t blockRows = compression != TextureCompression::BlockFormat::NONE ? 4 : 1;
+	size_t blockRowSize = std::max(getRowsSize(level, blockRows), static_cast<size_t>(1));
+	return static_cast<uint32_t>(std::max(bytes / blockRowSize, static_cast<size_t>(1))) * blockRows;
+}
@@ -2,8 +2,12 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "../src/core/resource/resource.h"
+#include "../src/core/resource/resource_loader.h"
+#include "../src/core/rendering/texture/upload_ring.h"
+#include "../src/core/rendering/texture/texture_compression.h"
 
 enum class TextureType
 {
@@ -25,6 +29,7 @@ class Texture : public Resource
 {
 public:
 	Texture();
+	~Texture();
 
 	// Sets the textures type and path of texture source
 	void setSource(TextureType type, const std::string& path);
@@ -37,12 +42,63 @@ public:
 
 	std::string sourcePath() override;
 
+	//
+	// STREAMING
+	// Streamed textures keep their pinned levels resident, finer levels are streamed from the texture cache on demand
+	//
+
+	// Returns if finer levels of the texture are streamed in on demand
+	bool isStreamed() const;
+
+	// Returns the amount of levels of the textures full mip chain
+	uint32_t getLevelCount() const;
+
+	// Returns the finest resident level
+	uint32_t getResidentLevel() const;
+
+	// Returns the finest of the levels always kept resident
+	uint32_t getPinnedLevel() const;
+
+	// Returns the finest level needed to sample the texture at the given amount of uv units per screen pixel
+	uint32_t getRequiredLevel(float uvPerPixel) const;
+
+	// Returns the size of the given level in video memory
+	size_t getLevelSize(uint32_t level) const;
+
+	// Queues streaming in the levels finer than the resident levels down to the given level (on main thread)
+	void streamIn(uint32_t level, ResourcePriority priority);
+
+	// Evicts the resident levels finer than the given level (on main thread)
+	void evict(uint32_t level);
+
 protected:
 	void loadData() override;
 	void releaseData() override;
 	void dispatchGPU() override;
+	bool dispatchChunk() override;
+	size_t getChunkSize() override;
 
 private:
+	// Single mip level of loaded texture data
+	struct LevelData
+	{
+		// Index of the level within the full mip chain
+		uint32_t level = 0;
+
+		uint32_t width = 0;
+		uint32_t height = 0;
+
+		// Range of the levels data within the loaded data
+		size_t offset = 0;
+		size_t size = 0;
+	};
+
+	// Maximum amount of bytes uploaded per dispatch chunk, larger levels are uploaded in bands of rows across multiple chunks
+	static constexpr size_t CHUNK_BYTES = 4 * 1024 * 1024;
+
+	// Maximum dimension of the levels kept resident by streamed textures
+	static constexpr uint32_t PINNED_DIMENSION = 64;
+
 	// Default texture fallback
 	static uint32_t defaultTextureId;
 
@@ -52,13 +108,81 @@ private:
 	// Path of texture source
 	std::string path;
 
-	// Dynamic temporary texture data
-	unsigned char* data;
+	// Block compressed format of the loaded data (NONE if uncompressed)
+	TextureCompression::BlockFormat compression;
+
+	// Loaded levels of the mip chain
+	std::vector<LevelData> levels;
+
+	// Loaded data of all levels (empty if the data was written to the upload ring)
+	std::vector<uint8_t> data;
+
+	// Region of the upload ring holding the loaded data (invalid if the data is held in memory)
+	UploadRing::Region region;
 
 	uint32_t width;
 	uint32_t height;
 	uint32_t channels;
 
+	// Amount of levels of the full mip chain
+	uint32_t levelCount;
+
+	// Set if finer levels are streamed from the texture cache
+	bool streamed;
+
+	// Hash of the source the texture cache was validated against
+	uint64_t sourceHash;
+
+	// Finest level the backend texture holds
+	uint32_t residentLevel;
+
+	// Finest level the next load streams in
+	uint32_t targetLevel;
+
+	// Amount of levels and rows of the current level uploaded by previous dispatch chunks
+	uint32_t dispatchedLevels;
+	uint32_t dispatchedRows;
+
+	// Backend id of the texture being dispatched, becomes the textures backend id once complete
+	uint32_t pendingId;
+
 	// Backend id of texture
 	uint32_t _id;
+
+	// Returns the block compressed format textures of the given type are cooked to (NONE if kept uncompressed)
+	static TextureCompression::BlockFormat getBlockFormat(TextureType type);
+
+	// Loads the cooked texture if the texture cache is up to date, returns if the cache could be loaded
+	// Streaming loads only the levels between the target level and the resident levels, initial loads the pinned levels
+	bool loadCache(const std::string& cachePath, bool streaming);
+
+	// Generates the full mip chain of the given image, laying out the uncompressed levels
+	std::vector<uint8_t> generateMipChain(const uint8_t* pixels);
+
+	// Block compresses the given rgba mip chain and writes the texture cache if there is a source hash, the texture is streamed if the cache could be written
+	void cook(const std::vector<uint8_t>& mipChain, const std::string& cachePath);
+
+	// Keeps the given range of the consecutively laid out levels for dispatching
+	void storeLevels(const uint8_t* bytes, uint32_t first, uint32_t end);
+
+	// Keeps the given loaded data for dispatching, preferably within the upload ring
+	void storeData(const uint8_t* bytes, size_t size);
+
+	// Returns the backend internal format and pixel format of the textures data
+	void getBackendFormats(uint32_t& internalFormat, uint32_t& format) const;
+
+	// Creates a backend texture with immutable storage for the levels from the given base level on, leaving it bound
+	uint32_t createStorage(uint32_t baseLevel) const;
+
+	// Copies the levels from the given level on between backend textures holding levels from the given base levels on
+	void copyLevels(uint32_t source, uint32_t sourceBase, uint32_t destination, uint32_t destinationBase, uint32_t first) const;
+
+	// Returns if there is loaded texture data left to dispatch
+	bool hasData() const;
+
+	// Returns the size of the given amount of rows of a level in bytes (rows of block compressed levels are rounded up to whole blocks)
+	size_t getRowsSize(const LevelData& level, uint32_t rows) const;
+
+	// Returns the amount of rows of a level uploaded within the given amount of bytes, at least a single row of blocks
+	uint32_t getBandRows(const LevelData& level, size_t bytes) const;
 };
\ No newline at end of file
@@ -0,0 +1,676 @@
+#include "texture_compression.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <glad/glad.h>
+
+namespace TextureCompression {
+
+	// S3TC isn't part of core opengl but supported by every desktop driver (EXT_texture_compression_s3tc)
+	constexpr uint32_t COMPRESSED_RGB_S3TC_DXT1 = 0x83F0;
+
+	// Interpolation weights of 4-bit BC7 indices in 1/64 steps
+	constexpr uint32_t BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// Amount of least squares endpoint refinements per block
+	constexpr uint32_t REFINEMENT_PASSES = 2;
+
+	// Amount of power iterations approximating the principal axis of a block
+	constexpr uint32_t POWER_ITERATIONS = 8;
+
+	// Pixels of a single 4x4 block
+	using BlockPixels = float[16][4];
+
+	// Pixels of a single decoded 4x4 block
+	using DecodedPixels = uint8_t[16][4];
+
+	//
+	// BLOCK HELPERS
+	//
+
+	// Reads the block at the given block coordinates, replicating edge pixels of partial blocks
+	void _readBlock(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, BlockPixels& block)
+	{
+		for (uint32_t y = 0; y < 4; y++) {
+			uint32_t pixelY = std::min(blockY * 4 + y, height - 1);
+			for (uint32_t x = 0; x < 4; x++) {
+				uint32_t pixelX = std::min(blockX * 4 + x, width - 1);
+				const uint8_t* pixel = pixels + (static_cast<size_t>(pixelY) * width + pixelX) * 4;
+				for (uint32_t c = 0; c < 4; c++) block[y * 4 + x][c] = pixel[c];
+			}
+		}
+	}
+
+	// Writes the decoded block at the given block coordinates, skipping pixels outside of the image
+	void _writeBlock(const DecodedPixels& block, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t* pixels)
+	{
+		for (uint32_t y = 0; y < 4 && blockY * 4 + y < height; y++) {
+			for (uint32_t x = 0; x < 4 && blockX * 4 + x < width; x++) {
+				uint8_t* pixel = pixels + (static_cast<size_t>(blockY * 4 + y) * width + blockX * 4 + x) * 4;
+				std::memcpy(pixel, block[y * 4 + x], 4);
+			}
+		}
+	}
+
+	// Writes the given amount of bits of value at the given bit position of a zeroed block, advancing the position
+	void _writeBits(uint8_t* block, uint32_t& position, uint32_t count, uint32_t value)
+	{
+		for (uint32_t i = 0; i < count; i++, position++) {
+			if ((value >> i) & 1) block[position >> 3] |= static_cast<uint8_t>(1 << (position & 7));
+		}
+	}
+
+	// Returns the given amount of bits at the given bit position of a block, advancing the position
+	uint32_t _readBits(const uint8_t* block, uint32_t& position, uint32_t count)
+	{
+		uint32_t value = 0;
+		for (uint32_t i = 0; i < count; i++, position++) {
+			value |= ((block[position >> 3] >> (position & 7)) & 1) << i;
+		}
+		return value;
+	}
+
+	// Returns the squared error between the first given amount of channels of two colors
+	float _error(const float* a, const float* b, uint32_t channels)
+	{
+		float error = 0.0f;
+		for (uint32_t c = 0; c < channels; c++) {
+			float difference = a[c] - b[c];
+			error += difference * difference;
+		}
+		return error;
+	}
+
+	// Selects the closest palette entry for each pixel of the block, returns the total error
+	float _selectIndices(const BlockPixels& block, const float(*palette)[4], uint32_t paletteSize, uint32_t channels, uint8_t* indices)
+	{
+		float total = 0.0f;
+		for (uint32_t i = 0; i < 16; i++) {
+			float best = _error(block[i], palette[0], channels);
+			indices[i] = 0;
+			for (uint32_t j = 1; j < paletteSize; j++) {
+				float error = _error(block[i], palette[j], channels);
+				if (error < best) {
+					best = error;
+					indices[i] = static_cast<uint8_t>(j);
+				}
+			}
+			total += best;
+		}
+		return total;
+	}
+
+	//
+	// ENDPOINT FITTING
+	//
+
+	// Sets the given endpoints to the extremes of the block along its principal axis
+	void _fitPrincipalAxis(const BlockPixels& block, uint32_t channels, float* start, float* end)
+	{
+		// Mean and covariance of block
+		float mean[4] = {};
+		for (uint32_t i = 0; i < 16; i++) {
+			for (uint32_t c = 0; c < channels; c++) mean[c] += block[i][c] / 16.0f;
+		}
+
+		float covariance[4][4] = {};
+		for (uint32_t i = 0; i < 16; i++) {
+			for (uint32_t a = 0; a < channels; a++) {
+				for (uint32_t b = 0; b < channels; b++) covariance[a][b] += (block[i][a] - mean[a]) * (block[i][b] - mean[b]);
+			}
+		}
+
+		// Approximate principal axis by power iteration
+		float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		for (uint32_t iteration = 0; iteration < POWER_ITERATIONS; iteration++) {
+			float next[4] = {};
+			float largest = 0.0f;
+			for (uint32_t a = 0; a < channels; a++) {
+				for (uint32_t b = 0; b < channels; b++) next[a] += covariance[a][b] * axis[b];
+				largest = std::max(largest, std::abs(next[a]));
+			}
+
+			// Uniform block, collapse endpoints to mean
+			if (largest <= 0.0f) {
+				std::memcpy(start, mean, sizeof(float) * channels);
+				std::memcpy(end, mean, sizeof(float) * channels);
+				return;
+			}
+
+			for (uint32_t a = 0; a < channels; a++) axis[a] = next[a] / largest;
+		}
+
+		// Project block onto axis
+		float length = 0.0f;
+		for (uint32_t c = 0; c < channels; c++) length += axis[c] * axis[c];
+		float minProjection = 0.0f;
+		float maxProjection = 0.0f;
+		for (uint32_t i = 0; i < 16; i++) {
+			float projection = 0.0f;
+			for (uint32_t c = 0; c < channels; c++) projection += (block[i][c] - mean[c]) * axis[c];
+			projection /= length;
+			minProjection = std::min(minProjection, projection);
+			maxProjection = std::max(maxProjection, projection);
+		}
+
+		for (uint32_t c = 0; c < channels; c++) {
+			start[c] = std::clamp(mean[c] + axis[c] * minProjection, 0.0f, 255.0f);
+			end[c] = std::clamp(mean[c] + axis[c] * maxProjection, 0.0f, 255.0f);
+		}
+	}
+
+	// Fits the given endpoints to the block in the least squares sense given each pixels interpolation weight, returns false if the fit is degenerate
+	bool _fitLeastSquares(const BlockPixels& block, const float* weights, uint32_t channels, float* start, float* end)
+	{
+		float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+		float ax[4] = {}, bx[4] = {};
+		for (uint32_t i = 0; i < 16; i++) {
+			float a = 1.0f - weights[i];
+			float b = weights[i];
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+			for (uint32_t c = 0; c < channels; c++) {
+				ax[c] += a * block[i][c];
+				bx[c] += b * block[i][c];
+			}
+		}
+
+		float determinant = aa * bb - ab * ab;
+		if (std::abs(determinant) < 1e-6f) return false;
+
+		for (uint32_t c = 0; c < channels; c++) {
+			start[c] = std::clamp((bb * ax[c] - ab * bx[c]) / determinant, 0.0f, 255.0f);
+			end[c] = std::clamp((aa * bx[c] - ab * ax[c]) / determinant, 0.0f, 255.0f);
+		}
+		return true;
+	}
+
+	//
+	// BC1
+	//
+
+	uint16_t _pack565(const float* color)
+	{
+		uint32_t r = static_cast<uint32_t>(std::round(color[0] * 31.0f / 255.0f));
+		uint32_t g = static_cast<uint32_t>(std::round(color[1] * 63.0f / 255.0f));
+		uint32_t b = static_cast<uint32_t>(std::round(color[2] * 31.0f / 255.0f));
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	// Returns the amount of palette entries of the given endpoints, filling the palette
+	uint32_t _paletteBC1(uint16_t color0, uint16_t color1, float(*palette)[4])
+	{
+		for (uint32_t i = 0; i < 2; i++) {
+			uint16_t color = i == 0 ? color0 : color1;
+			uint32_t r = color >> 11, g = (color >> 5) & 63, b = color & 31;
+			palette[i][0] = static_cast<float>((r << 3) | (r >> 2));
+			palette[i][1] = static_cast<float>((g << 2) | (g >> 4));
+			palette[i][2] = static_cast<float>((b << 3) | (b >> 2));
+			palette[i][3] = 255.0f;
+		}
+
+		// Three color mode, last entry is transparent black
+		if (color0 <= color1) {
+			for (uint32_t c = 0; c < 3; c++) palette[2][c] = std::floor((palette[0][c] + palette[1][c]) / 2.0f);
+			palette[2][3] = 255.0f;
+			palette[3][0] = palette[3][1] = palette[3][2] = palette[3][3] = 0.0f;
+			return 3;
+		}
+
+		// Four color mode
+		for (uint32_t c = 0; c < 3; c++) {
+			palette[2][c] = std::floor((2.0f * palette[0][c] + palette[1][c]) / 3.0f);
+			palette[3][c] = std::floor((palette[0][c] + 2.0f * palette[1][c]) / 3.0f);
+		}
+		palette[2][3] = palette[3][3] = 255.0f;
+		return 4;
+	}
+
+	void _encodeBC1(const BlockPixels& block, uint8_t* output)
+	{
+		// Interpolation weight towards the second endpoint of each four color mode index
+		constexpr float WEIGHTS[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+		float start[4], end[4];
+		_fitPrincipalAxis(block, 3, start, end);
+
+		uint16_t bestColors[2] = { 0, 0 };
+		uint8_t bestIndices[16] = {};
+		float bestError = INFINITY;
+		for (uint32_t pass = 0; pass <= REFINEMENT_PASSES; pass++) {
+			// Four color mode requires the first endpoint to be larger
+			uint16_t color0 = _pack565(start);
+			uint16_t color1 = _pack565(end);
+			if (color0 < color1) {
+				std::swap(color0, color1);
+				std::swap(start, end);
+			}
+
+			// Select indices (equal endpoints fall into three color mode, where only the first entry is used)
+			float palette[4][4];
+			uint32_t paletteSize = _paletteBC1(color0, color1, palette);
+			uint8_t indices[16];
+			float error = _selectIndices(block, palette, paletteSize == 4 ? 4 : 1, 3, indices);
+			if (error < bestError) {
+				bestError = error;
+				bestColors[0] = color0;
+				bestColors[1] = color1;
+				std::memcpy(bestIndices, indices, 16);
+			}
+
+			// Refine endpoints
+			float weights[16];
+			for (uint32_t i = 0; i < 16; i++) weights[i] = WEIGHTS[indices[i]];
+			if (paletteSize != 4 || !_fitLeastSquares(block, weights, 3, start, end)) break;
+		}
+
+		uint32_t indexBits = 0;
+		for (uint32_t i = 0; i < 16; i++) indexBits |= bestIndices[i] << (i * 2);
+
+		std::memcpy(output, bestColors, 4);
+		std::memcpy(output + 4, &indexBits, 4);
+	}
+
+	void _decodeBC1(const uint8_t* input, DecodedPixels& block)
+	{
+		uint16_t colors[2];
+		uint32_t indexBits;
+		std::memcpy(colors, input, 4);
+		std::memcpy(&indexBits, input + 4, 4);
+
+		float palette[4][4];
+		_paletteBC1(colors[0], colors[1], palette);
+		for (uint32_t i = 0; i < 16; i++) {
+			uint32_t index = (indexBits >> (i * 2)) & 3;
+			for (uint32_t c = 0; c < 3; c++) block[i][c] = static_cast<uint8_t>(palette[index][c]);
+		}
+	}
+
+	//
+	// BC4
+	//
+
+	void _paletteBC4(uint8_t value0, uint8_t value1, float* palette)
+	{
+		palette[0] = value0;
+		palette[1] = value1;
+
+		// Eight value mode
+		if (value0 > value1) {
+			for (uint32_t i = 2; i < 8; i++) palette[i] = std::floor(((8 - i) * value0 + (i - 1) * value1 + 3) / 7.0f);
+			return;
+		}
+
+		// Six value mode with explicit extremes
+		for (uint32_t i = 2; i < 6; i++) palette[i] = std::floor(((6 - i) * value0 + (i - 1) * value1 + 2) / 5.0f);
+		palette[6] = 0.0f;
+		palette[7] = 255.0f;
+	}
+
+	void _encodeBC4(const BlockPixels& block, uint32_t channel, uint8_t* output)
+	{
+		// Endpoints at the channels extremes
+		float minValue = 255.0f;
+		float maxValue = 0.0f;
+		for (uint32_t i = 0; i < 16; i++) {
+			minValue = std::min(minValue, block[i][channel]);
+			maxValue = std::max(maxValue, block[i][channel]);
+		}
+		uint8_t value0 = static_cast<uint8_t>(std::round(maxValue));
+		uint8_t value1 = static_cast<uint8_t>(std::round(minValue));
+
+		// Select indices
+		float palette[8];
+		_paletteBC4(value0, value1, palette);
+		uint64_t indexBits = 0;
+		for (uint32_t i = 0; i < 16 && value0 != value1; i++) {
+			uint64_t bestIndex = 0;
+			float bestError = INFINITY;
+			for (uint32_t j = 0; j < 8; j++) {
+				float error = std::abs(block[i][channel] - palette[j]);
+				if (error < bestError) {
+					bestError = error;
+					bestIndex = j;
+				}
+			}
+			indexBits |= bestIndex << (i * 3);
+		}
+
+		output[0] = value0;
+		output[1] = value1;
+		for (uint32_t i = 0; i < 6; i++) output[2 + i] = static_cast<uint8_t>(indexBits >> (i * 8));
+	}
+
+	void _decodeBC4(const uint8_t* input, uint32_t channel, DecodedPixels& block)
+	{
+		float palette[8];
+		_paletteBC4(input[0], input[1], palette);
+
+		uint64_t indexBits = 0;
+		for (uint32_t i = 0; i < 6; i++) indexBits |= static_cast<uint64_t>(input[2 + i]) << (i * 8);
+		for (uint32_t i = 0; i < 16; i++) block[i][channel] = static_cast<uint8_t>(palette[(indexBits >> (i * 3)) & 7]);
+	}
+
+	//
+	// BC7 (MODE 6)
+	//
+
+	// Quantizes the given endpoint to 7 bits per channel with a shared lowest bit, choosing the closer lowest bit
+	void _quantizeBC7(const float* endpoint, uint32_t* quantized, uint32_t& pBit)
+	{
+		float bestError = INFINITY;
+		for (uint32_t p = 0; p < 2; p++) {
+			uint32_t candidate[4];
+			float error = 0.0f;
+			for (uint32_t c = 0; c < 4; c++) {
+				candidate[c] = static_cast<uint32_t>(std::clamp(std::round((endpoint[c] - p) / 2.0f), 0.0f, 127.0f));
+				float difference = static_cast<float>((candidate[c] << 1) | p) - endpoint[c];
+				error += difference * difference;
+			}
+			if (error < bestError) {
+				bestError = error;
+				pBit = p;
+				std::memcpy(quantized, candidate, sizeof(candidate));
+			}
+		}
+	}
+
+	void _paletteBC7(const uint32_t* quantized0, uint32_t pBit0, const uint32_t* quantized1, uint32_t pBit1, float(*palette)[4])
+	{
+		for (uint32_t c = 0; c < 4; c++) {
+			uint32_t value0 = (quantized0[c] << 1) | pBit0;
+			uint32_t value1 = (quantized1[c] << 1) | pBit1;
+			for (uint32_t i = 0; i < 16; i++) palette[i][c] = static_cast<float>(((64 - BC7_WEIGHTS[i]) * value0 + BC7_WEIGHTS[i] * value1 + 32) >> 6);
+		}
+	}
+
+	void _encodeBC7(const BlockPixels& block, uint8_t* output)
+	{
+		float start[4], end[4];
+		_fitPrincipalAxis(block, 4, start, end);
+
+		uint32_t bestQuantized[2][4] = {};
+		uint32_t bestPBits[2] = {};
+		uint8_t bestIndices[16] = {};
+		float bestError = INFINITY;
+		for (uint32_t pass = 0; pass <= REFINEMENT_PASSES; pass++) {
+			uint32_t quantized[2][4];
+			uint32_t pBits[2];
+			_quantizeBC7(start, quantized[0], pBits[0]);
+			_quantizeBC7(end, quantized[1], pBits[1]);
+
+			// Select indices
+			float palette[16][4];
+			_paletteBC7(quantized[0], pBits[0], quantized[1], pBits[1], palette);
+			uint8_t indices[16];
+			float error = _selectIndices(block, palette, 16, 4, indices);
+			if (error < bestError) {
+				bestError = error;
+				std::memcpy(bestQuantized, quantized, sizeof(quantized));
+				std::memcpy(bestPBits, pBits, sizeof(pBits));
+				std::memcpy(bestIndices, indices, 16);
+			}
+
+			// Refine endpoints
+			float weights[16];
+			for (uint32_t i = 0; i < 16; i++) weights[i] = BC7_WEIGHTS[indices[i]] / 64.0f;
+			if (!_fitLeastSquares(block, weights, 4, start, end)) break;
+		}
+
+		// Highest index bit of the first pixel is implicitly zero, swap endpoints if needed
+		if (bestIndices[0] & 8) {
+			std::swap(bestQuantized[0], bestQuantized[1]);
+			std::swap(bestPBits[0], bestPBits[1]);
+			for (uint32_t i = 0; i < 16; i++) bestIndices[i] = 15 - bestIndices[i];
+		}
+
+		// Pack block
+		std::memset(output, 0, 16);
+		uint32_t position = 0;
+		_writeBits(output, position, 7, 1 << 6);
+		for (uint32_t c = 0; c < 4; c++) {
+			_writeBits(output, position, 7, bestQuantized[0][c]);
+			_writeBits(output, position, 7, bestQuantized[1][c]);
+		}
+		_writeBits(output, position, 1, bestPBits[0]);
+		_writeBits(output, position, 1, bestPBits[1]);
+		for (uint32_t i = 0; i < 16; i++) _writeBits(output, position, i == 0 ? 3 : 4, bestIndices[i]);
+	}
+
+	void _decodeBC7(const uint8_t* input, DecodedPixels& block)
+	{
+		// Only mode 6 is decoded, other modes decode to transparent black
+		uint32_t position = 0;
+		if (_readBits(input, position, 7) != 1 << 6) {
+			std::memset(block, 0, sizeof(DecodedPixels));
+			return;
+		}
+
+		uint32_t quantized[2][4];
+		for (uint32_t c = 0; c < 4; c++) {
+			quantized[0][c] = _readBits(input, position, 7);
+			quantized[1][c] = _readBits(input, position, 7);
+		}
+		uint32_t pBit0 = _readBits(input, position, 1);
+		uint32_t pBit1 = _readBits(input, position, 1);
+
+		float palette[16][4];
+		_paletteBC7(quantized[0], pBit0, quantized[1], pBit1, palette);
+		for (uint32_t i = 0; i < 16; i++) {
+			uint32_t index = _readBits(input, position, i == 0 ? 3 : 4);
+			for (uint32_t c = 0; c < 4; c++) block[i][c] = static_cast<uint8_t>(palette[index][c]);
+		}
+	}
+
+	//
+	// IMAGES
+	//
+
+	uint32_t getBlockSize(BlockFormat format)
+	{
+		switch (format) {
+		case BlockFormat::BC1:
+		case BlockFormat::BC4:
+			return 8;
+		case BlockFormat::BC5:
+		case BlockFormat::BC7:
+		case BlockFormat::BC7_SRGB:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+	size_t getImageSize(BlockFormat format, uint32_t width, uint32_t height)
+	{
+		size_t blocksX = (width + 3) / 4;
+		size_t blocksY = (height + 3) / 4;
+		return blocksX * blocksY * getBlockSize(format);
+	}
+
+	uint32_t getInternalFormat(BlockFormat format)
+	{
+		switch (format) {
+		case BlockFormat::BC1:
+			return COMPRESSED_RGB_S3TC_DXT1;
+		case BlockFormat::BC4:
+			return GL_COMPRESSED_RED_RGTC1;
+		case BlockFormat::BC5:
+			return GL_COMPRESSED_RG_RGTC2;
+		case BlockFormat::BC7:
+			return GL_COMPRESSED_RGBA_BPTC_UNORM;
+		case BlockFormat::BC7_SRGB:
+			return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+		default:
+			return 0;
+		}
+	}
+
+	void encode(BlockFormat format, const uint8_t* pixels, uint32_t width, uint32_t height, uint8_t* blocks)
+	{
+		uint32_t blockSize = getBlockSize(format);
+		uint32_t blocksX = (width + 3) / 4;
+		uint32_t blocksY = (height + 3) / 4;
+		for (uint32_t blockY = 0; blockY < blocksY; blockY++) {
+			for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+				BlockPixels block;
+				_readBlock(pixels, width, height, blockX, blockY, block);
+				uint8_t* output = blocks + (static_cast<size_t>(blockY) * blocksX + blockX) * blockSize;
+
+				switch (format) {
+				case BlockFormat::BC1:
+					_encodeBC1(block, output);
+					break;
+				case BlockFormat::BC4:
+					_encodeBC4(block, 0, output);
+					break;
+				case BlockFormat::BC5:
+					_encodeBC4(block, 0, output);
+					_encodeBC4(block, 1, output + 8);
+					break;
+				case BlockFormat::BC7:
+				case BlockFormat::BC7_SRGB:
+					_encodeBC7(block, output);
+					break;
+				default:
+					break;
+				}
+			}
+		}
+	}
+
+	void decode(BlockFormat format, const uint8_t* blocks, uint32_t width, uint32_t height, uint8_t* pixels)
+	{
+		uint32_t blockSize = getBlockSize(format);
+		uint32_t blocksX = (width + 3) / 4;
+		uint32_t blocksY = (height + 3) / 4;
+		for (uint32_t blockY = 0; blockY < blocksY; blockY++) {
+			for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+				DecodedPixels block;
+				for (uint32_t i = 0; i < 16; i++) {
+					block[i][0] = block[i][1] = block[i][2] = 0;
+					block[i][3] = 255;
+				}
+				const uint8_t* input = blocks + (static_cast<size_t>(blockY) * blocksX + blockX) * blockSize;
+
+				switch (format) {
+				case BlockFormat::BC1:
+					_decodeBC1(input, block);
+					break;
+				case BlockFormat::BC4:
+					_decodeBC4(input, 0, block);
+					break;
+				case BlockFormat::BC5:
+					_decodeBC4(input, 0, block);
+					_decodeBC4(input + 8, 1, block);
+					break;
+				case BlockFormat::BC7:
+				case BlockFormat::BC7_SRGB:
+					_decodeBC7(input, block);
+					break;
+				default:
+					break;
+				}
+
+				_writeBlock(block, width, height, blockX, blockY, pixels);
+			}
+		}
+	}
+
+	//
+	// SELF TEST
+	//
+
+	// Maximum per channel error of a round trip through a format on gradient and on edge blocks
+	// Full range gradients may be off by half a palette step plus endpoint quantization, edges only by endpoint quantization
+	struct ErrorBound
+	{
+		BlockFormat format;
+		uint32_t channels;
+		int32_t gradient;
+		int32_t edge;
+	};
+
+	constexpr ErrorBound SELF_TEST_BOUNDS[] = {
+		{ BlockFormat::BC1, 3, 48, 8 },
+		{ BlockFormat::BC4, 1, 20, 1 },
+		{ BlockFormat::BC5, 2, 20, 1 },
+		{ BlockFormat::BC7, 4, 10, 2 }
+	};
+
+	// Fills a 4x4 rgba8 block, the gradient runs from color0 at the first pixel to color1 at the last pixel, the edge splits both colors along a diagonal
+	void _fillTestBlock(bool edge, const uint8_t* color0, const uint8_t* color1, uint8_t* pixels)
+	{
+		for (uint32_t i = 0; i < 16; i++) {
+			float t = edge ? ((i % 4) + (i / 4) > 3 ? 1.0f : 0.0f) : static_cast<float>(i) / 15.0f;
+			for (uint32_t c = 0; c < 4; c++) pixels[i * 4 + c] = static_cast<uint8_t>(std::round(color0[c] + (color1[c] - color0[c]) * t));
+		}
+	}
+
+	// Returns the largest error between the first given amount of channels of two 4x4 rgba8 blocks
+	int32_t _maxError(const uint8_t* a, const uint8_t* b, uint32_t channels)
+	{
+		int32_t error = 0;
+		for (uint32_t i = 0; i < 16; i++) {
+			for (uint32_t c = 0; c < channels; c++) error = std::max(error, std::abs(static_cast<int32_t>(a[i * 4 + c]) - static_cast<int32_t>(b[i * 4 + c])));
+		}
+		return error;
+	}
+
+	bool selfTest()
+	{
+		// Color pairs tested in both directions, the descending direction forces the bc7 anchor index swap
+		constexpr uint8_t COLORS[][4] = {
+			{ 12, 40, 200, 255 },
+			{ 230, 180, 30, 64 },
+			{ 0, 0, 0, 0 },
+			{ 255, 255, 255, 255 }
+		};
+		constexpr uint32_t N_COLORS = sizeof(COLORS) / sizeof(COLORS[0]);
+
+		uint8_t pixels[64];
+		uint8_t blocks[16];
+		uint8_t decoded[64];
+
+		// Round trip gradient and edge blocks of each color pair through each format
+		for (const ErrorBound& bound : SELF_TEST_BOUNDS) {
+			for (uint32_t first = 0; first < N_COLORS; first++) {
+				for (uint32_t second = 0; second < N_COLORS; second++) {
+					if (first == second) continue;
+					for (uint32_t edge = 0; edge < 2; edge++) {
+						_fillTestBlock(edge, COLORS[first], COLORS[second], pixels);
+						encode(bound.format, pixels, 4, 4, blocks);
+						decode(bound.format, blocks, 4, 4, decoded);
+						if (_maxError(pixels, decoded, bound.channels) > (edge ? bound.edge : bound.gradient)) return false;
+					}
+				}
+			}
+		}
+
+		// Bc7 blocks are mode 6 with an implicitly zero highest bit of the anchor index, even if the gradient starts at its brightest pixel
+		_fillTestBlock(false, COLORS[3], COLORS[0], pixels);
+		encode(BlockFormat::BC7, pixels, 4, 4, blocks);
+		if ((blocks[0] & 0x7F) != 1 << 6) return false;
+		decode(BlockFormat::BC7, blocks, 4, 4, decoded);
+		if (_maxError(pixels, decoded, 4) > SELF_TEST_BOUNDS[3].gradient) return false;
+
+		// Flat bc7 blocks decode exactly, odd values are only reachable through set p-bits
+		constexpr uint8_t ODD[4] = { 201, 77, 133, 255 };
+		constexpr uint8_t EVEN[4] = { 200, 76, 132, 254 };
+		for (const uint8_t* color : { ODD, EVEN }) {
+			_fillTestBlock(false, color, color, pixels);
+			encode(BlockFormat::BC7, pixels, 4, 4, blocks);
+			decode(BlockFormat::BC7, blocks, 4, 4, decoded);
+			if (_maxError(pixels, decoded, 4) != 0) return false;
+
+			uint32_t position = 63;
+			uint32_t expectedPBit = color == ODD ? 1 : 0;
+			if (_readBits(blocks, position, 1) != expectedPBit || _readBits(blocks, position, 1) != expectedPBit) return false;
+		}
+
+		return true;
+	}
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Block compression (BCn) encoding and decoding of rgba8 images
+namespace TextureCompression
+{
+
+	// Block compressed formats textures are cooked to
+	enum class BlockFormat
+	{
+		// Uncompressed
+		NONE,
+
+		// RGB, 4 bits per pixel
+		BC1,
+
+		// Single channel, 4 bits per pixel
+		BC4,
+
+		// Two channels, 8 bits per pixel
+		BC5,
+
+		// RGBA, 8 bits per pixel (mode 6 only)
+		BC7,
+		BC7_SRGB
+	};
+
+	// Returns the size of a single 4x4 block of the given format in bytes
+	uint32_t getBlockSize(BlockFormat format);
+
+	// Returns the size of an image of the given format and dimensions in bytes
+	size_t getImageSize(BlockFormat format, uint32_t width, uint32_t height);
+
+	// Returns the opengl internal format of the given format
+	uint32_t getInternalFormat(BlockFormat format);
+
+	// Encodes the given rgba8 image into blocks of the given format (output must hold the image size)
+	void encode(BlockFormat format, const uint8_t* pixels, uint32_t width, uint32_t height, uint8_t* blocks);
+
+	// Decodes the given blocks of the given format into an rgba8 image (unused channels are 0, alpha is 255 if unused)
+	void decode(BlockFormat format, const uint8_t* blocks, uint32_t width, uint32_t height, uint8_t* pixels);
+
+	// Round trips synthetic gradient and edge blocks through every format, returns false if any format exceeds its error bound (headless, no context needed)
+	bool selfTest();
+
+};
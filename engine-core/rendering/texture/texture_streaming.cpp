@@ -0,0 +1,272 @@
+#include "texture_streaming.h"
+
+#include <queue>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+#include "../src/core/resource/resource_loader.h"
+#include "../src/core/rendering/texture/texture.h"
+
+namespace TextureStreaming {
+
+	// Budget used until another budget is set
+	constexpr size_t DEFAULT_BUDGET = 2ull * 1024 * 1024 * 1024;
+
+	// Amount of updates a texture keeps its requested levels after it was requested last, so textures briefly out of view aren't streamed out and in again
+	constexpr uint64_t KEEP_UPDATES = 120;
+
+	// Maximum amount of textures streaming levels in at once
+	constexpr uint32_t MAX_STREAMING = 8;
+
+	// Minimum distance of a camera to the bounds of an entity, cameras within bounds request the finest levels
+	constexpr float MIN_DISTANCE = 0.01f;
+
+	// Streamed texture
+	struct Entry
+	{
+		Texture* texture = nullptr;
+
+		// Finest level requested
+		uint32_t requestedLevel = 0;
+
+		// Update the texture was requested last in (0 if never requested)
+		uint64_t requestUpdate = 0;
+
+		// Finest level the latest update targeted
+		uint32_t targetLevel = 0;
+
+		// Bytes of the resident and targeted levels when the texture was idle last (texture data may change while it's loaded)
+		size_t residentBytes = 0;
+		size_t targetBytes = 0;
+	};
+
+	// Level of a texture which may be dropped to fit the budget
+	struct Drop
+	{
+		size_t entry = 0;
+
+		// Amount of updates since the texture was requested last
+		uint64_t age = 0;
+
+		// Size of the level in bytes
+		size_t size = 0;
+
+		// Returns if the level is dropped after the given level (levels of textures not requested for longer and larger levels are dropped first)
+		bool operator<(const Drop& other) const {
+			if (age != other.age) return age < other.age;
+			return size < other.size;
+		}
+	};
+
+	size_t gBudget = DEFAULT_BUDGET;
+
+	// Current update, requests are assigned to the update following them
+	uint64_t gUpdate = 1;
+
+	// Streamed textures and their index within the entries
+	std::vector<Entry> gEntries;
+	std::unordered_map<Texture*, size_t> gIndices;
+
+	// Statistics of the latest update
+	Stats gStats;
+
+	// Returns if the given texture isn't being loaded or dispatched
+	bool _idle(const Texture* texture)
+	{
+		ResourceState state = texture->getState();
+		return state != ResourceState::QUEUED && state != ResourceState::CREATING;
+	}
+
+	// Returns the size of the levels of the given texture from the given level on
+	size_t _getSize(const Texture* texture, uint32_t level)
+	{
+		size_t size = 0;
+		for (uint32_t i = level; i < texture->getLevelCount(); i++) {
+			size += texture->getLevelSize(i);
+		}
+		return size;
+	}
+
+	void setBudget(size_t bytes)
+	{
+		gBudget = bytes;
+	}
+
+	size_t getBudget()
+	{
+		return gBudget;
+	}
+
+	Stats readStats()
+	{
+		return gStats;
+	}
+
+	void add(Texture* texture)
+	{
+		if (gIndices.count(texture)) return;
+
+		Entry entry;
+		entry.texture = texture;
+		entry.requestedLevel = texture->getPinnedLevel();
+		entry.targetLevel = texture->getResidentLevel();
+		entry.residentBytes = _getSize(texture, entry.targetLevel);
+		entry.targetBytes = entry.residentBytes;
+		gIndices[texture] = gEntries.size();
+		gEntries.push_back(entry);
+	}
+
+	void remove(Texture* texture)
+	{
+		auto it = gIndices.find(texture);
+		if (it == gIndices.end()) return;
+
+		// Move last entry into the removed entries place
+		size_t index = it->second;
+		gIndices.erase(it);
+		if (index + 1 < gEntries.size()) {
+			gEntries[index] = gEntries.back();
+			gIndices[gEntries[index].texture] = index;
+		}
+		gEntries.pop_back();
+	}
+
+	void request(Texture* texture, float uvPerPixel)
+	{
+		auto it = gIndices.find(texture);
+		if (it == gIndices.end()) return;
+
+		// Textures being loaded keep their latest request
+		if (!_idle(texture)) return;
+
+		// Keep finest level requested during the current update
+		Entry& entry = gEntries[it->second];
+		uint32_t level = texture->getRequiredLevel(uvPerPixel);
+		if (entry.requestUpdate != gUpdate) {
+			entry.requestedLevel = level;
+			entry.requestUpdate = gUpdate;
+		}
+		else {
+			entry.requestedLevel = std::min(entry.requestedLevel, level);
+		}
+	}
+
+	void requestVisible(const RenderQueue& queue, glm::vec3 cameraPosition, const glm::mat4& projection, float viewportHeight)
+	{
+		// Amount of pixels a world space unit covers at a distance of one unit
+		float pixelsPerUnit = viewportHeight * 0.5f * projection[1][1];
+		if (gEntries.empty() || pixelsPerUnit <= 0.0f) return;
+
+		for (const RenderQueueItem& item : queue) {
+			const TransformComponent& transform = ECS::gRegistry.get<TransformComponent>(item.entity);
+			const MeshRendererComponent& renderer = ECS::gRegistry.get<MeshRendererComponent>(item.entity);
+			const BoundsComponent& bounds = ECS::gRegistry.get<BoundsComponent>(item.entity);
+			if (!renderer.mesh || !renderer.material) continue;
+
+			// Skip meshes without uvs
+			float uvDensity = renderer.mesh->getUVDensity();
+			if (uvDensity <= 0.0f) continue;
+
+			// Smallest scale of the transform, where uvs are spread over the least world space
+			float scale = std::min({ glm::length(glm::vec3(transform.model[0])), glm::length(glm::vec3(transform.model[1])), glm::length(glm::vec3(transform.model[2])) });
+			if (scale <= 0.0f) continue;
+
+			// Distance to the closest point of the entities bounds
+			glm::vec3 closest = glm::clamp(cameraPosition, bounds.min, bounds.max);
+			float distance = std::max(glm::length(closest - cameraPosition), MIN_DISTANCE);
+
+			// Request levels for the uv units covered by a screen pixel at the closest point
+			float uvPerPixel = uvDensity / scale * distance / pixelsPerUnit;
+			renderer.material->requestTextures(uvPerPixel);
+		}
+	}
+
+	void update()
+	{
+		Stats stats;
+		stats.textures = static_cast<uint32_t>(gEntries.size());
+
+		//
+		// TARGET LEVELS
+		//
+
+		std::priority_queue<Drop> drops;
+		size_t targetBytes = 0;
+		uint32_t streaming = 0;
+		for (size_t i = 0; i < gEntries.size(); i++) {
+			Entry& entry = gEntries[i];
+			const Texture* texture = entry.texture;
+
+			// Textures being loaded keep their target until they are complete
+			if (!_idle(texture)) {
+				stats.residentBytes += entry.residentBytes;
+				stats.requiredBytes += entry.targetBytes;
+				targetBytes += entry.targetBytes;
+				streaming++;
+				continue;
+			}
+			entry.residentBytes = _getSize(texture, texture->getResidentLevel());
+			stats.residentBytes += entry.residentBytes;
+
+			// Target requested levels while recently requested, pinned levels only otherwise
+			uint32_t pinnedLevel = texture->getPinnedLevel();
+			uint64_t age = gUpdate - entry.requestUpdate;
+			entry.targetLevel = entry.requestUpdate && age <= KEEP_UPDATES ? std::min(entry.requestedLevel, pinnedLevel) : pinnedLevel;
+			entry.targetBytes = _getSize(texture, entry.targetLevel);
+			targetBytes += entry.targetBytes;
+			stats.requiredBytes += entry.targetBytes;
+
+			// Levels finer than the pinned levels may be dropped
+			if (entry.targetLevel < pinnedLevel) {
+				drops.push(Drop{ i, age, texture->getLevelSize(entry.targetLevel) });
+			}
+		}
+
+		// Drop levels until the targeted levels fit the budget
+		while (targetBytes > gBudget && !drops.empty()) {
+			Drop drop = drops.top();
+			drops.pop();
+
+			Entry& entry = gEntries[drop.entry];
+			targetBytes -= drop.size;
+			entry.targetBytes -= drop.size;
+			entry.targetLevel++;
+			if (entry.targetLevel < entry.texture->getPinnedLevel()) {
+				drops.push(Drop{ drop.entry, drop.age, entry.texture->getLevelSize(entry.targetLevel) });
+			}
+		}
+		stats.targetBytes = targetBytes;
+
+		//
+		// EVICT LEVELS
+		//
+
+		// Evict first, freeing memory before finer levels stream in
+		for (Entry& entry : gEntries) {
+			if (!_idle(entry.texture) || entry.targetLevel <= entry.texture->getResidentLevel()) continue;
+			entry.texture->evict(entry.targetLevel);
+			stats.evicted++;
+		}
+
+		//
+		// STREAM IN LEVELS
+		//
+
+		// Textures requested during this update stream in before textures only kept
+		for (bool requested : { true, false }) {
+			for (Entry& entry : gEntries) {
+				if (streaming >= MAX_STREAMING) break;
+				if ((entry.requestUpdate == gUpdate) != requested) continue;
+				if (!_idle(entry.texture) || entry.targetLevel >= entry.texture->getResidentLevel()) continue;
+				entry.texture->streamIn(entry.targetLevel, requested ? ResourcePriority::VISIBLE : ResourcePriority::BACKGROUND);
+				streaming++;
+			}
+		}
+		stats.streaming = streaming;
+
+		gStats = stats;
+		gUpdate++;
+	}
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Persistently mapped pixel unpack buffer loader threads write texture data into, textures are then uploaded from offsets within the ring
+namespace UploadRing
+{
+
+	// Range of the ring holding data written by a loader
+	struct Region
+	{
+		// Identifier of the region, 0 if the region is invalid
+		uint64_t id = 0;
+
+		// Offset of the regions data within the ring buffer
+		size_t offset = 0;
+
+		// Size of the regions data in bytes
+		size_t size = 0;
+	};
+
+	// Creates and persistently maps the ring buffer (on main thread)
+	void create();
+
+	// Destroys the ring buffer once pending writes are finished (on main thread)
+	void destroy();
+
+	// Returns the backend id of the ring buffer
+	uint32_t getBuffer();
+
+	// Copies the given data into the ring, returns an invalid region if the data doesn't fit into the ring
+	// Loader threads wait for regions to be retired while the ring is full, the main thread never waits
+	Region write(const void* data, size_t size);
+
+	// Releases the given region once the gpu finished all commands issued so far (on main thread)
+	void release(Region region);
+
+	// Reclaims released regions the gpu finished reading from (on main thread, once per frame)
+	void retire();
+
+};
@@ -77,4 +77,10 @@ namespace Transformation {
 		return glm::transpose(glm::inverse(model));
 	}
 
+	glm::vec3 direction(const glm::mat4& model)
+	{
+		// Left handed forward axis is the backends negative z axis
+		return glm::normalize(-glm::vec3(model[2]));
+	}
+
 }
\ No newline at end of file
@@ -22,4 +22,7 @@ namespace Transformation
 
 	// Returns a normal matrix (transposed inversed model matrix) by given model matrix
 	glm::mat4 normal(const glm::mat4& model);
+
+	// Returns the backend direction a model matrix is facing (its left handed forward axis)
+	glm::vec3 direction(const glm::mat4& model);
 };
\ No newline at end of file
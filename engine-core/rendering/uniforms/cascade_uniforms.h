@@ -0,0 +1,38 @@
+#pragma once
+
+#include <glm.hpp>
+
+#include "../src/core/rendering/uniforms/uniform_buffer.h"
+#include "../src/core/rendering/shadows/cascaded_shadow_map.h"
+
+// Per-view cascaded shadows of the main directional light shared by all lit shaders through the "CascadeUniforms" block
+class CascadeUniforms
+{
+public:
+	CascadeUniforms();
+
+	// Creates the cascades uniform buffer
+	void create();
+
+	// Destroys the cascades uniform buffer
+	void destroy();
+
+	// Updates the cascades from the given cascaded shadow map and binds them for all upcoming draws
+	void update(const CascadedShadowMap& cascadedShadowMap);
+
+	// Binds the cascades for all upcoming draws
+	void bind() const;
+
+private:
+	// Layout of uniform block (std140)
+	struct Data {
+		glm::mat4 lightSpaces[CascadedShadowMap::MAX_CASCADES];
+		float splits[CascadedShadowMap::MAX_CASCADES];
+		float texelSizes[CascadedShadowMap::MAX_CASCADES];
+		int32_t nCascades;
+		int32_t _padding[3];
+	};
+
+	// Uniform buffer holding cascades
+	UniformBuffer buffer;
+};
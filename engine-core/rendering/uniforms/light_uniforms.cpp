@@ -0,0 +1,127 @@
+#include "light_uniforms.h"
+
+#include "../src/core/ecs/ecs_collection.h"
+#include "../src/core/rendering/shadows/shadow_atlas.h"
+#include "../src/core/rendering/transformation/transformation.h"
+
+LightUniforms::LightUniforms() : buffer(),
+pointLightBuffer(),
+spotlightBuffer(),
+pointLights(),
+spotlights()
+{
+}
+
+void LightUniforms::create()
+{
+	buffer.create(sizeof(Data));
+	pointLightBuffer.create();
+	spotlightBuffer.create();
+}
+
+void LightUniforms::destroy()
+{
+	buffer.destroy();
+	pointLightBuffer.destroy();
+	spotlightBuffer.destroy();
+}
+
+void LightUniforms::update(const ShadowAtlas& shadowAtlas)
+{
+	Data data = {};
+	pointLights.clear();
+	spotlights.clear();
+
+	// Fetch lights
+	auto directionalLightView = ECS::gRegistry.view<TransformComponent, DirectionalLightComponent>();
+	auto pointLightView = ECS::gRegistry.view<TransformComponent, PointLightComponent>();
+	auto spotlightView = ECS::gRegistry.view<TransformComponent, SpotlightComponent>();
+
+	// Gather directional lights
+	for (auto [entity, transform, directionalLight] : directionalLightView.each()) {
+		if (!directionalLight.enabled) continue;
+		if (data.nDirectionalLights >= MAX_DIRECTIONAL_LIGHTS) break;
+
+		DirectionalLight& target = data.directionalLights[data.nDirectionalLights++];
+		target.direction = Transformation::direction(transform.model);
+		target.intensity = directionalLight.intensity;
+		target.color = directionalLight.color;
+		target.position = Transformation::toBackendPosition(transform.position);
+	}
+
+	// Gather point lights
+	for (auto [entity, transform, pointLight] : pointLightView.each()) {
+		if (!pointLight.enabled) continue;
+
+		PointLight& target = pointLights.emplace_back();
+		target.position = Transformation::toBackendPosition(transform.position);
+		target.intensity = pointLight.intensity;
+		target.color = pointLight.color;
+		target.range = pointLight.range;
+		target.falloff = pointLight.falloff;
+		target.shadowTile = shadowAtlas.getTile(entity);
+	}
+
+	// Gather spotlights
+	for (auto [entity, transform, spotlight] : spotlightView.each()) {
+		if (!spotlight.enabled) continue;
+
+		Spotlight& target = spotlights.emplace_back();
+		target.position = Transformation::toBackendPosition(transform.position);
+		target.intensity = spotlight.intensity;
+		target.direction = Transformation::direction(transform.model);
+		target.range = spotlight.range;
+		target.color = spotlight.color;
+		target.falloff = spotlight.falloff;
+		target.innerCos = glm::cos(glm::radians(spotlight.innerAngle * 0.5f));
+		target.outerCos = glm::cos(glm::radians(spotlight.outerAngle * 0.5f));
+		target.shadowTile = shadowAtlas.getTile(entity);
+	}
+
+	upload(data);
+}
+
+void LightUniforms::updateSample()
+{
+	Data data = {};
+	pointLights.clear();
+	spotlights.clear();
+
+	// Single white directional light
+	DirectionalLight& target = data.directionalLights[0];
+	target.direction = Transformation::toBackendPosition(glm::vec3(-0.5f, -0.5f, 0.5f));
+	target.intensity = 1.0f;
+	target.color = glm::vec3(1.0f, 1.0f, 1.0f);
+	target.position = Transformation::toBackendPosition(glm::vec3(0.0f, 0.0f, 0.0f));
+	data.nDirectionalLights = 1;
+
+	upload(data);
+}
+
+void LightUniforms::bind() const
+{
+	buffer.bind(UniformBinding::LIGHTS);
+	pointLightBuffer.bind(StorageBinding::POINT_LIGHTS);
+	spotlightBuffer.bind(StorageBinding::SPOTLIGHTS);
+}
+
+const std::vector<LightUniforms::PointLight>& LightUniforms::getPointLights() const
+{
+	return pointLights;
+}
+
+const std::vector<LightUniforms::Spotlight>& LightUniforms::getSpotlights() const
+{
+	return spotlights;
+}
+
+void LightUniforms::upload(Data& data)
+{
+	data.nPointLights = static_cast<int32_t>(pointLights.size());
+	data.nSpotlights = static_cast<int32_t>(spotlights.size());
+
+	buffer.update(&data, sizeof(Data));
+	pointLightBuffer.upload(pointLights.data(), pointLights.size() * sizeof(PointLight));
+	spotlightBuffer.upload(spotlights.data(), spotlights.size() * sizeof(Spotlight));
+	bind();
+}
@@ -0,0 +1,42 @@
+#include "shadow_uniforms.h"
+
+#include "../src/core/rendering/shadows/shadow_atlas.h"
+#include "../src/core/rendering/shadows/shadow_disk.h"
+
+ShadowUniforms::ShadowUniforms() : buffer(),
+tileBuffer()
+{
+}
+
+void ShadowUniforms::create()
+{
+	buffer.create(sizeof(Data));
+	tileBuffer.create();
+}
+
+void ShadowUniforms::destroy()
+{
+	buffer.destroy();
+	tileBuffer.destroy();
+}
+
+void ShadowUniforms::update(const ShadowAtlas& shadowAtlas, ShadowDisk& shadowDisk)
+{
+	// Gather shadow configuration
+	Data data = {};
+	data.shadowAtlasResolution = glm::vec2(static_cast<float>(shadowAtlas.getResolution()));
+	data.shadowDiskWindowSize = static_cast<float>(shadowDisk.getWindowSize());
+	data.shadowDiskFilterSize = static_cast<float>(shadowDisk.getFilterSize());
+	data.shadowDiskRadius = static_cast<float>(shadowDisk.getRadius());
+
+	// Upload and bind data
+	buffer.update(&data, sizeof(Data));
+	tileBuffer.upload(shadowAtlas.getTiles().data(), shadowAtlas.getTiles().size() * sizeof(ShadowAtlas::Tile));
+	bind();
+}
+
+void ShadowUniforms::bind() const
+{
+	buffer.bind(UniformBinding::SHADOWS);
+	tileBuffer.bind(StorageBinding::SHADOW_TILES);
+}
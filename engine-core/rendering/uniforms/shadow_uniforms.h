@@ -0,0 +1,44 @@
+#pragma once
+
+#include <glm.hpp>
+
+#include "../src/core/rendering/uniforms/uniform_buffer.h"
+#include "../src/core/rendering/uniforms/storage_buffer.h"
+
+class ShadowAtlas;
+class ShadowDisk;
+
+// Shadow configuration shared by all lit shaders through the "ShadowUniforms" block and the "ShadowTiles" storage block
+class ShadowUniforms
+{
+public:
+	ShadowUniforms();
+
+	// Creates the shadow configurations uniform and storage buffers
+	void create();
+
+	// Destroys the shadow configurations uniform and storage buffers
+	void destroy();
+
+	// Updates the shadow configuration from given shadow atlas and disk and binds it for all upcoming draws
+	void update(const ShadowAtlas& shadowAtlas, ShadowDisk& shadowDisk);
+
+	// Binds the shadow configuration for all upcoming draws
+	void bind() const;
+
+private:
+	// Layout of uniform block (std140)
+	struct Data {
+		glm::vec2 shadowAtlasResolution;
+		float shadowDiskWindowSize;
+		float shadowDiskFilterSize;
+		float shadowDiskRadius;
+		float _padding[3];
+	};
+
+	// Uniform buffer holding shadow configuration
+	UniformBuffer buffer;
+
+	// Storage buffer holding the shadow atlas tiles
+	StorageBuffer tileBuffer;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// Binding points of shader storage blocks shared between shaders
+// Lower binding points are left to compute passes binding their buffers while dispatching
+namespace StorageBinding
+{
+	// Per-frame point lights (block "PointLights")
+	constexpr uint32_t POINT_LIGHTS = 8;
+
+	// Per-frame spotlights (block "Spotlights")
+	constexpr uint32_t SPOTLIGHTS = 9;
+
+	// Per-view light cluster grid (block "LightClusters")
+	constexpr uint32_t LIGHT_CLUSTERS = 10;
+
+	// Per-view light indices of the light clusters (block "LightIndices")
+	constexpr uint32_t LIGHT_INDICES = 11;
+
+	// Per-frame shadow atlas tiles (block "ShadowTiles")
+	constexpr uint32_t SHADOW_TILES = 12;
+};
+
+class StorageBuffer
+{
+public:
+	StorageBuffer();
+
+	// Creates the storage buffer
+	void create();
+
+	// Destroys the storage buffer
+	void destroy();
+
+	// Replaces the contents of the storage buffer with given data, growing the buffer if needed
+	void upload(const void* data, size_t size);
+
+	// Binds the storage buffer to given shader storage block binding point
+	void bind(uint32_t binding) const;
+
+	// Returns the storage buffers backend id
+	uint32_t id() const;
+
+private:
+	// Minimum size allocated, so empty data can be bound too
+	static constexpr size_t MIN_CAPACITY = 256;
+
+	// Storage buffer backend id
+	uint32_t _id;
+
+	// Size of the allocated storage in bytes
+	size_t capacity;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <glm.hpp>
+
+#include "../src/core/rendering/uniforms/uniform_buffer.h"
+
+// Per-view camera data shared by all shaders through the "ViewUniforms" block
+class ViewUniforms
+{
+public:
+	ViewUniforms();
+
+	// Creates the views uniform buffer
+	void create();
+
+	// Destroys the views uniform buffer
+	void destroy();
+
+	// Updates the views camera data and binds it for all upcoming draws
+	void update(const glm::mat4& view, const glm::mat4& projection, const glm::vec2& resolution, float gamma = 2.2f, bool enableSSAO = false, bool castShadows = false);
+
+	// Binds the views camera data for all upcoming draws
+	void bind() const;
+
+private:
+	// Layout of uniform block (std140)
+	struct Data {
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::mat4 viewProjection;
+		glm::mat4 viewNormal;
+		glm::vec3 cameraPosition;
+		float gamma;
+		glm::vec2 resolution;
+		int32_t enableSSAO;
+		int32_t castShadows;
+	};
+
+	// Uniform buffer holding views data
+	UniformBuffer buffer;
+};
@@ -8,6 +8,7 @@
 #include "../src/core/rendering/primitives/global_quad.h"
 #include "../src/core/rendering/shader/shader_pool.h"
 #include "../src/core/rendering/model/mesh.h"
+#include "../src/core/rendering/geometry/geometry_arena.h"
 #include "../src/core/ecs/ecs_collection.h"
 
 VelocityBuffer::VelocityBuffer(const Viewport& viewport) : viewport(viewport),
@@ -16,7 +17,11 @@ rbo(0),
 output(0),
 postfilteredOutput(0),
 velocityPassShader(nullptr),
-postfilterShader(nullptr)
+postfilterShader(nullptr),
+instances(),
+previousModels(),
+batches(),
+batchIntensities()
 {
 }
 
@@ -99,13 +104,13 @@ void VelocityBuffer::destroy()
 	postfilterShader = nullptr;
 }
 
-uint32_t VelocityBuffer::render(const glm::mat4& view, const glm::mat4& projection, const PostProcessing::Profile& profile)
+uint32_t VelocityBuffer::render(const PostProcessing::Profile& profile, const RenderQueue& renderQueue)
 {
 	// Prepare output
 	uint32_t OUTPUT = 0;
 
 	// Render velocity buffer
-	OUTPUT = velocityPass(view, projection);
+	OUTPUT = velocityPass(renderQueue);
 
 	// OUTPUT = postfilteringPass();
 
@@ -113,8 +118,11 @@ uint32_t VelocityBuffer::render(const glm::mat4& view, const glm::mat4& projecti
 	return OUTPUT;
 }
 
-uint32_t VelocityBuffer::velocityPass(const glm::mat4& view, const glm::mat4& projection)
+uint32_t VelocityBuffer::velocityPass(const RenderQueue& renderQueue)
 {
+	// Set viewport for upcoming velocity pass
+	glViewport(0, 0, viewport.getWidth_gl(), viewport.getHeight_gl());
+
 	// Bind framebuffer
 	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
 
@@ -131,26 +139,59 @@ uint32_t VelocityBuffer::velocityPass(const glm::mat4& view, const glm::mat4& pr
 
 	// Bind shader
 	velocityPassShader->bind();
-	velocityPassShader->setMatrix4("viewMatrix", view);
-	velocityPassShader->setMatrix4("projectionMatrix", projection);
 
-	// Render velocity buffer by performing velocity pass on each object
-	auto targets = ECS::gRegistry.view<TransformComponent, MeshRendererComponent, VelocityComponent>();
-	for (auto [entity, transform, renderer, velocity] : targets.each()) {
-		if (!renderer.mesh) return 0;
+	// Collect instances of visible objects with velocity, grouping runs of identical mesh and intensity
+	instances.clear();
+	previousModels.clear();
+	batches.clear();
+	batchIntensities.clear();
+	for (const RenderQueueItem& item : renderQueue) {
+		Entity entity = item.entity;
+		auto [transform, renderer] = ECS::gRegistry.get<TransformComponent, MeshRendererComponent>(item.entity);
+		if (!renderer.enabled || !renderer.mesh) continue;
+
+		// Make sure entity has a velocity component
+		VelocityComponent* velocity = ECS::gRegistry.try_get<VelocityComponent>(entity);
+		if (!velocity) continue;
+
+		// Start a new batch if mesh or intensity differ from the current batch
+		if (batches.empty() || batches.back().mesh != renderer.mesh || batchIntensities.back() != velocity->intensity) {
+			batches.push_back({ renderer.mesh, renderer.material, static_cast<uint32_t>(instances.size()), 0 });
+			batchIntensities.push_back(velocity->intensity);
+		}
+
+		// Add instance to current batch (both model matrices also dequantize the meshes packed positions)
+		const glm::mat4& dequantization = renderer.mesh->getDequantization();
+		instances.push_back({ transform.model * dequantization, transform.normal });
+		previousModels.push_back(velocity->lastModel * dequantization);
+		batches.back().count++;
+	}
+	Instancing::upload(instances, batches);
+	Instancing::uploadPrevious(previousModels);
+
+	// Bind geometry arena
+	glBindVertexArray(GeometryArena::getVAO());
+
+	// Render velocity buffer by rendering batches of each intensity with a single indirect draw call
+	uint32_t nBatches = static_cast<uint32_t>(batches.size());
+	for (uint32_t first = 0; first < nBatches;) {
+		float intensity = batchIntensities[first];
+
+		// Find end of intensity run
+		uint32_t end = first + 1;
+		while (end < nBatches && batchIntensities[end] == intensity) end++;
 
 		// Set velocity pass shader uniforms
-		velocityPassShader->setMatrix4("modelMatrix", transform.model);
-		velocityPassShader->setMatrix4("previousModelMatrix", velocity.lastModel);
-		velocityPassShader->setFloat("intensity", velocity.intensity);
+		velocityPassShader->setFloat("intensity", intensity);
 
-		// Bind mesh
-		glBindVertexArray(renderer.mesh->getVAO());
-		  
-		// Render mesh
-		glDrawElements(GL_TRIANGLES, renderer.mesh->getVerticeCount(), GL_UNSIGNED_INT, 0);
+		// Render all batches of run
+		Instancing::drawBatches(first, end - first);
+		first = end;
+	}
 
-		// Update last model matrix cache
+	// Update last model matrix cache of all objects, including culled ones
+	auto targets = ECS::gRegistry.view<TransformComponent, VelocityComponent>();
+	for (auto [entity, transform, velocity] : targets.each()) {
 		velocity.lastModel = transform.model;
 	}
 
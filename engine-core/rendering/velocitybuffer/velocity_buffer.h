@@ -4,7 +4,9 @@
 #include <vector>
 #include <glm.hpp>
 
+#include "../src/core/ecs/ecs.h"
 #include "../src/core/viewport/viewport.h"
+#include "../src/core/rendering/instancing/instancing.h"
 #include "../src/core/rendering/postprocessing/post_processing.h"
 #
 
@@ -18,10 +20,10 @@ public:
 	void create();	// Setup velocity buffer
 	void destroy(); // Delete velocity buffer
 
-	uint32_t render(const glm::mat4& view, const glm::mat4& projection, const PostProcessing::Profile& profile); // Renders the velocity buffer and returns the filtered output
+	uint32_t render(const PostProcessing::Profile& profile, const RenderQueue& renderQueue); // Renders the velocity buffer for the given render queue and returns the filtered output
 
 private:
-	uint32_t velocityPass(const glm::mat4& view, const glm::mat4& projection);	  // Performs velocity passes to render velocity buffer and returns velocity buffer
+	uint32_t velocityPass(const RenderQueue& renderQueue);	  // Performs velocity passes to render velocity buffer and returns velocity buffer
 	uint32_t postfilteringPass(); // Performs postfiltering pass on rendered velocity buffer and returns postfiltered velocity buffer
 
 private:
@@ -36,4 +38,9 @@ private:
 
 	Shader* velocityPassShader; // Shader for velocity pass
 	Shader* postfilterShader; // Shader for performing postfilter pass on velocity buffer
+
+	std::vector<Instancing::Instance> instances; // Instances of entities with velocity, reused across frames
+	std::vector<glm::mat4> previousModels; // Previous model matrices of the instances
+	std::vector<Instancing::Batch> batches; // Instanced draw batches, split on mesh or intensity changes
+	std::vector<float> batchIntensities; // Velocity intensity of each batch
 };
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <atomic>
+#include <cstddef>
 
 enum class ResourceState {
 	// Resource has not been initialized or loaded yet
@@ -35,6 +36,13 @@ protected:
 	// Creates gpu buffers for resource with previously loaded data
 	virtual void dispatchGPU() = 0;
 
+	// Dispatches the next chunk of previously loaded data to the gpu, returns true once the resource is fully dispatched
+	// Resources not splitting their dispatch are dispatched at once
+	virtual bool dispatchChunk() { dispatchGPU(); return true; }
+
+	// Returns the approximate amount of bytes the next dispatch chunk uploads
+	virtual size_t getChunkSize() { return 0; }
+
 	Resource() : state(ResourceState::EMPTY) {};
 	virtual ~Resource() = default;
 
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <queue>
+#include <vector>
 #include <thread>
 #include <atomic>
 #include <mutex>
@@ -9,6 +10,18 @@
 
 #include "../src/core/resource/resource.h"
 
+// Order in which asynchronously created resources are loaded and dispatched
+enum class ResourcePriority {
+	// Resource is needed right away (e.g. engine defaults)
+	CRITICAL,
+
+	// Resource is needed for what is currently visible
+	VISIBLE,
+
+	// Resource can be loaded whenever there is time
+	BACKGROUND
+};
+
 class ResourceLoader
 {
 public:
@@ -20,33 +33,74 @@ public:
 		WorkerState(bool active, Resource* target, size_t tasksPending) : active(active), target(target), tasksPending(tasksPending) {};
 	};
 
+	// Statistics of the last frames dispatches
+	struct UploadStats {
+		// Time spent dispatching
+		float milliseconds = 0.0f;
+
+		// Approximate amount of bytes dispatched
+		size_t bytes = 0;
+
+		// Amount of chunks dispatched
+		uint32_t chunks = 0;
+
+		// Amount of resources completed
+		uint32_t completed = 0;
+	};
+
 public:
-	ResourceLoader();
+	// Creates the loader with the given amount of worker threads (picked from the hardware concurrency if 0)
+	explicit ResourceLoader(uint32_t nWorkers = 0);
 	~ResourceLoader();
 
-	// Returns the current state of the worker
+	// Returns the current state of the workers
 	WorkerState readWorkerState() const;
 
-	// Creates resources synchronously, blocking until complete  
+	// Returns the statistics of the last frames dispatches
+	UploadStats readUploadStats() const;
+
+	// Sets the time and bytes the main thread may spend dispatching resources per frame (e.g. raised during loading screens)
+	void setUploadBudget(float milliseconds, size_t bytes);
+
+	// Creates resources synchronously, blocking until complete
 	void createSync(Resource* resource);
 
 	// Queues resource creation for asynchronous creation, not blocking
-	void createAsync(Resource* resource);
+	void createAsync(Resource* resource, ResourcePriority priority = ResourcePriority::VISIBLE);
 
-	// Dispatch next pending resource to gpu (on main thread)
+	// Dispatches chunks of pending resources loaded by the workers to gpu until the upload budget is spent (on main thread)
+	// At least one chunk is dispatched per call so large resources always progress
 	void dispatchNext();
 
 private:
+	// Resource queued for loading or dispatching
+	struct Task {
+		Resource* resource;
+		ResourcePriority priority;
+
+		// Order of creation, resources of equal priority are handled first in first out
+		uint64_t sequence;
+
+		// Returns if the task is handled after the given task
+		bool operator<(const Task& other) const {
+			if (priority != other.priority) return priority > other.priority;
+			return sequence > other.sequence;
+		}
+	};
+
 	// Async worker thread
 	void asyncWorker();
 
-	// Helper to pop from queue safely
-	template <typename T>
-	void popSafe(std::queue<T>& queue) {
-		if (!queue.empty()) queue.pop();
-	}
-
 private:
+	// Maximum amount of loaded resources waiting for their dispatch, workers stall when reached
+	static constexpr size_t UPLOAD_QUEUE_CAPACITY = 64;
+
+	// Maximum amount of worker threads picked automatically
+	static constexpr uint32_t MAX_AUTO_WORKERS = 4;
+
+	// Weight of the latest measurement when updating the dispatch cost estimates
+	static constexpr float COST_SMOOTHING = 0.2f;
+
 	//
 	//
 	// MAIN THREAD
@@ -56,39 +110,56 @@ private:
 	// Set if the application is running
 	std::atomic<bool> running;
 
-	// Resource upload tasks on the main thread
-	std::queue<Resource*> mainTasks;
+	// Mutex guarding the upload queue
+	std::mutex mainMtx;
+
+	// Condition variable to stall workers while the upload queue is full
+	std::condition_variable mainUploadSlotAvailable;
+
+	// Loaded resources waiting to be dispatched on the main thread
+	std::priority_queue<Task> mainTasks;
+
+	// Resource currently dispatched in chunks across frames (resource is nullptr if there is none)
+	Task mainCurrent;
+
+	// Time and bytes that may be spent dispatching per frame
+	float mainBudgetMilliseconds;
+	size_t mainBudgetBytes;
+
+	// Measured dispatch costs used to predict if the next chunk fits the budget
+	float mainMillisecondsPerByte;
+	float mainMillisecondsPerChunk;
+
+	// Statistics of the last frames dispatches
+	UploadStats mainStats;
 
-	// Atomic set if main thread can dispatch next resource
-	std::atomic<bool> mainDispatchNext;
-	
 	//
 	//
-	// WORKER THREAD
+	// WORKER THREADS
 	//
 	//
 
-	// Worker thread handle
-	std::thread worker;
+	// Worker thread handles
+	std::vector<std::thread> workers;
 
-	// Worker thread mutex
+	// Mutex guarding the load queue
 	std::mutex workerMtx;
 
-	// Condition variable to ensure worker doesnt run when no tasks are available
+	// Condition variable to ensure workers dont run when no tasks are available
 	std::condition_variable workerTasksAvailable;
 
-	// Condition variable to ensure worker doesnt run when a resource dispatch from the main thread is pending
-	std::condition_variable workerAwaitingDispatch;
+	// Resource load tasks of the workers
+	std::priority_queue<Task> workerTasks;
 
-	// Resource load tasks on the worker thread
-	std::queue<Resource*> workerTasks;
+	// Amount of tasks created so far
+	uint64_t workerSequence;
 
-	// Amount of tasks waiting in workers queue
+	// Amount of resources queued, loading or awaiting their dispatch
 	std::atomic<size_t> workerTasksPending;
 
-	// Set if the worker is currently running, false if worker is sleeping
-	std::atomic<bool> workerActive;
+	// Amount of workers currently loading a resource
+	std::atomic<uint32_t> workersActive;
 
-	// Points to the resource the worker is currently loading (nullptr if worker isn't loading any resource)
+	// Points to the resource a worker started loading last (nullptr if no worker is loading any resource)
 	std::atomic<Resource*> workerTarget;
-};
\ No newline at end of file
+};
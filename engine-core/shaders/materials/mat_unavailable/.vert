@@ -2,9 +2,21 @@
 
 layout(location = 0) in vec3 position_in;
 
-uniform mat4 mvpMatrix;
+layout(location = 5) in mat4 modelMatrix;
+
+layout(std140) uniform ViewUniforms {
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+    mat4 viewProjectionMatrix;
+    mat4 viewNormalMatrix;
+    vec3 cameraPosition;
+    float gamma;
+    vec2 viewportResolution;
+    bool enableSSAO;
+    bool castShadows;
+};
 
 void main()
 {
-    gl_Position = mvpMatrix * vec4(position_in, 1.0);
+    gl_Position = viewProjectionMatrix * modelMatrix * vec4(position_in, 1.0);
 }
@@ -1,19 +1,39 @@
 #version 330 core
 
-layout(location = 0) in vec3 position_in;
-layout(location = 1) in vec3 normal_in;
+layout(location = 0) in vec3 position_in; // quantized within mesh bounds, dequantized by model matrix
+layout(location = 1) in vec2 normal_in; // octahedral encoded
 
-uniform mat4 mvpMatrix;
-uniform mat3 viewNormalMatrix;
+layout(location = 5) in mat4 modelMatrix;
+layout(location = 9) in mat3 normalMatrix;
+
+layout(std140) uniform ViewUniforms {
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+    mat4 viewProjectionMatrix;
+    mat4 viewNormalMatrix;
+    vec3 cameraPosition;
+    float gamma;
+    vec2 viewportResolution;
+    bool enableSSAO;
+    bool castShadows;
+};
 
 out vec3 v_viewNormal;
 
+vec3 octDecode(vec2 encoded) {
+    vec3 v = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = max(-v.z, 0.0);
+    v.x += v.x >= 0.0 ? -t : t;
+    v.y += v.y >= 0.0 ? -t : t;
+    return normalize(v);
+}
+
 vec3 getViewNormal() {
-    return normalize(viewNormalMatrix * normal_in);
+    return normalize(mat3(viewNormalMatrix) * normalMatrix * octDecode(normal_in));
 }
 
 void main()
 {
     v_viewNormal = getViewNormal();
-    gl_Position = mvpMatrix * vec4(position_in, 1.0);
+    gl_Position = viewProjectionMatrix * modelMatrix * vec4(position_in, 1.0);
 }
@@ -1,11 +1,21 @@
 #version 330 core
 
-layout(location = 0) in vec3 position_in;
+layout(location = 0) in vec3 position_in; // quantized within mesh bounds, dequantized by model matrices
 
-uniform mat4 modelMatrix;
-uniform mat4 previousModelMatrix;
-uniform mat4 viewMatrix;
-uniform mat4 projectionMatrix;
+layout(location = 5) in mat4 modelMatrix;
+layout(location = 12) in mat4 previousModelMatrix;
+
+layout(std140) uniform ViewUniforms {
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+    mat4 viewProjectionMatrix;
+    mat4 viewNormalMatrix;
+    vec3 cameraPosition;
+    float gamma;
+    vec2 viewportResolution;
+    bool enableSSAO;
+    bool castShadows;
+};
 
 out vec4 v_viewPosition;
 out vec4 v_position;
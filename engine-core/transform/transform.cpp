@@ -7,18 +7,11 @@
 
 namespace Transform {
 
-	void evaluate(TransformComponent& transform, const glm::mat4 viewProjection)
+	void evaluate(TransformComponent& transform)
 	{
-		// Compute model matrix
+		// Compute model matrix, using the parents already evaluated model matrix
 		transform.model = Transformation::model(transform.position, transform.rotation, transform.scale);
-		if (transform.parent) {
-			transform.model = 
-				Transformation::model(transform.parent->position, transform.parent->rotation, transform.parent->scale) 
-				* Transformation::model(transform.position, transform.rotation, transform.scale);
-		}
-
-		// Compute model-view-projection matrix
-		transform.mvp = viewProjection * transform.model;
+		if (transform.parent) transform.model = transform.parent->model * transform.model;
 
 		// Compute normal matrix
 		transform.normal = Transformation::normal(transform.model);
@@ -9,7 +9,8 @@ namespace Transform
 {
 
 	// Computes and updates the transformation matrices of given transform component
-	void evaluate(TransformComponent& transform, const glm::mat4 viewProjection);
+	// (Parents model matrix must be evaluated already, hierarchies are evaluated by the transform system)
+	void evaluate(TransformComponent& transform);
 
 	// Returns the forward direction vector of the transform in world space
 	glm::vec3 forward(const TransformComponent& transform);
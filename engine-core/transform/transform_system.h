@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm.hpp>
+
+namespace TransformSystem
+{
+
+	// Sets up the transform system by listening to transform component changes of the global registry
+	void setup();
+
+	// Evaluates the model and normal matrices of all transforms whose local transformation or parent chain changed since the last update
+	void update();
+
+	// Returns the world matrices of all transforms, contiguous and ordered by hierarchy depth
+	const std::vector<glm::mat4>& getWorldMatrices();
+
+	// Returns the amount of transforms evaluated during the latest update
+	uint32_t getEvaluatedCount();
+
+};
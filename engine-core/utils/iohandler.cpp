@@ -6,6 +6,7 @@
 #include <iostream>
 
 #include "../src/core/utils/console.h"
+#include "../src/core/utils/mapped_file.h"
 
 namespace IOHandler
 {
@@ -136,4 +137,20 @@ namespace IOHandler
 		return files;
 	}
 
+	uint64_t hashFile(const std::string& path)
+	{
+		MappedFile file;
+		if (!file.open(path)) return 0;
+
+		// 64-bit FNV-1a over the files contents
+		uint64_t hash = 14695981039346656037ull;
+		const uint8_t* data = file.getData();
+		for (size_t i = 0; i < file.getSize(); i++) {
+			hash ^= data[i];
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
 }
\ No newline at end of file
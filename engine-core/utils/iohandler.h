@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 
 namespace IOHandler
 {
@@ -27,4 +28,7 @@ namespace IOHandler
 	// Returns all paths of all files within given path with valid extension
 	std::vector<std::string> getFilesWithExtensions(const std::string& path, const std::vector<std::string>& extensions);
 
+	// Returns the content hash of a file or 0 if it can't be read
+	uint64_t hashFile(const std::string& path);
+
 };
@@ -1,11 +1,16 @@
 #include "profiler.h"
 
+#include <mutex>
+
 namespace Profiler
 {
 
 	std::unordered_map<std::string, std::chrono::steady_clock::time_point> gProfiles = std::unordered_map<std::string, std::chrono::steady_clock::time_point>();
 	std::unordered_map<std::string, double> gTimes = std::unordered_map<std::string, double>();
 
+	// Guards profiles and times, profiling may happen on job threads
+	std::mutex gMutex;
+
 	bool _validateProfile(const std::string& identifier)
 	{
 		return gProfiles.find(identifier) == gProfiles.end() ? false : true;
@@ -23,11 +28,13 @@ namespace Profiler
 
 	void start(const std::string& identifier)
 	{
+		std::lock_guard<std::mutex> lock(gMutex);
 		gProfiles[identifier] = _now();
 	}
 
 	double stop(const std::string& identifier)
 	{
+		std::lock_guard<std::mutex> lock(gMutex);
 		if (!_validateProfile(identifier))
 		{
 			return 0.0;
@@ -37,20 +44,29 @@ namespace Profiler
 		return time;
 	}
 
+	void record(const std::string& identifier, double time)
+	{
+		std::lock_guard<std::mutex> lock(gMutex);
+		gTimes[identifier] = time;
+	}
+
 	double getMs(const std::string& identifier)
 	{
+		std::lock_guard<std::mutex> lock(gMutex);
 		if (!_validateTime(identifier)) return 0.0f;
 		return gTimes[identifier] * 0.001;
 	}
 
 	double getUs(const std::string& identifier)
 	{
+		std::lock_guard<std::mutex> lock(gMutex);
 		if (!_validateTime(identifier)) return 0.0f;
 		return gTimes[identifier];
 	}
 
 	double getNs(const std::string& identifier)
 	{
+		std::lock_guard<std::mutex> lock(gMutex);
 		if (!_validateTime(identifier)) return 0.0f;
 		return gTimes[identifier] * 1000;
 	}
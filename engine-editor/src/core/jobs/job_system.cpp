@@ -0,0 +1,309 @@
+#include "job_system.h"
+
+#include <deque>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <algorithm>
+#include <condition_variable>
+
+namespace JobSystem {
+
+	// Queued job and the counter tracking it
+	struct Task
+	{
+		Job job;
+		Counter* counter = nullptr;
+	};
+
+	// Job queue of a thread, its owner pushes and pops at the back while other threads steal from the front
+	struct WorkQueue
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+
+		// Time the owning thread spent executing jobs since the last reset in nanoseconds
+		std::atomic<uint64_t> busyTime = 0;
+	};
+
+	// Job queues of all threads, index zero belongs to the main thread
+	std::vector<std::unique_ptr<WorkQueue>> gQueues;
+
+	// Worker thread handles
+	std::vector<std::thread> gWorkers;
+
+	// Set while the worker threads should keep running
+	std::atomic<bool> gRunning = false;
+
+	// Amount of jobs queued but not picked up by any thread yet
+	std::atomic<uint32_t> gQueued = 0;
+
+	// Lets idle workers sleep until jobs are available
+	std::mutex gSleepMutex;
+	std::condition_variable gJobsAvailable;
+
+	// Index of the current thread within the job system
+	thread_local uint32_t tThreadIndex = 0;
+
+	// Amount of nested jobs the current thread is executing, only the outermost job is measured
+	thread_local uint32_t tExecutionDepth = 0;
+
+	Counter::Counter() : pending(0),
+		mutex(),
+		dependents()
+	{
+	}
+
+	bool Counter::done() const
+	{
+		return pending.load(std::memory_order_acquire) == 0;
+	}
+
+	// Forward declaration
+	void _push(Task task);
+
+	// Marks one job tracked by the given counter as completed and launches the counters dependents once it reaches zero
+	void _complete(Counter& counter)
+	{
+		// Decrement while holding the counters mutex so waiting threads can't release the counter while it's still accessed
+		std::vector<std::pair<Job, Counter*>> dependents;
+		{
+			std::lock_guard<std::mutex> lock(counter.mutex);
+			if (counter.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				dependents.swap(counter.dependents);
+			}
+		}
+
+		// Launch dependents (their counters were incremented when they were queued)
+		for (auto& [job, dependentCounter] : dependents) {
+			_push({ std::move(job), dependentCounter });
+		}
+	}
+
+	// Executes the given task, measures its duration and completes its counter
+	void _execute(Task& task)
+	{
+		auto start = std::chrono::steady_clock::now();
+		tExecutionDepth++;
+		task.job();
+		tExecutionDepth--;
+
+		// Add duration to busy time of thread
+		if (tExecutionDepth == 0 && tThreadIndex < gQueues.size()) {
+			auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+			gQueues[tThreadIndex]->busyTime += static_cast<uint64_t>(duration.count());
+		}
+
+		if (task.counter) _complete(*task.counter);
+	}
+
+	// Queues the given task on the current threads queue
+	void _push(Task task)
+	{
+		// Execute task immediately if the job system isn't set up
+		if (gQueues.empty()) {
+			_execute(task);
+			return;
+		}
+
+		// Push task to the back of the current threads queue, counting it before it can be popped so the count never drops below zero
+		WorkQueue& queue = *gQueues[tThreadIndex];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			gQueued++;
+			queue.tasks.push_back(std::move(task));
+		}
+
+		// Wake an idle worker (lock sleep mutex so the notification can't get lost between a workers check and its wait)
+		{
+			std::lock_guard<std::mutex> lock(gSleepMutex);
+		}
+		gJobsAvailable.notify_one();
+	}
+
+	// Pops a task from the given threads queue or steals one from another thread, returns false if there are no tasks
+	bool _pop(uint32_t index, Task& task)
+	{
+		const uint32_t nQueues = static_cast<uint32_t>(gQueues.size());
+		if (index >= nQueues) return false;
+
+		// Pop newest task of own queue
+		{
+			WorkQueue& queue = *gQueues[index];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.tasks.empty()) {
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+				gQueued--;
+				return true;
+			}
+		}
+
+		// Steal oldest task of another threads queue
+		for (uint32_t offset = 1; offset < nQueues; offset++) {
+			WorkQueue& queue = *gQueues[(index + offset) % nQueues];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.tasks.empty()) {
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+				gQueued--;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Worker thread loop
+	void _worker(uint32_t index)
+	{
+		tThreadIndex = index;
+
+		while (true) {
+			// Execute next available task
+			Task task;
+			if (_pop(index, task)) {
+				_execute(task);
+				continue;
+			}
+
+			// Sleep until tasks are available or the job system shuts down
+			std::unique_lock<std::mutex> lock(gSleepMutex);
+			gJobsAvailable.wait(lock, []() { return gQueued > 0 || !gRunning; });
+			if (!gRunning && gQueued == 0) return;
+		}
+	}
+
+	void setup(uint32_t nWorkers)
+	{
+		// Job system is already set up
+		if (!gQueues.empty()) return;
+
+		// Use one worker per hardware thread besides the main thread by default
+		if (nWorkers == 0) {
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			nWorkers = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+		}
+
+		// Create queues for main thread and workers
+		for (uint32_t i = 0; i < nWorkers + 1; i++) {
+			gQueues.push_back(std::make_unique<WorkQueue>());
+		}
+
+		// Launch workers
+		tThreadIndex = 0;
+		gRunning = true;
+		for (uint32_t i = 0; i < nWorkers; i++) {
+			gWorkers.emplace_back(_worker, i + 1);
+		}
+	}
+
+	void shutdown()
+	{
+		// Job system isn't set up
+		if (gQueues.empty()) return;
+
+		// Finish jobs queued by the main thread
+		Task task;
+		while (_pop(0, task)) _execute(task);
+
+		// Stop workers once their queues are drained
+		{
+			std::lock_guard<std::mutex> lock(gSleepMutex);
+			gRunning = false;
+		}
+		gJobsAvailable.notify_all();
+		for (std::thread& worker : gWorkers) worker.join();
+
+		// Release workers and queues
+		gWorkers.clear();
+		gQueues.clear();
+	}
+
+	uint32_t getThreadCount()
+	{
+		return std::max(static_cast<uint32_t>(gQueues.size()), 1u);
+	}
+
+	void resetThreadTimes()
+	{
+		for (auto& queue : gQueues) queue->busyTime = 0;
+	}
+
+	double getThreadTime(uint32_t threadIndex)
+	{
+		if (threadIndex >= gQueues.size()) return 0.0;
+		return gQueues[threadIndex]->busyTime * 0.001;
+	}
+
+	uint32_t getThreadIndex()
+	{
+		return tThreadIndex;
+	}
+
+	void run(Job job, Counter* counter)
+	{
+		if (counter) counter->pending++;
+		_push({ std::move(job), counter });
+	}
+
+	void runAfter(Counter& dependency, Job job, Counter* counter)
+	{
+		if (counter) counter->pending++;
+
+		// Defer job until dependency is completed
+		{
+			std::lock_guard<std::mutex> lock(dependency.mutex);
+			if (!dependency.done()) {
+				dependency.dependents.emplace_back(std::move(job), counter);
+				return;
+			}
+		}
+
+		// Dependency is completed already, queue job right away
+		_push({ std::move(job), counter });
+	}
+
+	void wait(Counter& counter)
+	{
+		// Help executing jobs until counter reaches zero
+		while (!counter.done()) {
+			Task task;
+			if (_pop(tThreadIndex, task)) {
+				_execute(task);
+			}
+			else {
+				std::this_thread::yield();
+			}
+		}
+
+		// Make sure the thread completing the last job released the counter
+		std::lock_guard<std::mutex> lock(counter.mutex);
+	}
+
+	void parallelFor(uint32_t count, uint32_t batchSize, const RangeJob& job)
+	{
+		if (count == 0) return;
+		batchSize = std::max(batchSize, 1u);
+
+		// Execute on calling thread if there are no workers or only one batch
+		if (gWorkers.empty() || count <= batchSize) {
+			Task task = { [&job, count]() { job(0, count); } };
+			_execute(task);
+			return;
+		}
+
+		// Queue all but the first batch
+		Counter counter;
+		for (uint32_t begin = batchSize; begin < count; begin += batchSize) {
+			uint32_t end = std::min(begin + batchSize, count);
+			run([&job, begin, end]() { job(begin, end); }, &counter);
+		}
+
+		// Execute first batch on calling thread and wait for the others
+		Task first = { [&job, batchSize]() { job(0, batchSize); } };
+		_execute(first);
+		wait(counter);
+	}
+
+}
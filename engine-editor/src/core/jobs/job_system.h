@@ -0,0 +1,82 @@
+#pragma once
+
+#include <tuple>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+namespace JobSystem
+{
+
+	// Function executed by a job
+	using Job = std::function<void()>;
+
+	// Function executed by a parallel for job for the range [begin, end)
+	using RangeJob = std::function<void(uint32_t begin, uint32_t end)>;
+
+	// Tracks completion of a group of jobs, jobs may depend on a counter to be launched once it reaches zero
+	struct Counter
+	{
+		Counter();
+
+		// Returns true if all jobs tracked by the counter are completed
+		bool done() const;
+
+		// Amount of jobs tracked which are not completed yet
+		std::atomic<uint32_t> pending;
+
+		// Guards the dependents
+		std::mutex mutex;
+
+		// Jobs waiting for the counter to reach zero
+		std::vector<std::pair<Job, Counter*>> dependents;
+	};
+
+	// Sets up the job system with the given amount of worker threads (zero picks one worker per hardware thread besides the main thread)
+	void setup(uint32_t nWorkers = 0);
+
+	// Finishes all queued jobs and shuts the worker threads down
+	void shutdown();
+
+	// Returns the amount of threads executing jobs, including the main thread
+	uint32_t getThreadCount();
+
+	// Resets the time each thread spent executing jobs
+	void resetThreadTimes();
+
+	// Returns the time the thread with the given index spent executing jobs since the last reset in microseconds
+	double getThreadTime(uint32_t threadIndex);
+
+	// Returns the index of the calling thread within the job system (main thread is zero, threads outside the job system return the main threads index)
+	uint32_t getThreadIndex();
+
+	// Queues a job, the optional counter is incremented until the job is completed
+	void run(Job job, Counter* counter = nullptr);
+
+	// Queues a job to be launched once the given dependency counter reaches zero, the optional counter is incremented until the job is completed
+	void runAfter(Counter& dependency, Job job, Counter* counter = nullptr);
+
+	// Blocks until the given counter reaches zero, executing queued jobs meanwhile
+	void wait(Counter& counter);
+
+	// Splits the range [0, count) into batches of the given size and executes them in parallel, blocking until all batches are completed
+	void parallelFor(uint32_t count, uint32_t batchSize, const RangeJob& job);
+
+	// Executes the given function for each entity of an entt view in parallel like view.each(), blocking until all entities are processed
+	template <typename View, typename Function>
+	void parallelEach(const View& view, Function function, uint32_t batchSize = 64)
+	{
+		// Snapshot entities of view so they can be accessed by index
+		std::vector<typename View::entity_type> entities(view.begin(), view.end());
+
+		// Process entities in batches
+		parallelFor(static_cast<uint32_t>(entities.size()), batchSize, [&](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; i++) {
+				std::apply(function, std::tuple_cat(std::make_tuple(entities[i]), view.get(entities[i])));
+			}
+		});
+	}
+
+};
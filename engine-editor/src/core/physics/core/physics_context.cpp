@@ -2,6 +2,7 @@
 
 #include "../src/core/utils/console.h"
 #include "../src/core/ecs/ecs_collection.h"
+#include "../src/core/jobs/job_system.h"
 #include "../src/core/diagnostics/profiler.h"
 #include "../src/core/physics/utils/px_translator.h"
 
@@ -11,7 +12,7 @@ PhysicsContext::PhysicsContext() : allocator(),
 errorCallback(),
 foundation(nullptr),
 physics(nullptr),
-dispatcher(nullptr),
+dispatcher(),
 scene(nullptr),
 pvd(nullptr),
 bridge(physics, scene),
@@ -29,12 +30,11 @@ void PhysicsContext::create()
 	PxPvdTransport* transport = PxDefaultPvdSocketTransportCreate("127.0.0.1", 5425, 10);
 	pvd->connect(*transport, PxPvdInstrumentationFlag::eALL);
 	physics = PxCreatePhysics(PX_PHYSICS_VERSION, *foundation, PxTolerancesScale(), true, pvd);
-	dispatcher = PxDefaultCpuDispatcherCreate(2);
 
 	// Create scene
 	PxSceneDesc sceneDescription(physics->getTolerancesScale());
 	sceneDescription.gravity = gravity;
-	sceneDescription.cpuDispatcher = dispatcher;
+	sceneDescription.cpuDispatcher = &dispatcher;
 	sceneDescription.filterShader = PxDefaultSimulationFilterShader;
 	scene = physics->createScene(sceneDescription);
 
@@ -67,7 +67,6 @@ void PhysicsContext::create()
 void PhysicsContext::destroy()
 {
 	PX_RELEASE(scene);
-	PX_RELEASE(dispatcher);
 	PX_RELEASE(physics);
 	if (pvd) {
 		PxPvdTransport* transport = pvd->getTransport();
@@ -112,11 +111,11 @@ void PhysicsContext::simulate(float delta)
 	scene->simulate(timeStep);
 	scene->fetchResults(true);
 
-	// Sync rigidbody components
+	// Sync rigidbody components in parallel (only reads from physx actors)
 	auto view = ECS::gRegistry.view<RigidbodyComponent>();
-	for (auto [entity, rigidbody] : view.each()) {
+	JobSystem::parallelEach(view, [this](Entity, RigidbodyComponent& rigidbody) {
 		syncRigidbodyComponent(rigidbody);
-	}
+	});
 }
 
 void PhysicsContext::syncRigidbodyComponent(RigidbodyComponent& rigidbody)
@@ -4,6 +4,7 @@
 #include <glm.hpp>
 
 #include "../src/core/physics/core/physics_bridge.h"
+#include "../src/core/physics/utils/px_job_dispatcher.h"
 
 class PhysicsContext
 {
@@ -34,7 +35,7 @@ private:
 	physx::PxDefaultErrorCallback errorCallback;
 	physx::PxFoundation* foundation;
 	physx::PxPhysics* physics;
-	physx::PxDefaultCpuDispatcher* dispatcher;
+	PxJobDispatcher dispatcher;
 	physx::PxScene* scene;
 	physx::PxPvd* pvd;
 
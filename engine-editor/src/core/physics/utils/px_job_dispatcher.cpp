@@ -0,0 +1,24 @@
+#include "px_job_dispatcher.h"
+
+#include "../src/core/jobs/job_system.h"
+
+void PxJobDispatcher::submitTask(physx::PxBaseTask& task)
+{
+	// Run task inline if there are no workers, the main thread blocks inside physx while fetching results
+	if (JobSystem::getThreadCount() <= 1) {
+		task.run();
+		task.release();
+		return;
+	}
+
+	// Queue task
+	JobSystem::run([&task]() {
+		task.run();
+		task.release();
+	});
+}
+
+uint32_t PxJobDispatcher::getWorkerCount() const
+{
+	return JobSystem::getThreadCount();
+}
@@ -1,5 +1,6 @@
 #include "bounding_volume.h"
 
+#include <algorithm>
 #include <gtc/type_ptr.hpp>
 
 #include "../src/core/rendering/transformation/transformation.h"
@@ -26,9 +27,12 @@ void BoundingSphere::update(Model* model, glm::vec3 position, glm::quat rotation
 	radius = (metrics.furthest * 0.5f) * std::max({ scale.x, scale.y, scale.z });
 }
 
-bool BoundingSphere::intersectsFrustum()
+bool BoundingSphere::intersectsFrustum(const FrustumCulling::Frustum& frustum)
 {
-	// Always intersects
+	// Sphere is outside if it is fully behind any plane
+	for (const glm::vec4& plane : frustum.planes) {
+		if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+	}
 	return true;
 }
 
@@ -81,9 +85,18 @@ void BoundingAABB::update(Model* model, glm::vec3 position, glm::quat rotation,
 	max = _max;
 }
 
-bool BoundingAABB::intersectsFrustum()
+bool BoundingAABB::intersectsFrustum(const FrustumCulling::Frustum& frustum)
 {
-	// Always intersects
+	glm::vec3 center = (min + max) * 0.5f;
+	glm::vec3 extents = (max - min) * 0.5f;
+
+	// AABB is outside if its projected radius is fully behind any plane
+	for (const glm::vec4& plane : frustum.planes) {
+		glm::vec3 normal = glm::vec3(plane);
+		float distance = glm::dot(normal, center) + plane.w;
+		float radius = glm::dot(glm::abs(normal), extents);
+		if (distance + radius < 0.0f) return false;
+	}
 	return true;
 }
 
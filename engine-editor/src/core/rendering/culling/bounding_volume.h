@@ -4,6 +4,7 @@
 #include <gtc/quaternion.hpp>
 
 #include "../src/core/rendering/gizmos/gizmos.h"
+#include "../src/core/rendering/culling/frustum_culling.h"
 
 class Model;
 
@@ -11,7 +12,7 @@ class BoundingVolume
 {
 public:
 	virtual void update(Model* model, glm::vec3 position, glm::quat rotation, glm::vec3 scale) {};
-	virtual bool intersectsFrustum() { return false; };
+	virtual bool intersectsFrustum(const FrustumCulling::Frustum& /*frustum*/) { return false; };
 	virtual float getDistance(glm::vec3 point) { return 0.0f; }
 	virtual void draw(IMGizmo& imGizmoInstance, glm::vec4 color) {};
 };
@@ -22,7 +23,7 @@ public:
 	BoundingSphere();
 
 	void update(Model* model, glm::vec3 position, glm::quat rotation, glm::vec3 scale);
-	bool intersectsFrustum();
+	bool intersectsFrustum(const FrustumCulling::Frustum& frustum);
 	float getDistance(glm::vec3 point);
 	void draw(IMGizmo& imGizmoInstance, glm::vec4 color);
 
@@ -36,7 +37,7 @@ public:
 	BoundingAABB();
 
 	void update(Model* model, glm::vec3 position, glm::quat rotation, glm::vec3 scale);
-	bool intersectsFrustum();
+	bool intersectsFrustum(const FrustumCulling::Frustum& frustum);
 	float getDistance(glm::vec3 point);
 	void draw(IMGizmo& imGizmoInstance, glm::vec4 color);
 
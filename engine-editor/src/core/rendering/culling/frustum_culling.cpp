@@ -0,0 +1,196 @@
+#include "frustum_culling.h"
+
+#include <cmath>
+#include <immintrin.h>
+
+namespace FrustumCulling {
+
+	void BoundsBatch::clear()
+	{
+		centerX.clear();
+		centerY.clear();
+		centerZ.clear();
+		extentX.clear();
+		extentY.clear();
+		extentZ.clear();
+	}
+
+	void BoundsBatch::reserve(size_t capacity)
+	{
+		centerX.reserve(capacity);
+		centerY.reserve(capacity);
+		centerZ.reserve(capacity);
+		extentX.reserve(capacity);
+		extentY.reserve(capacity);
+		extentZ.reserve(capacity);
+	}
+
+	void BoundsBatch::resize(size_t size)
+	{
+		centerX.resize(size);
+		centerY.resize(size);
+		centerZ.resize(size);
+		extentX.resize(size);
+		extentY.resize(size);
+		extentZ.resize(size);
+	}
+
+	void BoundsBatch::add(const glm::vec3& min, const glm::vec3& max)
+	{
+		glm::vec3 center = (min + max) * 0.5f;
+		glm::vec3 extent = (max - min) * 0.5f;
+
+		centerX.push_back(center.x);
+		centerY.push_back(center.y);
+		centerZ.push_back(center.z);
+		extentX.push_back(extent.x);
+		extentY.push_back(extent.y);
+		extentZ.push_back(extent.z);
+	}
+
+	void BoundsBatch::set(size_t index, const glm::vec3& min, const glm::vec3& max)
+	{
+		glm::vec3 center = (min + max) * 0.5f;
+		glm::vec3 extent = (max - min) * 0.5f;
+
+		centerX[index] = center.x;
+		centerY[index] = center.y;
+		centerZ[index] = center.z;
+		extentX[index] = extent.x;
+		extentY[index] = extent.y;
+		extentZ[index] = extent.z;
+	}
+
+	size_t BoundsBatch::size() const
+	{
+		return centerX.size();
+	}
+
+	Frustum extract(const glm::mat4& viewProjection)
+	{
+		// Rows of the view-projection matrix (glm matrices are column major)
+		const glm::mat4& m = viewProjection;
+		glm::vec4 row0 = glm::vec4(m[0][0], m[1][0], m[2][0], m[3][0]);
+		glm::vec4 row1 = glm::vec4(m[0][1], m[1][1], m[2][1], m[3][1]);
+		glm::vec4 row2 = glm::vec4(m[0][2], m[1][2], m[2][2], m[3][2]);
+		glm::vec4 row3 = glm::vec4(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+		// Extract clip planes (Gribb-Hartmann, opengl clip space from -w to w)
+		Frustum frustum;
+		frustum.planes[Frustum::LEFT_PLANE] = row3 + row0;
+		frustum.planes[Frustum::RIGHT_PLANE] = row3 - row0;
+		frustum.planes[Frustum::BOTTOM_PLANE] = row3 + row1;
+		frustum.planes[Frustum::TOP_PLANE] = row3 - row1;
+		frustum.planes[Frustum::NEAR_PLANE] = row3 + row2;
+		frustum.planes[Frustum::FAR_PLANE] = row3 - row2;
+
+		// Normalize planes so plane distances are in world units
+		for (glm::vec4& plane : frustum.planes) {
+			float length = glm::length(glm::vec3(plane));
+			if (length > 0.0f) plane /= length;
+		}
+
+		return frustum;
+	}
+
+	// Tests a single bounding box against the frustum
+	bool _testScalar(const Frustum& frustum, const BoundsBatch& batch, size_t i)
+	{
+		for (const glm::vec4& plane : frustum.planes) {
+			float distance = plane.x * batch.centerX[i] + plane.y * batch.centerY[i] + plane.z * batch.centerZ[i] + plane.w;
+			float radius = std::abs(plane.x) * batch.extentX[i] + std::abs(plane.y) * batch.extentY[i] + std::abs(plane.z) * batch.extentZ[i];
+			if (distance + radius < 0.0f) return false;
+		}
+		return true;
+	}
+
+	void test(const Frustum& frustum, const BoundsBatch& batch, std::vector<uint32_t>& visible)
+	{
+		visible.clear();
+
+		const size_t n = batch.size();
+		size_t i = 0;
+
+#if defined(__AVX__)
+		// Broadcast plane components and their absolutes once
+		__m256 planeX[Frustum::N_PLANES], planeY[Frustum::N_PLANES], planeZ[Frustum::N_PLANES], planeW[Frustum::N_PLANES];
+		__m256 absX[Frustum::N_PLANES], absY[Frustum::N_PLANES], absZ[Frustum::N_PLANES];
+		for (int p = 0; p < Frustum::N_PLANES; p++) {
+			const glm::vec4& plane = frustum.planes[p];
+			planeX[p] = _mm256_set1_ps(plane.x);
+			planeY[p] = _mm256_set1_ps(plane.y);
+			planeZ[p] = _mm256_set1_ps(plane.z);
+			planeW[p] = _mm256_set1_ps(plane.w);
+			absX[p] = _mm256_set1_ps(std::abs(plane.x));
+			absY[p] = _mm256_set1_ps(std::abs(plane.y));
+			absZ[p] = _mm256_set1_ps(std::abs(plane.z));
+		}
+		const __m256 zero = _mm256_setzero_ps();
+
+		// Test eight bounds at once
+		for (; i + 8 <= n; i += 8) {
+			__m256 cx = _mm256_loadu_ps(&batch.centerX[i]);
+			__m256 cy = _mm256_loadu_ps(&batch.centerY[i]);
+			__m256 cz = _mm256_loadu_ps(&batch.centerZ[i]);
+			__m256 ex = _mm256_loadu_ps(&batch.extentX[i]);
+			__m256 ey = _mm256_loadu_ps(&batch.extentY[i]);
+			__m256 ez = _mm256_loadu_ps(&batch.extentZ[i]);
+
+			__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (int p = 0; p < Frustum::N_PLANES; p++) {
+				__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX[p], cx), _mm256_mul_ps(planeY[p], cy)), _mm256_add_ps(_mm256_mul_ps(planeZ[p], cz), planeW[p]));
+				__m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(absX[p], ex), _mm256_mul_ps(absY[p], ey)), _mm256_mul_ps(absZ[p], ez));
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+			}
+
+			int mask = _mm256_movemask_ps(inside);
+			for (uint32_t lane = 0; lane < 8; lane++) {
+				if (mask & (1 << lane)) visible.push_back(static_cast<uint32_t>(i + lane));
+			}
+		}
+#else
+		// Broadcast plane components and their absolutes once
+		__m128 planeX[Frustum::N_PLANES], planeY[Frustum::N_PLANES], planeZ[Frustum::N_PLANES], planeW[Frustum::N_PLANES];
+		__m128 absX[Frustum::N_PLANES], absY[Frustum::N_PLANES], absZ[Frustum::N_PLANES];
+		for (int p = 0; p < Frustum::N_PLANES; p++) {
+			const glm::vec4& plane = frustum.planes[p];
+			planeX[p] = _mm_set1_ps(plane.x);
+			planeY[p] = _mm_set1_ps(plane.y);
+			planeZ[p] = _mm_set1_ps(plane.z);
+			planeW[p] = _mm_set1_ps(plane.w);
+			absX[p] = _mm_set1_ps(std::abs(plane.x));
+			absY[p] = _mm_set1_ps(std::abs(plane.y));
+			absZ[p] = _mm_set1_ps(std::abs(plane.z));
+		}
+		const __m128 zero = _mm_setzero_ps();
+
+		// Test four bounds at once
+		for (; i + 4 <= n; i += 4) {
+			__m128 cx = _mm_loadu_ps(&batch.centerX[i]);
+			__m128 cy = _mm_loadu_ps(&batch.centerY[i]);
+			__m128 cz = _mm_loadu_ps(&batch.centerZ[i]);
+			__m128 ex = _mm_loadu_ps(&batch.extentX[i]);
+			__m128 ey = _mm_loadu_ps(&batch.extentY[i]);
+			__m128 ez = _mm_loadu_ps(&batch.extentZ[i]);
+
+			__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (int p = 0; p < Frustum::N_PLANES; p++) {
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], cx), _mm_mul_ps(planeY[p], cy)), _mm_add_ps(_mm_mul_ps(planeZ[p], cz), planeW[p]));
+				__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absX[p], ex), _mm_mul_ps(absY[p], ey)), _mm_mul_ps(absZ[p], ez));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+			}
+
+			int mask = _mm_movemask_ps(inside);
+			for (uint32_t lane = 0; lane < 4; lane++) {
+				if (mask & (1 << lane)) visible.push_back(static_cast<uint32_t>(i + lane));
+			}
+		}
+#endif
+
+		// Test remaining bounds one by one
+		for (; i < n; i++) {
+			if (_testScalar(frustum, batch, i)) visible.push_back(static_cast<uint32_t>(i));
+		}
+	}
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <glm.hpp>
+
+#include "../src/core/rendering/uniforms/storage_buffer.h"
+
+class LightUniforms;
+
+// Froxel grid of a view listing the point lights and spotlights reaching each cluster, shared by all lit shaders through the "LightClusters" and "LightIndices" storage blocks
+class LightClusters
+{
+public:
+	LightClusters();
+
+	// Creates the clusters storage buffers
+	void create();
+
+	// Destroys the clusters storage buffers
+	void destroy();
+
+	// Assigns the point lights and spotlights of the given light uniforms to the clusters of the given view, uploads them and binds them for all upcoming draws
+	void update(const LightUniforms& lights, const glm::mat4& view, const glm::mat4& projection, const glm::vec2& resolution);
+
+	// Binds the clusters for all upcoming draws
+	void bind() const;
+
+	// Size of a clusters screen tile in pixels
+	static constexpr uint32_t TILE_SIZE = 64;
+
+	// Amount of logarithmically spaced depth slices between the near and far plane
+	static constexpr uint32_t SLICES = 24;
+
+private:
+	// Layout of the storage blocks header (std430), followed by the clusters
+	struct Header {
+		glm::uvec4 grid; // Amount of clusters along x, y and z and tile size
+		glm::vec4 slicing; // Scale and bias mapping the logarithm of view depth to slices
+	};
+
+	// Layout of a cluster (std430)
+	struct Cluster {
+		uint32_t offset; // Offset of the clusters point light indices followed by its spotlight indices
+		uint32_t pointLights;
+		uint32_t spotlights;
+		uint32_t _padding;
+	};
+
+	// View space bounding sphere of a light and the range of clusters it overlaps
+	struct LightBounds {
+		glm::vec3 center;
+		float radius;
+		uint32_t firstSlice;
+		uint32_t lastSlice;
+		glm::uvec2 firstTile;
+		glm::uvec2 lastTile;
+	};
+
+	// Lights assigned to the clusters of a single slice
+	struct SliceBins {
+		// Tile and light of each overlap found
+		std::vector<std::pair<uint32_t, uint32_t>> hits;
+
+		// Light indices sorted by tile and the clusters of the tiles referring to them
+		std::vector<uint32_t> indices;
+		std::vector<Cluster> clusters;
+
+		// Amount of indices sorted into each tile so far
+		std::vector<uint32_t> filled;
+	};
+
+	// Amount of clusters the header occupies in the cluster storage block
+	static constexpr uint32_t HEADER_CLUSTERS = sizeof(Header) / sizeof(Cluster);
+
+	// Storage buffers holding the cluster grid and the light indices of the clusters
+	StorageBuffer clusterBuffer;
+	StorageBuffer indexBuffer;
+
+	// Scratch buffers, reused across updates
+	std::vector<LightBounds> bounds;
+	std::vector<SliceBins> slices;
+	std::vector<Cluster> clusters;
+	std::vector<uint32_t> indices;
+
+	// Collects the lights overlapping the clusters of the given slice of a view with the given size in pixels, bounds past the given amount of point lights belong to spotlights
+	void binSlice(uint32_t slice, uint32_t nPointLights, glm::uvec2 tiles, glm::vec2 size, const glm::mat4& projection, float near, float far);
+};
@@ -0,0 +1,126 @@
+#include "occlusion_culling.h"
+
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+
+namespace OcclusionCulling {
+
+	// Minimum clip space w of bound corners, bounds reaching closer to the pyramids view can't be tested
+	constexpr float MIN_CLIP_W = 1e-4f;
+
+	// Returns the texel of the given window space coordinate within a level of the given size
+	int32_t _getTexel(float coordinate, uint32_t size)
+	{
+		return static_cast<int32_t>(std::floor(coordinate * static_cast<float>(size)));
+	}
+
+	void DepthPyramid::build(const float* depths, uint32_t width, uint32_t height, const glm::mat4& _viewProjection)
+	{
+		viewProjection = _viewProjection;
+		if (!depths || width == 0 || height == 0) {
+			levels.clear();
+			return;
+		}
+
+		// Count levels down to a single texel
+		uint32_t nLevels = 1;
+		while ((std::max(width, height) >> nLevels) > 0) nLevels++;
+		levels.resize(nLevels);
+
+		// Copy finest level
+		levels[0].width = width;
+		levels[0].height = height;
+		levels[0].depths.assign(depths, depths + static_cast<size_t>(width) * height);
+
+		// Reduce each further level from the previous one
+		for (uint32_t i = 1; i < nLevels; i++) {
+			const Level& previous = levels[i - 1];
+			Level& level = levels[i];
+			level.width = std::max(previous.width / 2, 1u);
+			level.height = std::max(previous.height / 2, 1u);
+			level.depths.resize(static_cast<size_t>(level.width) * level.height);
+
+			for (uint32_t y = 0; y < level.height; y++) {
+				// Last row also covers the remaining row of odd sized levels
+				uint32_t yEnd = y + 1 == level.height ? previous.height - 1 : std::min(y * 2 + 1, previous.height - 1);
+				for (uint32_t x = 0; x < level.width; x++) {
+					uint32_t xEnd = x + 1 == level.width ? previous.width - 1 : std::min(x * 2 + 1, previous.width - 1);
+
+					float depth = 0.0f;
+					for (uint32_t sy = y * 2; sy <= yEnd; sy++) {
+						for (uint32_t sx = x * 2; sx <= xEnd; sx++) {
+							depth = std::max(depth, previous.depths[static_cast<size_t>(sy) * previous.width + sx]);
+						}
+					}
+					level.depths[static_cast<size_t>(y) * level.width + x] = depth;
+				}
+			}
+		}
+	}
+
+	bool DepthPyramid::empty() const
+	{
+		return levels.empty();
+	}
+
+	bool isOccluded(const DepthPyramid& pyramid, const FrustumCulling::BoundsBatch& batch, size_t index)
+	{
+		if (pyramid.empty()) return false;
+
+		//
+		// REPROJECT BOUNDS
+		//
+
+		glm::vec3 center = glm::vec3(batch.centerX[index], batch.centerY[index], batch.centerZ[index]);
+		glm::vec3 extent = glm::vec3(batch.extentX[index], batch.extentY[index], batch.extentZ[index]);
+
+		// Project corners into the pyramids view, keeping their screen rectangle and nearest depth
+		glm::vec2 rectMin = glm::vec2(FLT_MAX);
+		glm::vec2 rectMax = glm::vec2(-FLT_MAX);
+		float nearest = FLT_MAX;
+		for (uint32_t corner = 0; corner < 8; corner++) {
+			glm::vec3 sign = glm::vec3(corner & 1 ? 1.0f : -1.0f, corner & 2 ? 1.0f : -1.0f, corner & 4 ? 1.0f : -1.0f);
+			glm::vec4 clip = pyramid.viewProjection * glm::vec4(center + extent * sign, 1.0f);
+			if (clip.w <= MIN_CLIP_W) return false;
+
+			glm::vec3 ndc = glm::vec3(clip) / clip.w;
+			rectMin = glm::min(rectMin, glm::vec2(ndc));
+			rectMax = glm::max(rectMax, glm::vec2(ndc));
+			nearest = std::min(nearest, ndc.z * 0.5f + 0.5f);
+		}
+
+		// Bounds reaching outside of the pyramids view may be visible where there are no depths
+		if (rectMin.x < -1.0f || rectMin.y < -1.0f || rectMax.x > 1.0f || rectMax.y > 1.0f) return false;
+
+		//
+		// TEST AGAINST PYRAMID
+		//
+
+		// Texels of the finest level covered, widened by a texel as pyramid levels don't align with pixels exactly
+		const DepthPyramid::Level& finest = pyramid.levels[0];
+		int32_t x0 = std::max(_getTexel(rectMin.x * 0.5f + 0.5f, finest.width) - 1, 0);
+		int32_t y0 = std::max(_getTexel(rectMin.y * 0.5f + 0.5f, finest.height) - 1, 0);
+		int32_t x1 = std::min(_getTexel(rectMax.x * 0.5f + 0.5f, finest.width) + 1, static_cast<int32_t>(finest.width) - 1);
+		int32_t y1 = std::min(_getTexel(rectMax.y * 0.5f + 0.5f, finest.height) + 1, static_cast<int32_t>(finest.height) - 1);
+
+		// Pick the level the rectangle covers at most two texels per axis of
+		uint32_t levelIndex = 0;
+		while (levelIndex + 1 < pyramid.levels.size() && ((x1 >> levelIndex) - (x0 >> levelIndex) > 1 || (y1 >> levelIndex) - (y0 >> levelIndex) > 1)) levelIndex++;
+
+		// Get maximum depth behind the rectangle (last texels of a level also cover the remainders of odd sized finer levels)
+		const DepthPyramid::Level& level = pyramid.levels[levelIndex];
+		int32_t lastX = static_cast<int32_t>(level.width) - 1;
+		int32_t lastY = static_cast<int32_t>(level.height) - 1;
+		float farthest = 0.0f;
+		for (int32_t y = std::min(y0 >> levelIndex, lastY); y <= std::min(y1 >> levelIndex, lastY); y++) {
+			for (int32_t x = std::min(x0 >> levelIndex, lastX); x <= std::min(x1 >> levelIndex, lastX); x++) {
+				farthest = std::max(farthest, level.depths[static_cast<size_t>(y) * level.width + x]);
+			}
+		}
+
+		// Occluded if the bounds are behind everything drawn over them
+		return nearest > farthest;
+	}
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm.hpp>
+
+#include "../src/core/rendering/culling/frustum_culling.h"
+
+namespace OcclusionCulling
+{
+	// Pyramid of maximum depths of a previously rendered depth buffer, testing bounds against the depth they would have been drawn at
+	struct DepthPyramid
+	{
+		// Single level of the pyramid, each texel holding the maximum window space depth of the texels it covers in the finer level
+		struct Level
+		{
+			uint32_t width = 0;
+			uint32_t height = 0;
+			std::vector<float> depths;
+		};
+
+		// View projection the depth buffer was rendered with, bounds are reprojected with it
+		glm::mat4 viewProjection = glm::mat4(1.0f);
+
+		std::vector<Level> levels;
+
+		// Builds the pyramid from the given maximum depths (rows bottom to top) rendered with the given view projection
+		void build(const float* depths, uint32_t width, uint32_t height, const glm::mat4& viewProjection);
+
+		// Returns if the pyramid holds no depths
+		bool empty() const;
+	};
+
+	// Returns if the bounds of the batch at the given index are hidden behind the depths of the pyramid
+	bool isOccluded(const DepthPyramid& pyramid, const FrustumCulling::BoundsBatch& batch, size_t index);
+};
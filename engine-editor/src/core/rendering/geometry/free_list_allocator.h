@@ -0,0 +1,36 @@
+#pragma once
+
+#include <map>
+#include <cstdint>
+
+// Sub-allocates ranges of elements from a linear region using a first fit free list
+class FreeListAllocator
+{
+public:
+	// Offset returned if an allocation doesn't fit
+	static constexpr uint32_t INVALID_OFFSET = UINT32_MAX;
+
+	explicit FreeListAllocator(uint32_t capacity = 0);
+
+	// Allocates a range of the given amount of elements and returns its offset or INVALID_OFFSET if there is no free range large enough
+	uint32_t allocate(uint32_t count);
+
+	// Releases the range of the given amount of elements at the given offset, merging it with adjacent free ranges
+	void release(uint32_t offset, uint32_t count);
+
+	// Extends the region to the given capacity, the added elements are free
+	void grow(uint32_t capacity);
+
+	// Returns the amount of elements in the region
+	uint32_t getCapacity() const;
+
+	// Returns the amount of allocated elements
+	uint32_t getUsed() const;
+
+private:
+	// Free ranges by offset mapped to their amount of elements
+	std::map<uint32_t, uint32_t> freeRanges;
+
+	uint32_t capacity;
+	uint32_t used;
+};
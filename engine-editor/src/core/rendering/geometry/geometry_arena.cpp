@@ -0,0 +1,292 @@
+#include "geometry_arena.h"
+
+#include <cstddef>
+#include <algorithm>
+#include <glad/glad.h>
+#include <gtc/packing.hpp>
+#include <gtc/matrix_transform.hpp>
+
+#include "../src/core/rendering/instancing/instancing.h"
+#include "../src/core/rendering/geometry/free_list_allocator.h"
+
+namespace GeometryArena {
+
+	// Initial capacities of the arena buffers in elements
+	constexpr uint32_t INITIAL_VERTEX_CAPACITY = 1 << 18;
+	constexpr uint32_t INITIAL_INDEX_CAPACITY = 1 << 20;
+
+	uint32_t gVao = 0;
+	uint32_t gVertexBuffer = 0;
+	uint32_t gShortIndexBuffer = 0;
+	uint32_t gIndexBuffer = 0;
+
+	FreeListAllocator gVertexAllocator;
+	FreeListAllocator gShortIndexAllocator;
+	FreeListAllocator gIndexAllocator;
+
+	// Index type of the index buffer currently bound to the vao
+	IndexType gBoundIndexType = IndexType::UINT32;
+
+	static_assert(sizeof(Vertex) == 20, "Packed vertex layout must stay tightly packed");
+
+	// Returns the octahedral encoding of the given unit vector within [-1, 1]
+	glm::vec2 _octEncode(glm::vec3 v)
+	{
+		// Project onto octahedron
+		v /= glm::abs(v.x) + glm::abs(v.y) + glm::abs(v.z);
+		glm::vec2 encoded = glm::vec2(v.x, v.y);
+
+		// Fold lower hemisphere over the diagonals
+		if (v.z < 0.0f) {
+			glm::vec2 signs = glm::vec2(encoded.x >= 0.0f ? 1.0f : -1.0f, encoded.y >= 0.0f ? 1.0f : -1.0f);
+			encoded = (1.0f - glm::abs(glm::vec2(encoded.y, encoded.x))) * signs;
+		}
+
+		return encoded;
+	}
+
+	// Returns the given value within [-1, 1] as a 16-bit signed normalized value
+	int16_t _snorm16(float value)
+	{
+		return static_cast<int16_t>(glm::packSnorm1x16(value));
+	}
+
+	// Returns the given value within [0, 1] as a 16-bit unsigned normalized value
+	uint16_t _unorm16(float value)
+	{
+		return static_cast<uint16_t>(glm::round(glm::clamp(value, 0.0f, 1.0f) * 65535.0f));
+	}
+
+	Vertex pack(glm::vec3 position, glm::vec3 normal, glm::vec2 uv, glm::vec3 tangent, glm::vec3 bitangent, glm::vec3 minPoint, glm::vec3 maxPoint)
+	{
+		Vertex vertex;
+
+		// Quantize position within bounding box (flat axes collapse to the minimum)
+		glm::vec3 extents = maxPoint - minPoint;
+		for (uint32_t i = 0; i < 3; i++) {
+			vertex.position[i] = _unorm16(extents[i] > 0.0f ? (position[i] - minPoint[i]) / extents[i] : 0.0f);
+		}
+
+		// Encode normal (degenerate normals fall back to up)
+		if (glm::dot(normal, normal) <= 0.0f) normal = glm::vec3(0.0f, 0.0f, 1.0f);
+		glm::vec2 encodedNormal = _octEncode(glm::normalize(normal));
+		vertex.normal[0] = _snorm16(encodedNormal.x);
+		vertex.normal[1] = _snorm16(encodedNormal.y);
+
+		// Encode tangent (degenerate tangents fall back to any vector perpendicular to the normal)
+		if (glm::dot(tangent, tangent) <= 0.0f) tangent = glm::abs(normal.x) < 0.9f ? glm::cross(normal, glm::vec3(1.0f, 0.0f, 0.0f)) : glm::cross(normal, glm::vec3(0.0f, 1.0f, 0.0f));
+		glm::vec2 encodedTangent = _octEncode(glm::normalize(tangent));
+		vertex.tangent[0] = _snorm16(encodedTangent.x);
+		vertex.tangent[1] = _snorm16(encodedTangent.y);
+
+		// Bitangent is reconstructed from normal and tangent, only its handedness is stored
+		vertex.bitangentSign = _snorm16(glm::dot(glm::cross(normal, tangent), bitangent) < 0.0f ? -1.0f : 1.0f);
+
+		// Convert texture coordinates to half floats
+		vertex.uv[0] = glm::packHalf1x16(uv.x);
+		vertex.uv[1] = glm::packHalf1x16(uv.y);
+
+		return vertex;
+	}
+
+	glm::mat4 getDequantization(glm::vec3 minPoint, glm::vec3 maxPoint)
+	{
+		glm::mat4 translation = glm::translate(glm::mat4(1.0f), minPoint);
+		return glm::scale(translation, glm::max(maxPoint - minPoint, glm::vec3(0.0f)));
+	}
+
+	uint32_t getElementType(IndexType type)
+	{
+		return type == IndexType::UINT16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	}
+
+	uint32_t getIndexSize(IndexType type)
+	{
+		return type == IndexType::UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+	}
+
+	const void* bufferOffset(size_t offset)
+	{
+		return reinterpret_cast<const void*>(static_cast<uintptr_t>(offset));
+	}
+
+	// Points the vertex attributes of the arena vao to the current vertex buffer
+	void _setupVertexAttributes()
+	{
+		glBindVertexArray(gVao);
+		glBindBuffer(GL_ARRAY_BUFFER, gVertexBuffer);
+
+		// Quantized position attribute (location = 0)
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(Vertex), bufferOffset(offsetof(Vertex, position)));
+		// Octahedral normal attribute (location = 1)
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(Vertex), bufferOffset(offsetof(Vertex, normal)));
+		// Half float texture coordinates attribute (location = 2)
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(Vertex), bufferOffset(offsetof(Vertex, uv)));
+		// Octahedral tangent attribute (location = 3)
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, 2, GL_SHORT, GL_TRUE, sizeof(Vertex), bufferOffset(offsetof(Vertex, tangent)));
+		// Bitangent sign attribute (location = 4)
+		glEnableVertexAttribArray(4);
+		glVertexAttribPointer(4, 1, GL_SHORT, GL_TRUE, sizeof(Vertex), bufferOffset(offsetof(Vertex, bitangentSign)));
+
+		// Element buffer binding is part of the vao state
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, getIndexBuffer(gBoundIndexType));
+
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	// Creates a buffer of the given size and copies the contents of the given buffer into it, deleting the old buffer
+	uint32_t _reallocate(uint32_t buffer, size_t oldSize, size_t newSize)
+	{
+		uint32_t newBuffer = 0;
+		glGenBuffers(1, &newBuffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, newSize, nullptr, GL_STATIC_DRAW);
+
+		// Copy previous contents
+		if (buffer && oldSize > 0) {
+			glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldSize);
+			glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		}
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		if (buffer) glDeleteBuffers(1, &buffer);
+		return newBuffer;
+	}
+
+	// Allocates the given amount of elements, doubling the buffer until the allocation fits
+	uint32_t _allocate(FreeListAllocator& allocator, uint32_t& buffer, size_t stride, uint32_t count)
+	{
+		uint32_t offset = allocator.allocate(count);
+		if (offset != FreeListAllocator::INVALID_OFFSET) return offset;
+
+		// Grow buffer
+		uint32_t oldCapacity = allocator.getCapacity();
+		uint32_t newCapacity = std::max(oldCapacity, 1u);
+		while (newCapacity - oldCapacity < count) newCapacity *= 2;
+		buffer = _reallocate(buffer, oldCapacity * stride, newCapacity * stride);
+		allocator.grow(newCapacity);
+
+		// Rebind grown buffer to vao
+		_setupVertexAttributes();
+
+		return allocator.allocate(count);
+	}
+
+	void create()
+	{
+		// Arena is created already
+		if (gVao) return;
+
+		// Create vertex array object and buffers
+		glGenVertexArrays(1, &gVao);
+		gVertexBuffer = _reallocate(0, 0, INITIAL_VERTEX_CAPACITY * sizeof(Vertex));
+		gShortIndexBuffer = _reallocate(0, 0, INITIAL_INDEX_CAPACITY * sizeof(uint16_t));
+		gIndexBuffer = _reallocate(0, 0, INITIAL_INDEX_CAPACITY * sizeof(uint32_t));
+		gVertexAllocator = FreeListAllocator(INITIAL_VERTEX_CAPACITY);
+		gShortIndexAllocator = FreeListAllocator(INITIAL_INDEX_CAPACITY);
+		gIndexAllocator = FreeListAllocator(INITIAL_INDEX_CAPACITY);
+
+		// Setup vertex and instance attributes
+		_setupVertexAttributes();
+		glBindVertexArray(gVao);
+		Instancing::setupAttributes();
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	void destroy()
+	{
+		glDeleteVertexArrays(1, &gVao);
+		glDeleteBuffers(1, &gVertexBuffer);
+		glDeleteBuffers(1, &gShortIndexBuffer);
+		glDeleteBuffers(1, &gIndexBuffer);
+		gVao = 0;
+		gVertexBuffer = 0;
+		gShortIndexBuffer = 0;
+		gIndexBuffer = 0;
+		gVertexAllocator = FreeListAllocator();
+		gShortIndexAllocator = FreeListAllocator();
+		gIndexAllocator = FreeListAllocator();
+		gBoundIndexType = IndexType::UINT32;
+	}
+
+	uint32_t getVAO()
+	{
+		return gVao;
+	}
+
+	uint32_t getVertexBuffer()
+	{
+		return gVertexBuffer;
+	}
+
+	uint32_t getIndexBuffer(IndexType type)
+	{
+		return type == IndexType::UINT16 ? gShortIndexBuffer : gIndexBuffer;
+	}
+
+	void bindIndexBuffer(IndexType type)
+	{
+		if (type == gBoundIndexType) return;
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, getIndexBuffer(type));
+		gBoundIndexType = type;
+	}
+
+	// Allocates the given amount of elements of the given size and uploads them, growing the buffer if needed
+	Allocation _add(const void* data, uint32_t count, size_t stride, FreeListAllocator& allocator, uint32_t& buffer)
+	{
+		// Make sure arena exists
+		create();
+
+		Allocation allocation;
+		allocation.count = count;
+		if (allocation.count == 0) return allocation;
+		allocation.offset = _allocate(allocator, buffer, stride, allocation.count);
+
+		// Upload data (through copy write target so the vao element binding stays untouched)
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, allocation.offset * stride, allocation.count * stride, data);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		return allocation;
+	}
+
+	Allocation addVertices(const Vertex* vertices, uint32_t count)
+	{
+		return _add(vertices, count, sizeof(Vertex), gVertexAllocator, gVertexBuffer);
+	}
+
+	Allocation addIndices(const void* indices, uint32_t count, IndexType type)
+	{
+		if (type == IndexType::UINT16) return _add(indices, count, sizeof(uint16_t), gShortIndexAllocator, gShortIndexBuffer);
+		return _add(indices, count, sizeof(uint32_t), gIndexAllocator, gIndexBuffer);
+	}
+
+	void removeVertices(Allocation allocation)
+	{
+		gVertexAllocator.release(allocation.offset, allocation.count);
+	}
+
+	void removeIndices(Allocation allocation, IndexType type)
+	{
+		if (type == IndexType::UINT16) gShortIndexAllocator.release(allocation.offset, allocation.count);
+		else gIndexAllocator.release(allocation.offset, allocation.count);
+	}
+
+	uint32_t getVertexCount()
+	{
+		return gVertexAllocator.getUsed();
+	}
+
+	uint32_t getIndexCount()
+	{
+		return gShortIndexAllocator.getUsed() + gIndexAllocator.getUsed();
+	}
+
+}
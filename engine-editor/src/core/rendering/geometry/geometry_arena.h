@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <glm.hpp>
+
+// Global vertex and index buffers all mesh geometry is sub-allocated from, sharing a single vertex array object
+namespace GeometryArena
+{
+
+	// Packed vertex layout of arena geometry (20 bytes)
+	struct Vertex
+	{
+		// Position quantized to 16-bit unsigned normalized coordinates within the meshes bounding box
+		uint16_t position[3];
+
+		// Sign of the bitangent relative to cross(normal, tangent) as a 16-bit signed normalized value
+		int16_t bitangentSign;
+
+		// Octahedral encoded normal and tangent as 16-bit signed normalized values
+		int16_t normal[2];
+		int16_t tangent[2];
+
+		// Texture coordinates as half floats
+		uint16_t uv[2];
+	};
+
+	// Packs the given vertex attributes, quantizing the position within the given bounding box
+	Vertex pack(glm::vec3 position, glm::vec3 normal, glm::vec2 uv, glm::vec3 tangent, glm::vec3 bitangent, glm::vec3 minPoint, glm::vec3 maxPoint);
+
+	// Returns the matrix mapping quantized positions of the given bounding box back to object space
+	glm::mat4 getDequantization(glm::vec3 minPoint, glm::vec3 maxPoint);
+
+	// Index formats the arena stores indices in, each within its own index buffer
+	enum class IndexType
+	{
+		UINT16,
+		UINT32
+	};
+
+	// Returns the opengl element type of the given index type
+	uint32_t getElementType(IndexType type);
+
+	// Returns the size of a single index of the given type in bytes
+	uint32_t getIndexSize(IndexType type);
+
+	// Returns the given byte offset into a bound buffer as the pointer opengl takes buffer offsets as
+	const void* bufferOffset(size_t offset);
+
+	// Range of elements allocated within an arena buffer
+	struct Allocation
+	{
+		uint32_t offset = 0;
+		uint32_t count = 0;
+	};
+
+	// Creates the arena buffers and vertex array object
+	void create();
+
+	// Destroys the arena buffers and vertex array object
+	void destroy();
+
+	// Returns the vertex array object referencing all arena geometry
+	uint32_t getVAO();
+
+	// Returns the arena vertex buffer
+	uint32_t getVertexBuffer();
+
+	// Returns the arena index buffer of the given index type
+	uint32_t getIndexBuffer(IndexType type);
+
+	// Binds the index buffer of the given index type to the arena vao, which must be bound
+	void bindIndexBuffer(IndexType type);
+
+	// Allocates and uploads the given amount of vertices, growing the arena if needed
+	Allocation addVertices(const Vertex* vertices, uint32_t count);
+
+	// Allocates and uploads the given amount of indices of the given type, growing the arena if needed
+	Allocation addIndices(const void* indices, uint32_t count, IndexType type);
+
+	// Releases vertices allocated before
+	void removeVertices(Allocation allocation);
+
+	// Releases indices of the given index type allocated before
+	void removeIndices(Allocation allocation, IndexType type);
+
+	// Returns the amount of allocated vertices
+	uint32_t getVertexCount();
+
+	// Returns the amount of allocated indices of all index types
+	uint32_t getIndexCount();
+
+};
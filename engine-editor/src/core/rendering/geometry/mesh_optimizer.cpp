@@ -0,0 +1,310 @@
+#include "mesh_optimizer.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+
+namespace MeshOptimizer {
+
+	// Size of the simulated cache used when optimizing for vertex cache hits
+	constexpr uint32_t OPTIMIZER_CACHE_SIZE = 32;
+
+	// Size of the simulated cache used for finding cluster boundaries when optimizing for overdraw
+	constexpr uint32_t OVERDRAW_CACHE_SIZE = 16;
+
+	// Vertex scoring parameters of Forsyth's algorithm
+	constexpr float CACHE_DECAY_POWER = 1.5f;
+	constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+	constexpr float VALENCE_BOOST_SCALE = 2.0f;
+	constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+	// Returns the score of a vertex given its position within the cache (-1 if not cached) and its amount of remaining triangles
+	float _vertexScore(int32_t cachePosition, uint32_t valence)
+	{
+		// Vertex isn't used by any remaining triangle
+		if (valence == 0) return -1.0f;
+
+		float score = 0.0f;
+		if (cachePosition >= 0) {
+			if (cachePosition < 3) {
+				// Vertices of the last triangle get a fixed score so the next triangle doesn't simply reuse its edge
+				score = LAST_TRIANGLE_SCORE;
+			}
+			else {
+				// Score decays with position within cache
+				float scale = 1.0f / (OPTIMIZER_CACHE_SIZE - 3);
+				score = std::pow(1.0f - (cachePosition - 3) * scale, CACHE_DECAY_POWER);
+			}
+		}
+
+		// Boost vertices with few remaining triangles so they get finished
+		score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(valence), -VALENCE_BOOST_POWER);
+
+		return score;
+	}
+
+	uint32_t generateWeldRemap(const std::vector<GeometryArena::Vertex>& vertices, std::vector<uint32_t>& remap)
+	{
+		remap.assign(vertices.size(), UNUSED_VERTEX);
+
+		// Packed vertices are compared by their bytes
+		std::unordered_map<std::string_view, uint32_t> unique;
+		unique.reserve(vertices.size());
+
+		uint32_t count = 0;
+		for (size_t i = 0; i < vertices.size(); i++) {
+			std::string_view key(reinterpret_cast<const char*>(&vertices[i]), sizeof(GeometryArena::Vertex));
+			auto [it, inserted] = unique.emplace(key, count);
+			if (inserted) count++;
+			remap[i] = it->second;
+		}
+
+		return count;
+	}
+
+	uint32_t generateFetchRemap(const std::vector<uint32_t>& indices, uint32_t vertexCount, std::vector<uint32_t>& remap)
+	{
+		remap.assign(vertexCount, UNUSED_VERTEX);
+
+		uint32_t count = 0;
+		for (uint32_t index : indices) {
+			if (remap[index] == UNUSED_VERTEX) remap[index] = count++;
+		}
+
+		return count;
+	}
+
+	void remapIndices(std::vector<uint32_t>& indices, const std::vector<uint32_t>& remap)
+	{
+		for (uint32_t& index : indices) {
+			index = remap[index];
+		}
+	}
+
+	void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount)
+	{
+		size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0) return;
+
+		//
+		// BUILD ADJACENCY
+		//
+
+		// Amount of remaining triangles per vertex
+		std::vector<uint32_t> valence(vertexCount, 0);
+		for (uint32_t index : indices) {
+			valence[index]++;
+		}
+
+		// Triangles using each vertex, the first valence entries of a vertex are its remaining triangles
+		std::vector<uint32_t> offsets(vertexCount + 1, 0);
+		for (uint32_t i = 0; i < vertexCount; i++) {
+			offsets[i + 1] = offsets[i] + valence[i];
+		}
+		std::vector<uint32_t> adjacency(indices.size());
+		std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+		for (size_t i = 0; i < indices.size(); i++) {
+			adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+
+		//
+		// INITIAL VERTEX SCORES
+		//
+
+		std::vector<float> vertexScores(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; i++) {
+			vertexScores[i] = _vertexScore(-1, valence[i]);
+		}
+
+		//
+		// EMIT TRIANGLES
+		//
+
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+		std::vector<bool> emitted(triangleCount, false);
+
+		std::vector<uint32_t> cache;
+		std::vector<uint32_t> newCache;
+		cache.reserve(OPTIMIZER_CACHE_SIZE + 3);
+		newCache.reserve(OPTIMIZER_CACHE_SIZE + 3);
+
+		int64_t best = -1;
+		size_t cursor = 0;
+
+		for (size_t n = 0; n < triangleCount; n++) {
+			// No candidate adjacent to the cache, continue with the next triangle not emitted yet
+			if (best < 0) {
+				while (emitted[cursor]) cursor++;
+				best = static_cast<int64_t>(cursor);
+			}
+
+			uint32_t triangle = static_cast<uint32_t>(best);
+			const uint32_t* vertices = &indices[triangle * 3];
+			emitted[triangle] = true;
+
+			// Emit triangle and move its vertices to the front of the cache
+			newCache.clear();
+			for (uint32_t i = 0; i < 3; i++) {
+				uint32_t vertex = vertices[i];
+				result.push_back(vertex);
+				if (std::find(newCache.begin(), newCache.end(), vertex) == newCache.end()) newCache.push_back(vertex);
+
+				// Remove triangle from the vertex' remaining triangles
+				uint32_t* begin = &adjacency[offsets[vertex]];
+				uint32_t* end = begin + valence[vertex];
+				uint32_t* it = std::find(begin, end, triangle);
+				std::swap(*it, *(end - 1));
+				valence[vertex]--;
+			}
+			for (uint32_t vertex : cache) {
+				if (vertex != vertices[0] && vertex != vertices[1] && vertex != vertices[2]) newCache.push_back(vertex);
+			}
+
+			// Update vertex scores, vertices pushed out of the cache lose their cache score
+			for (size_t i = 0; i < newCache.size(); i++) {
+				int32_t position = i < OPTIMIZER_CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+				vertexScores[newCache[i]] = _vertexScore(position, valence[newCache[i]]);
+			}
+
+			// Update scores of the remaining triangles touching the cache and pick the best one
+			best = -1;
+			float bestScore = -std::numeric_limits<float>::max();
+			for (uint32_t vertex : newCache) {
+				for (uint32_t i = 0; i < valence[vertex]; i++) {
+					uint32_t candidate = adjacency[offsets[vertex] + i];
+					const uint32_t* candidateVertices = &indices[candidate * 3];
+					float score = vertexScores[candidateVertices[0]] + vertexScores[candidateVertices[1]] + vertexScores[candidateVertices[2]];
+					if (score > bestScore) {
+						bestScore = score;
+						best = candidate;
+					}
+				}
+			}
+
+			// Keep vertices still within the cache
+			if (newCache.size() > OPTIMIZER_CACHE_SIZE) newCache.resize(OPTIMIZER_CACHE_SIZE);
+			cache.swap(newCache);
+		}
+
+		indices.swap(result);
+	}
+
+	void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<glm::vec3>& positions)
+	{
+		size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0) return;
+
+		//
+		// SPLIT INTO CLUSTERS
+		//
+
+		// A cluster starts at every triangle missing the cache with all of its vertices,
+		// reordering clusters at these points doesn't affect vertex cache efficiency much
+		std::vector<uint32_t> cacheTimestamps(positions.size(), 0);
+		uint32_t timestamp = OVERDRAW_CACHE_SIZE + 1;
+
+		std::vector<uint32_t> clusters;
+		for (size_t i = 0; i < triangleCount; i++) {
+			uint32_t misses = 0;
+			for (uint32_t j = 0; j < 3; j++) {
+				uint32_t vertex = indices[i * 3 + j];
+				if (timestamp - cacheTimestamps[vertex] > OVERDRAW_CACHE_SIZE) {
+					cacheTimestamps[vertex] = timestamp++;
+					misses++;
+				}
+			}
+			if (i == 0 || misses == 3) clusters.push_back(static_cast<uint32_t>(i));
+		}
+		if (clusters.size() < 2) return;
+
+		//
+		// SORT CLUSTERS
+		//
+
+		// Mesh centroid
+		glm::vec3 meshCentroid = glm::vec3(0.0f);
+		for (uint32_t index : indices) {
+			meshCentroid += positions[index];
+		}
+		meshCentroid /= static_cast<float>(indices.size());
+
+		// Sort key of each cluster is how far its surface faces away from the mesh centroid
+		std::vector<float> sortKeys(clusters.size());
+		for (size_t i = 0; i < clusters.size(); i++) {
+			size_t begin = clusters[i];
+			size_t end = i + 1 < clusters.size() ? clusters[i + 1] : triangleCount;
+
+			// Area weighted centroid and normal of cluster
+			glm::vec3 centroid = glm::vec3(0.0f);
+			glm::vec3 normal = glm::vec3(0.0f);
+			float area = 0.0f;
+			for (size_t j = begin; j < end; j++) {
+				const glm::vec3& p0 = positions[indices[j * 3]];
+				const glm::vec3& p1 = positions[indices[j * 3 + 1]];
+				const glm::vec3& p2 = positions[indices[j * 3 + 2]];
+				glm::vec3 weightedNormal = glm::cross(p1 - p0, p2 - p0);
+				float triangleArea = glm::length(weightedNormal);
+				centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+				normal += weightedNormal;
+				area += triangleArea;
+			}
+
+			// Skip degenerate clusters
+			float normalLength = glm::length(normal);
+			if (area <= 0.0f || normalLength <= 0.0f) continue;
+
+			sortKeys[i] = glm::dot(centroid / area - meshCentroid, normal / normalLength);
+		}
+
+		std::vector<uint32_t> order(clusters.size());
+		for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+		//
+		// REBUILD INDICES
+		//
+
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+		for (uint32_t cluster : order) {
+			size_t begin = clusters[cluster] * 3;
+			size_t end = cluster + 1 < clusters.size() ? clusters[cluster + 1] * 3 : indices.size();
+			result.insert(result.end(), indices.begin() + begin, indices.begin() + end);
+		}
+		indices.swap(result);
+	}
+
+	uint32_t countCacheMisses(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+	{
+		std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+		uint32_t timestamp = cacheSize + 1;
+
+		uint32_t misses = 0;
+		for (uint32_t index : indices) {
+			if (timestamp - cacheTimestamps[index] > cacheSize) {
+				cacheTimestamps[index] = timestamp++;
+				misses++;
+			}
+		}
+
+		return misses;
+	}
+
+	bool fitsShortIndices(uint32_t vertexCount)
+	{
+		return vertexCount <= std::numeric_limits<uint16_t>::max() + 1u;
+	}
+
+	std::vector<uint16_t> toShortIndices(const std::vector<uint32_t>& indices)
+	{
+		std::vector<uint16_t> shortIndices(indices.size());
+		for (size_t i = 0; i < indices.size(); i++) {
+			shortIndices[i] = static_cast<uint16_t>(indices[i]);
+		}
+		return shortIndices;
+	}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm.hpp>
+
+#include "../src/core/rendering/geometry/geometry_arena.h"
+
+// Import time optimizations of indexed triangle meshes
+namespace MeshOptimizer
+{
+
+	// Remap value of vertices not referenced anymore
+	constexpr uint32_t UNUSED_VERTEX = 0xFFFFFFFF;
+
+	// Fills the remap table merging bitwise identical vertices, returns the amount of unique vertices
+	uint32_t generateWeldRemap(const std::vector<GeometryArena::Vertex>& vertices, std::vector<uint32_t>& remap);
+
+	// Fills the remap table ordering vertices by their first use within the indices, returns the amount of referenced vertices
+	uint32_t generateFetchRemap(const std::vector<uint32_t>& indices, uint32_t vertexCount, std::vector<uint32_t>& remap);
+
+	// Applies the given remap table to the indices
+	void remapIndices(std::vector<uint32_t>& indices, const std::vector<uint32_t>& remap);
+
+	// Applies the given remap table to the vertices, shrinking them to the given amount of vertices
+	template <typename T>
+	void remapVertices(std::vector<T>& vertices, const std::vector<uint32_t>& remap, uint32_t vertexCount)
+	{
+		std::vector<T> remapped(vertexCount);
+		for (size_t i = 0; i < vertices.size(); i++) {
+			if (remap[i] != UNUSED_VERTEX) remapped[remap[i]] = vertices[i];
+		}
+		vertices.swap(remapped);
+	}
+
+	// Reorders triangles to maximize post transform vertex cache hits (Forsyth's linear speed algorithm)
+	void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+	// Reorders clusters of cache optimized triangles so outward facing ones are drawn first, reducing overdraw
+	void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<glm::vec3>& positions);
+
+	// Returns the amount of vertices transformed when drawing the indices with a fifo cache of the given size
+	uint32_t countCacheMisses(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = 16);
+
+	// Returns if the indices can be stored as 16-bit indices
+	bool fitsShortIndices(uint32_t vertexCount);
+
+	// Returns the indices narrowed to 16-bit indices
+	std::vector<uint16_t> toShortIndices(const std::vector<uint32_t>& indices);
+
+};
@@ -12,6 +12,9 @@
 #include "../src/core/rendering/shader/shader_pool.h"
 #include "../src/core/rendering/transformation/transformation.h"
 
+// Per draw uniforms, hashed at compile time
+constexpr UniformId MVP_MATRIX = "mvpMatrix";
+
 // Global gizmo resources
 IMGizmo::StaticData IMGizmo::staticData;
 
@@ -84,12 +87,15 @@ void IMGizmo::renderShapes(const glm::mat4& viewProjection)
 		// Get gizmo rendering target
 		ShapeRenderTarget gizmo = shapeRenderStack[i];
 
-		// Calculate mvp
+		// Get mesh
+		const Mesh* mesh = queryMesh(gizmo.shape);
+
+		// Calculate mvp (dequantizing the meshes packed positions)
 		glm::mat4 modelMatrix = getModelMatrix(gizmo.position, gizmo.rotation, gizmo.scale);
-		glm::mat4 mvpMatrix = viewProjection * modelMatrix;
+		glm::mat4 mvpMatrix = viewProjection * modelMatrix * mesh->getDequantization();
 
 		// Set material uniforms
-		staticData.fillShader->setMatrix4("mvpMatrix", mvpMatrix);
+		staticData.fillShader->setMatrix4(MVP_MATRIX, mvpMatrix);
 		staticData.fillShader->setVec4("color", glm::vec4(gizmo.state.color, gizmo.state.opacity));
 
 		// Set polygon mode for gizmo render
@@ -103,15 +109,15 @@ void IMGizmo::renderShapes(const glm::mat4& viewProjection)
 		}
 
 		// Render mesh
-		const Mesh* mesh = queryMesh(gizmo.shape);
 		glBindVertexArray(mesh->getVAO());
-		glDrawElements(GL_LINES, mesh->getIndiceCount(), GL_UNSIGNED_INT, 0);
+		GeometryArena::bindIndexBuffer(mesh->getIndexType());
+		glDrawElementsBaseVertex(GL_LINES, mesh->getIndiceCount(), GeometryArena::getElementType(mesh->getIndexType()), GeometryArena::bufferOffset(mesh->getFirstIndex() * GeometryArena::getIndexSize(mesh->getIndexType())), mesh->getBaseVertex());
 
 		// Optional foreground pass without depth testing and reduced opacity
 		if (gizmo.state.foreground) {
 			staticData.fillShader->setVec4("color", glm::vec4(gizmo.state.color, 0.035f));
 			glDisable(GL_DEPTH_TEST);
-			glDrawElements(GL_LINES, mesh->getIndiceCount(), GL_UNSIGNED_INT, 0);
+			glDrawElementsBaseVertex(GL_LINES, mesh->getIndiceCount(), GeometryArena::getElementType(mesh->getIndexType()), GeometryArena::bufferOffset(mesh->getFirstIndex() * GeometryArena::getIndexSize(mesh->getIndexType())), mesh->getBaseVertex());
 			glEnable(GL_DEPTH_TEST);
 		}
 	}
@@ -178,26 +184,27 @@ void IMGizmo::renderIcons(const glm::mat4& viewProjection)
 		modelMatrix = modelMatrix * rotation180Z;
 		// Scale gizmo icon
 		modelMatrix = modelMatrix * glm::scale(glm::mat4(1.0f), gizmo.scale);
-		// Calculate MVP matrix
-		glm::mat4 mvpMatrix = viewProjection * modelMatrix;
-
 		// Get mesh
 		const Mesh* mesh = queryMesh(Shape::PLANE);
 
+		// Calculate MVP matrix (dequantizing the meshes packed positions)
+		glm::mat4 mvpMatrix = viewProjection * modelMatrix * mesh->getDequantization();
+
 		// Set static material uniforms
-		staticData.iconShader->setMatrix4("mvpMatrix", mvpMatrix);
+		staticData.iconShader->setMatrix4(MVP_MATRIX, mvpMatrix);
 		staticData.iconShader->setVec4("color", glm::vec4(gizmo.state.color, gizmo.state.opacity));
 		staticData.iconShader->setVec3("tint", glm::vec3(1.0f));
 
 		// Render with full opacity and depth test
 		staticData.iconShader->setFloat("alpha", get3DIconAlpha(1.0f, gizmoPosition, cameraPosition));
 		glBindVertexArray(mesh->getVAO());
-		glDrawElements(GL_TRIANGLES, mesh->getIndiceCount(), GL_UNSIGNED_INT, 0);
+		GeometryArena::bindIndexBuffer(mesh->getIndexType());
+		glDrawElementsBaseVertex(GL_TRIANGLES, mesh->getIndiceCount(), GeometryArena::getElementType(mesh->getIndexType()), GeometryArena::bufferOffset(mesh->getFirstIndex() * GeometryArena::getIndexSize(mesh->getIndexType())), mesh->getBaseVertex());
 
 		// Render with transparency but without depth test
 		staticData.iconShader->setFloat("alpha", get3DIconAlpha(0.06f, gizmoPosition, cameraPosition));
 		glDisable(GL_DEPTH_TEST);
-		glDrawElements(GL_TRIANGLES, mesh->getIndiceCount(), GL_UNSIGNED_INT, 0);
+		glDrawElementsBaseVertex(GL_TRIANGLES, mesh->getIndiceCount(), GeometryArena::getElementType(mesh->getIndexType()), GeometryArena::bufferOffset(mesh->getFirstIndex() * GeometryArena::getIndexSize(mesh->getIndexType())), mesh->getBaseVertex());
 		glEnable(GL_DEPTH_TEST);
 	}
 
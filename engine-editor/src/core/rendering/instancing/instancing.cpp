@@ -0,0 +1,201 @@
+#include "instancing.h"
+
+#include <cstddef>
+#include <algorithm>
+#include <glad/glad.h>
+
+#include "../src/core/ecs/ecs_collection.h"
+#include "../src/core/rendering/model/mesh.h"
+#include "../src/core/rendering/geometry/geometry_arena.h"
+
+namespace Instancing {
+
+	// Buffer holding the instances model and normal matrices
+	uint32_t gInstanceBuffer = 0;
+
+	// Buffer holding the instances previous model matrices
+	uint32_t gPreviousBuffer = 0;
+
+	// Buffer holding the indirect draw commands of the uploaded batches
+	uint32_t gCommandBuffer = 0;
+
+	// Amount of instances both instance buffers can hold
+	uint32_t gCapacity = 0;
+
+	// Scratch buffer for building indirect draw commands
+	std::vector<DrawCommand> gCommands;
+
+	// Index types of the uploaded draw commands
+	std::vector<GeometryArena::IndexType> gCommandIndexTypes;
+
+	// Minimum amount of instances allocated
+	constexpr uint32_t MIN_CAPACITY = 256;
+
+	// Grows both instance buffers so they can hold at least the given amount of instances
+	void _reserve(uint32_t count)
+	{
+		if (count <= gCapacity) return;
+		gCapacity = std::max({ count, gCapacity * 2, MIN_CAPACITY });
+
+		// Reallocate instance buffers (keeping their names so vertex array objects stay valid)
+		glBindBuffer(GL_ARRAY_BUFFER, gInstanceBuffer);
+		glBufferData(GL_ARRAY_BUFFER, gCapacity * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, gPreviousBuffer);
+		glBufferData(GL_ARRAY_BUFFER, gCapacity * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	// Replaces the contents of the given buffer, orphaning its previous storage so pending draws don't stall
+	void _write(uint32_t buffer, size_t size, const void* data, size_t dataSize)
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+		if (dataSize) glBufferSubData(GL_COPY_WRITE_BUFFER, 0, dataSize, data);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+
+	void create()
+	{
+		// Instance buffers are created already
+		if (gInstanceBuffer) return;
+
+		glGenBuffers(1, &gInstanceBuffer);
+		glGenBuffers(1, &gPreviousBuffer);
+		glGenBuffers(1, &gCommandBuffer);
+		_reserve(MIN_CAPACITY);
+	}
+
+	void destroy()
+	{
+		glDeleteBuffers(1, &gInstanceBuffer);
+		glDeleteBuffers(1, &gPreviousBuffer);
+		glDeleteBuffers(1, &gCommandBuffer);
+		gInstanceBuffer = 0;
+		gPreviousBuffer = 0;
+		gCommandBuffer = 0;
+		gCapacity = 0;
+	}
+
+	void setupAttributes()
+	{
+		// Make sure instance buffers exist
+		create();
+
+		// Model matrix attribute (location = 5 to 8)
+		glBindBuffer(GL_ARRAY_BUFFER, gInstanceBuffer);
+		for (uint32_t i = 0; i < 4; i++) {
+			glEnableVertexAttribArray(MODEL_LOCATION + i);
+			glVertexAttribPointer(MODEL_LOCATION + i, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), GeometryArena::bufferOffset(offsetof(Instance, model) + i * sizeof(glm::vec4)));
+			glVertexAttribDivisor(MODEL_LOCATION + i, 1);
+		}
+
+		// Normal matrix attribute (location = 9 to 11)
+		for (uint32_t i = 0; i < 3; i++) {
+			glEnableVertexAttribArray(NORMAL_LOCATION + i);
+			glVertexAttribPointer(NORMAL_LOCATION + i, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), GeometryArena::bufferOffset(offsetof(Instance, normal) + i * sizeof(glm::vec3)));
+			glVertexAttribDivisor(NORMAL_LOCATION + i, 1);
+		}
+
+		// Previous model matrix attribute (location = 12 to 15)
+		glBindBuffer(GL_ARRAY_BUFFER, gPreviousBuffer);
+		for (uint32_t i = 0; i < 4; i++) {
+			glEnableVertexAttribArray(PREVIOUS_MODEL_LOCATION + i);
+			glVertexAttribPointer(PREVIOUS_MODEL_LOCATION + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), GeometryArena::bufferOffset(i * sizeof(glm::vec4)));
+			glVertexAttribDivisor(PREVIOUS_MODEL_LOCATION + i, 1);
+		}
+	}
+
+	void gather(const RenderQueue& renderQueue, bool matchMaterial, std::vector<Instance>& instances, std::vector<Batch>& batches, Entity skippedEntity)
+	{
+		instances.clear();
+		batches.clear();
+
+		for (const RenderQueueItem& item : renderQueue) {
+			if (item.entity == skippedEntity) continue;
+
+			auto [transform, renderer] = ECS::gRegistry.get<TransformComponent, MeshRendererComponent>(item.entity);
+			if (!renderer.enabled || !renderer.mesh) continue;
+			if (matchMaterial && !renderer.material) continue;
+
+			// Start a new batch if mesh or material differ from the current batch
+			bool sameMesh = !batches.empty() && batches.back().mesh == renderer.mesh;
+			bool sameMaterial = !matchMaterial || (!batches.empty() && batches.back().material == renderer.material);
+			if (!sameMesh || !sameMaterial) {
+				batches.push_back({ renderer.mesh, renderer.material, static_cast<uint32_t>(instances.size()), 0 });
+			}
+
+			// Add instance to current batch (model matrix also dequantizes the meshes packed positions)
+			instances.push_back({ transform.model * renderer.mesh->getDequantization(), transform.normal });
+			batches.back().count++;
+		}
+	}
+
+	void upload(const std::vector<Instance>& instances, const std::vector<Batch>& batches)
+	{
+		if (instances.empty()) return;
+
+		// Upload instances
+		uint32_t count = static_cast<uint32_t>(instances.size());
+		_reserve(count);
+		_write(gInstanceBuffer, gCapacity * sizeof(Instance), instances.data(), count * sizeof(Instance));
+
+		// Build and upload an indirect draw command for each batch
+		gCommands.resize(batches.size());
+		gCommandIndexTypes.resize(batches.size());
+		for (size_t i = 0; i < batches.size(); i++) {
+			const Batch& batch = batches[i];
+			gCommands[i] = { batch.mesh->getIndiceCount(), batch.count, batch.mesh->getFirstIndex(), static_cast<int32_t>(batch.mesh->getBaseVertex()), batch.first };
+			gCommandIndexTypes[i] = batch.mesh->getIndexType();
+		}
+		size_t commandsSize = gCommands.size() * sizeof(DrawCommand);
+		_write(gCommandBuffer, commandsSize, gCommands.data(), commandsSize);
+	}
+
+	uint32_t allocate(uint32_t count)
+	{
+		_reserve(count);
+		_write(gInstanceBuffer, gCapacity * sizeof(Instance), nullptr, 0);
+		return gInstanceBuffer;
+	}
+
+	void uploadPrevious(const std::vector<glm::mat4>& previousModels)
+	{
+		if (previousModels.empty()) return;
+
+		uint32_t count = static_cast<uint32_t>(previousModels.size());
+		_reserve(count);
+		_write(gPreviousBuffer, gCapacity * sizeof(glm::mat4), previousModels.data(), count * sizeof(glm::mat4));
+	}
+
+	void drawBatches(uint32_t firstBatch, uint32_t count)
+	{
+		if (count == 0) return;
+
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, gCommandBuffer);
+
+		// Submit one multi draw per run of batches sharing the same index type
+		uint32_t end = firstBatch + count;
+		for (uint32_t runStart = firstBatch; runStart < end;) {
+			GeometryArena::IndexType indexType = gCommandIndexTypes[runStart];
+			uint32_t runEnd = runStart + 1;
+			while (runEnd < end && gCommandIndexTypes[runEnd] == indexType) runEnd++;
+
+			GeometryArena::bindIndexBuffer(indexType);
+			glMultiDrawElementsIndirect(GL_TRIANGLES, GeometryArena::getElementType(indexType), GeometryArena::bufferOffset(runStart * sizeof(DrawCommand)), runEnd - runStart, 0);
+			runStart = runEnd;
+		}
+
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+
+	void drawSingle(const Mesh& mesh, const glm::mat4& model, const glm::mat3& normal)
+	{
+		Instance instance = { model * mesh.getDequantization(), normal };
+		_write(gInstanceBuffer, gCapacity * sizeof(Instance), &instance, sizeof(Instance));
+
+		glBindVertexArray(GeometryArena::getVAO());
+		GeometryArena::bindIndexBuffer(mesh.getIndexType());
+		glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, mesh.getIndiceCount(), GeometryArena::getElementType(mesh.getIndexType()), GeometryArena::bufferOffset(mesh.getFirstIndex() * GeometryArena::getIndexSize(mesh.getIndexType())), 1, mesh.getBaseVertex(), 0);
+	}
+
+}
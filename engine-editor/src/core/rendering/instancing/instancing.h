@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm.hpp>
+
+#include "../src/core/ecs/ecs.h"
+
+class Mesh;
+class IMaterial;
+
+namespace Instancing
+{
+
+	// Vertex attribute locations of per instance data, matrices occupy one location per column
+	constexpr uint32_t MODEL_LOCATION = 5;
+	constexpr uint32_t NORMAL_LOCATION = 9;
+	constexpr uint32_t PREVIOUS_MODEL_LOCATION = 12;
+
+	// Per instance transform data
+	struct Instance
+	{
+		glm::mat4 model;
+		glm::mat3 normal;
+	};
+
+	// Consecutive render queue entries sharing the same mesh (and material if requested), drawn with a single instanced draw call
+	struct Batch
+	{
+		const Mesh* mesh;
+		const IMaterial* material;
+
+		// Index of the batches first instance within the uploaded instances
+		uint32_t first;
+
+		// Amount of instances in batch
+		uint32_t count;
+	};
+
+	// Indirect draw command layout expected by glMultiDrawElementsIndirect
+	struct DrawCommand
+	{
+		uint32_t count;
+		uint32_t instanceCount;
+		uint32_t firstIndex;
+		int32_t baseVertex;
+		uint32_t baseInstance;
+	};
+
+	// Creates the instance and indirect command buffers
+	void create();
+
+	// Destroys the instance and indirect command buffers
+	void destroy();
+
+	// Sets up the instance attributes of the currently bound vertex array object
+	void setupAttributes();
+
+	// Collects instances of enabled mesh renderers in the given render queue, grouping runs of identical meshes into batches
+	// If matchMaterial is set, batches are also split on material changes
+	void gather(const RenderQueue& renderQueue, bool matchMaterial, std::vector<Instance>& instances, std::vector<Batch>& batches, Entity skippedEntity = entt::null);
+
+	// Uploads the given instances and one indirect draw command per batch, replacing the previously uploaded ones
+	void upload(const std::vector<Instance>& instances, const std::vector<Batch>& batches);
+
+	// Reallocates the instance buffer to hold the given amount of instances without uploading any and returns it, so instances can be written on the gpu
+	uint32_t allocate(uint32_t count);
+
+	// Uploads the previous model matrices of the uploaded instances (used for velocity)
+	void uploadPrevious(const std::vector<glm::mat4>& previousModels);
+
+	// Submits the given range of uploaded batches with a single multi draw indirect call, the geometry arena vao must be bound
+	void drawBatches(uint32_t firstBatch, uint32_t count);
+
+	// Uploads the given instance and draws a single instance of the mesh, binding the geometry arena vao
+	void drawSingle(const Mesh& mesh, const glm::mat4& model, const glm::mat3& normal);
+
+};
@@ -20,4 +20,7 @@ public:
 	virtual uint32_t getId() const = 0;
 	virtual Shader* getShader() const = 0;
 	virtual uint32_t getShaderId() const = 0;
+
+	// Requests the texture levels needed to sample the materials textures at the given amount of uv units per screen pixel
+	virtual void requestTextures(float /*uvPerPixel*/) const {}
 };
\ No newline at end of file
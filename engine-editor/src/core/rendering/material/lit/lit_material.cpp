@@ -9,28 +9,21 @@
 #include "lit_material.h"
 
 #include <glad/glad.h>
+#include <cmath>
+#include <algorithm>
 
 #include "../src/core/utils/console.h"
-#include "../src/core/rendering/shadows/shadow_map.h"
+#include "../src/core/rendering/shadows/shadow_atlas.h"
+#include "../src/core/rendering/shadows/cascaded_shadow_map.h"
 #include "../src/core/rendering/shader/shader_pool.h"
 #include "../src/core/rendering/shadows/shadow_disk.h"
-#include "../src/core/rendering/transformation/transformation.h"
+#include "../src/core/rendering/texture/texture_streaming.h"
 
 uint32_t LitMaterial::instances = 0;
-Viewport* LitMaterial::viewport = nullptr;
-TransformComponent* LitMaterial::cameraTransform = nullptr;
 uint32_t LitMaterial::ssaoInput = 0;
-PostProcessing::Profile* LitMaterial::profile = nullptr;
-bool LitMaterial::castShadows = true;
 ShadowDisk* LitMaterial::mainShadowDisk = nullptr;
-ShadowMap* LitMaterial::mainShadowMap = nullptr;
-
-std::string uniformArray(const std::string& identifier, size_t arrayIndex)
-{
-	size_t pos = identifier.find("[]");
-	if (pos == std::string::npos) return identifier;
-	return identifier.substr(0, pos) + "[" + std::to_string(arrayIndex) + "]" + identifier.substr(pos + 2);
-}
+ShadowAtlas* LitMaterial::mainShadowAtlas = nullptr;
+CascadedShadowMap* LitMaterial::mainCascadedShadowMap = nullptr;
 
 LitMaterial::LitMaterial() : baseColor(glm::vec4(1.0f)),
 tiling(glm::vec2(1.0f, 1.0f)),
@@ -59,44 +52,18 @@ shaderId(0)
 
 	shader->bind();
 	syncStaticUniforms();
-	syncLightUniforms();
 }
 
 void LitMaterial::bind() const
 {
-	// Bad temporary code
-	if (!shader || !viewport || !cameraTransform || !profile || !mainShadowDisk || !mainShadowMap) return;
-
-	syncLightUniforms();
-
-	// World parameters
-	shader->setMatrix4("lightSpaceMatrix", mainShadowMap->getLightSpace());
-	shader->setVec3("configuration.cameraPosition", Transformation::toBackendPosition(cameraTransform->position));
-
-	// General configuration
-	shader->setFloat("configuration.gamma", profile->color.gamma);
-	shader->setVec2("configuration.viewportResolution", viewport->getResolution());
-
-	// Shadow parameters
-	shader->setBool("configuration.castShadows", castShadows);
-
-	shader->setFloat("configuration.shadowMapResolutionWidth", static_cast<float>(mainShadowMap->getResolutionWidth()));
-	shader->setFloat("configuration.shadowMapResolutionHeight", static_cast<float>(mainShadowMap->getResolutionHeight()));
-
-	shader->setFloat("configuration.shadowDiskWindowSize", static_cast<float>(mainShadowDisk->getWindowSize()));
-	shader->setFloat("configuration.shadowDiskFilterSize", static_cast<float>(mainShadowDisk->getFilterSize()));
-	shader->setFloat("configuration.shadowDiskRadius", static_cast<float>(mainShadowDisk->getRadius()));
-
 	// Bind shadow maps
-	mainShadowDisk->bind(SHADOW_DISK_UNIT);
-	mainShadowMap->bind(SHADOW_MAP_UNIT);
+	if (mainShadowDisk) mainShadowDisk->bind(SHADOW_DISK_UNIT);
+	if (mainShadowAtlas) mainShadowAtlas->bind(SHADOW_ATLAS_UNIT);
+	if (mainCascadedShadowMap) mainCascadedShadowMap->bind(CASCADED_SHADOW_MAP_UNIT);
 
-	// SSAO
-	shader->setBool("configuration.enableSSAO", profile->ambientOcclusion.enabled);
-	if (profile->ambientOcclusion.enabled) {
-		glActiveTexture(GL_TEXTURE0 + SSAO_UNIT);
-		glBindTexture(GL_TEXTURE_2D, ssaoInput);
-	}
+	// Bind ssao buffer
+	glActiveTexture(GL_TEXTURE0 + SSAO_UNIT);
+	glBindTexture(GL_TEXTURE_2D, ssaoInput);
 
 	// Set material data
 	shader->setVec4("material.baseColor", baseColor);
@@ -181,6 +148,17 @@ uint32_t LitMaterial::getShaderId() const
 	return shaderId;
 }
 
+void LitMaterial::requestTextures(float uvPerPixel) const
+{
+	// Tiling repeats textures, sampling them more densely
+	float density = uvPerPixel * std::max(std::abs(tiling.x), std::abs(tiling.y));
+
+	Texture* maps[] = { albedoMap, roughnessMap, metallicMap, normalMap, occlusionMap, emissiveMap, heightMap };
+	for (Texture* map : maps) {
+		if (map) TextureStreaming::request(map, density);
+	}
+}
+
 void LitMaterial::syncStaticUniforms() const
 {
 	//
@@ -195,7 +173,8 @@ void LitMaterial::syncStaticUniforms() const
 	shader->setInt("material.emissiveMap", EMISSIVE_UNIT);
 	shader->setInt("material.heightMap", HEIGHT_UNIT);
 	shader->setInt("configuration.shadowDisk", SHADOW_DISK_UNIT);
-	shader->setInt("configuration.shadowMap", SHADOW_MAP_UNIT);
+	shader->setInt("configuration.shadowAtlas", SHADOW_ATLAS_UNIT);
+	shader->setInt("configuration.cascadedShadowMap", CASCADED_SHADOW_MAP_UNIT);
 	shader->setInt("configuration.ssaoBuffer", SSAO_UNIT);
 
 	//
@@ -209,89 +188,3 @@ void LitMaterial::syncStaticUniforms() const
 	// shader->setVec3("fog.color", glm::vec3(1.0f, 1.0f, 1.0f));
 	// shader->setFloat("fog.data[0]", 0.01);
 }
-
-void LitMaterial::syncLightUniforms() const
-{
-	//
-	// Sync lights
-	//
-
-	// Fetch lights
-	auto directionalLights = ECS::gRegistry.view<TransformComponent, DirectionalLightComponent>();
-	auto pointLights = ECS::gRegistry.view<TransformComponent, PointLightComponent>();
-	auto spotlights = ECS::gRegistry.view<TransformComponent, SpotlightComponent>();
-
-	// Light count
-	size_t nDirectionalLights = 0;
-	size_t nPointLights = 0;
-	size_t nSpotlights = 0;
-
-	// Limitations
-	size_t maxDirectionalLights = 1;
-	size_t maxPointLights = 15;
-	size_t maxSpotlights = 8;
-
-	// Setup all directional lights
-	for (auto [entity, transform, directionalLight] : directionalLights.each()) {
-		glm::vec3 directionalDirection = glm::vec3(-0.7f, -0.8f, 1.0f);
-		glm::vec3 directionalPosition = glm::vec3(4.0f, 5.0f, -7.0f);
-
-		if (!directionalLight.enabled) continue;
-		shader->setFloat(uniformArray("directionalLights[].intensity", nDirectionalLights), directionalLight.intensity);
-		shader->setVec3(uniformArray("directionalLights[].direction", nDirectionalLights), Transformation::toBackendPosition(directionalDirection));
-		shader->setVec3(uniformArray("directionalLights[].color", nDirectionalLights), directionalLight.color);
-		shader->setVec3(uniformArray("directionalLights[].position", nDirectionalLights), Transformation::toBackendPosition(directionalPosition));
-
-		nDirectionalLights++;
-		if (nDirectionalLights >= maxDirectionalLights) break;
-	}
-
-	// Setup all point lights
-	for (auto [entity, transform, pointLight] : pointLights.each()) {
-		if (!pointLight.enabled) continue;
-		shader->setVec3(uniformArray("pointLights[].position", nPointLights), Transformation::toBackendPosition(transform.position));
-		shader->setVec3(uniformArray("pointLights[].color", nPointLights), pointLight.color);
-		shader->setFloat(uniformArray("pointLights[].intensity", nPointLights), pointLight.intensity);
-		shader->setFloat(uniformArray("pointLights[].range", nPointLights), pointLight.range);
-		shader->setFloat(uniformArray("pointLights[].falloff", nPointLights), pointLight.falloff);
-
-		nPointLights++;
-		if (nPointLights >= maxPointLights) break;
-	}
-
-	// Setup all spotlights
-	for (auto [entity, transform, spotlight] : spotlights.each()) {
-		glm::vec3 spotlightDirection = glm::vec3(0.0f, 0.0f, 1.0f);
-
-		if (!spotlight.enabled) continue;
-		shader->setVec3(uniformArray("spotlights[].position", nSpotlights), Transformation::toBackendPosition(transform.position));
-		shader->setVec3(uniformArray("spotlights[].direction", nSpotlights), Transformation::toBackendPosition(spotlightDirection));
-		shader->setVec3(uniformArray("spotlights[].color", nSpotlights), spotlight.color);
-		shader->setFloat(uniformArray("spotlights[].intensity", nSpotlights), spotlight.intensity);
-		shader->setFloat(uniformArray("spotlights[].range", nSpotlights), spotlight.range);
-		shader->setFloat(uniformArray("spotlights[].falloff", nSpotlights), spotlight.falloff);
-		shader->setFloat(uniformArray("spotlights[].innerCos", nSpotlights), glm::cos(glm::radians(spotlight.innerAngle * 0.5f)));
-		shader->setFloat(uniformArray("spotlights[].outerCos", nSpotlights), glm::cos(glm::radians(spotlight.outerAngle * 0.5f)));
-
-		nSpotlights++;
-		if (nSpotlights >= maxSpotlights) break;
-	}
-
-	// Lighting parameters
-	shader->setInt("configuration.numDirectionalLights", nDirectionalLights);
-	shader->setInt("configuration.numPointLights", nPointLights);
-	shader->setInt("configuration.numSpotLights", nSpotlights);
-}
-
-void LitMaterial::setSampleDirectionalLight() const
-{
-	shader->setInt("configuration.numDirectionalLights", 1);
-	shader->setInt("configuration.numPointLights", 0);
-	shader->setInt("configuration.numSpotLights", 0);
-
-	size_t index = 0;
-	shader->setFloat(uniformArray("directionalLights[].intensity", index), 1.0f);
-	shader->setVec3(uniformArray("directionalLights[].direction", index), Transformation::toBackendPosition(glm::vec3(-0.5f, -0.5f, 0.5f)));
-	shader->setVec3(uniformArray("directionalLights[].color", index), glm::vec3(1.0f, 1.0f, 1.0f));
-	shader->setVec3(uniformArray("directionalLights[].position", index), Transformation::toBackendPosition(glm::vec3(0.0f, 0.0f, 0.0f)));
-}
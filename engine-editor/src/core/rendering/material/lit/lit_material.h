@@ -11,7 +11,8 @@
 #include "../src/core/rendering/postprocessing/post_processing.h"
 
 class ShadowDisk;
-class ShadowMap;
+class ShadowAtlas;
+class CascadedShadowMap;
 
 class LitMaterial : public IMaterial
 {
@@ -22,6 +23,7 @@ public:
 	uint32_t getId() const override;
 	Shader* getShader() const override;
 	uint32_t getShaderId() const override;
+	void requestTextures(float uvPerPixel) const override;
 
 	glm::vec4 baseColor;
 	glm::vec2 tiling;
@@ -43,24 +45,17 @@ public:
 	Texture* heightMap;
 
 	void syncStaticUniforms() const;
-	void syncLightUniforms() const;
-	void setSampleDirectionalLight() const;
 
 public:
 	// Instance counter
 	static uint32_t instances;
 
 	// Needed to be set before binding lit material
-	// Replace this through some state object and add a function to push a state
-	// Eg "RenderState" and pushRenderState(state)
-	// Or rewrite matertial system for more modular and dynamic approach
-	static Viewport* viewport;
-	static TransformComponent* cameraTransform;
+	// Camera, light and shadow configuration is provided by the view, light and shadow uniform blocks
 	static uint32_t ssaoInput;
-	static PostProcessing::Profile* profile;
-	static bool castShadows;
 	static ShadowDisk* mainShadowDisk; // tmp until global shadow system
-	static ShadowMap* mainShadowMap; // tmp until global shadow system
+	static ShadowAtlas* mainShadowAtlas; // Shadows of point lights and spotlights
+	static CascadedShadowMap* mainCascadedShadowMap; // Cascades of the view being rendered
 
 private:
 	enum TextureUnits
@@ -73,7 +68,8 @@ private:
 		EMISSIVE_UNIT,
 		HEIGHT_UNIT,
 		SHADOW_DISK_UNIT,
-		SHADOW_MAP_UNIT,
+		SHADOW_ATLAS_UNIT,
+		CASCADED_SHADOW_MAP_UNIT,
 		SSAO_UNIT
 	};
 
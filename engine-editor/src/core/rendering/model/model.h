@@ -6,7 +6,9 @@
 #include <unordered_map>
 
 #include "../src/core/resource/resource.h"
+#include "../src/core/utils/mapped_file.h"
 #include "../src/core/rendering/model/mesh.h"
+#include "../src/core/rendering/model/mesh_cache.h"
 
 class aiScene;
 class aiNode;
@@ -43,6 +45,20 @@ public:
 
 		// Maximum distance of a vertice from object space center
 		float furthest = 0.0f;
+
+		// Total number of duplicate vertices removed by welding
+		uint32_t nWeldedVertices = 0;
+
+		// Total number of meshes using 16-bit indices
+		uint32_t nShortIndexMeshes = 0;
+
+		// Total number of vertices transformed with a simulated vertex cache before and after optimization
+		uint32_t nCacheMissesBefore = 0;
+		uint32_t nCacheMissesAfter = 0;
+
+		// Average number of vertices transformed per face before and after optimization
+		float acmrBefore = 0.0f;
+		float acmrAfter = 0.0f;
 	};
 
 public:
@@ -66,36 +82,48 @@ protected:
 	void loadData() override;
 	void releaseData() override;
 	void dispatchGPU() override;
+	size_t getChunkSize() override;
 
 private:
-	struct VertexData
-	{
-		glm::vec3 position;
-		glm::vec3 normal;
-		glm::vec2 uv;
-		glm::vec3 tangent;
-		glm::vec3 bitangent;
-
-		VertexData() : position(), normal(), uv(), tangent(), bitangent() {};
-
-		explicit VertexData(glm::vec3 position, glm::vec3 normal, glm::vec2 uv, glm::vec3 tangent, glm::vec3 bitangent) : position(position), 
-			normal(normal), 
-			uv(uv), 
-			tangent(tangent), 
-			bitangent(bitangent) 
-		{};
-	};
+	// Packed vertex layout of model geometry
+	using VertexData = GeometryArena::Vertex;
 
 	struct MeshData {
+		// Imported streams, empty if the mesh is mapped from the mesh cache
 		std::vector<VertexData> vertices;
 		std::vector<uint32_t> indices;
-		uint32_t materialIndex;
+		std::vector<uint16_t> shortIndices;
 
-		explicit MeshData(std::vector<VertexData>&& vertices, std::vector<uint32_t>&& indices, uint32_t materialIndex) : 
+		// Streams to upload, pointing into the imported streams or the mesh cache mapping
+		MeshCache::MeshStreams streams;
+
+		explicit MeshData(std::vector<VertexData>&& vertices, std::vector<uint32_t>&& indices, std::vector<uint16_t>&& shortIndices, uint32_t materialIndex, glm::vec3 minPoint, glm::vec3 maxPoint, float uvDensity) : 
 			vertices(std::move(vertices)),
 			indices(std::move(indices)),
-			materialIndex(materialIndex) 
+			shortIndices(std::move(shortIndices)),
+			streams()
+		{
+			streams.materialIndex = materialIndex;
+			streams.indexType = this->shortIndices.empty() ? GeometryArena::IndexType::UINT32 : GeometryArena::IndexType::UINT16;
+			streams.vertices = this->vertices.data();
+			streams.vertexCount = static_cast<uint32_t>(this->vertices.size());
+			streams.indices = this->shortIndices.empty() ? static_cast<const void*>(this->indices.data()) : static_cast<const void*>(this->shortIndices.data());
+			streams.indexCount = static_cast<uint32_t>(this->shortIndices.empty() ? this->indices.size() : this->shortIndices.size());
+			streams.minPoint = minPoint;
+			streams.maxPoint = maxPoint;
+			streams.uvDensity = uvDensity;
+		};
+
+		explicit MeshData(const MeshCache::MeshStreams& streams) :
+			vertices(),
+			indices(),
+			shortIndices(),
+			streams(streams)
 		{};
+
+		// Streams may point into the imported streams, which moving keeps but copying wouldn't
+		MeshData(const MeshData&) = delete;
+		MeshData(MeshData&&) = default;
 	};
 
 private:
@@ -106,6 +134,15 @@ private:
 	void processNode(aiNode* node, const aiScene* scene);
 	MeshData processMesh(aiMesh* mesh, const aiScene* scene);
 
+	// Welds duplicate vertices and reorders triangles and vertices for vertex cache, overdraw and vertex fetch efficiency
+	void optimizeMesh(std::vector<VertexData>& vertices, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices);
+
+	// Maps the mesh cache and loads mesh data and metrics from it, returns false if the cache is missing or stale
+	bool loadCache(const std::string& cachePath, uint64_t sourceHash);
+
+	// Cooks the imported mesh data and metrics into the mesh cache
+	void writeCache(const std::string& cachePath, uint64_t sourceHash);
+
 	//
 	// MODEL DATA
 	//
@@ -116,6 +153,9 @@ private:
 	// Intermediate temporary representation of mesh data
 	std::vector<MeshData> meshData;
 
+	// Mapping of the mesh cache while mesh data is loaded from it
+	MappedFile cache;
+
 	// Final dispatched meshes
 	std::unordered_map<uint32_t, Mesh> meshes;
 
@@ -126,8 +166,8 @@ private:
 	// Models metrics
 	Metrics metrics;
 
-	// Adds a mesh to the metrics using its vertices
-	void addMeshToMetrics(const std::vector<VertexData>& vertices, uint32_t nFaces);
+	// Adds a mesh to the metrics using its vertex positions
+	void addMeshToMetrics(const std::vector<glm::vec3>& positions, uint32_t nFaces);
 	
 	// Finalizes the metrics after all meshes have been added
 	void finalizeMetrics();
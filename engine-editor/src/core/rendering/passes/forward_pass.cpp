@@ -8,6 +8,9 @@
 #include "../src/core/rendering/skybox/skybox.h"
 #include "../src/core/diagnostics/diagnostics.h"
 #include "../src/core/rendering/material/imaterial.h"
+#include "../src/core/rendering/passes/culling_pass.h"
+#include "../src/core/rendering/instancing/instancing.h"
+#include "../src/core/rendering/geometry/geometry_arena.h"
 #include "../src/core/rendering/transformation/transformation.h"
 
 ForwardPass::ForwardPass(const Viewport& viewport) : drawSkybox(false),
@@ -15,13 +18,16 @@ drawGizmos(false),
 viewport(viewport),
 skybox(nullptr),
 gizmos(nullptr),
+culling(nullptr),
 clearColor(glm::vec4(0.0f)),
 outputFbo(0),
 outputColor(0),
 outputDepth(0),
 multisampledFbo(0),
 multisampledRbo(0),
-multisampledColorBuffer(0)
+multisampledColorBuffer(0),
+instances(),
+batches()
 {
 }
 
@@ -102,7 +108,7 @@ void ForwardPass::destroy() {
 	multisampledFbo = 0;
 }
 
-uint32_t ForwardPass::render(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection)
+uint32_t ForwardPass::render(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection, const RenderQueue& renderQueue)
 {
 	// Bind framebuffer
 	glBindFramebuffer(GL_FRAMEBUFFER, multisampledFbo);
@@ -139,8 +145,9 @@ uint32_t ForwardPass::render(const glm::mat4& view, const glm::mat4& projection,
 	*/
 	// INJECTED PRE PASS END
 
-	// Render each entity
-	renderMeshes();
+	// Render each entity, culled on the gpu if there is a culling pass
+	if (culling) renderCulledMeshes();
+	else renderMeshes(renderQueue);
 
 	// Disable culling before rendering skybox
 	glDisable(GL_CULL_FACE);
@@ -174,55 +181,69 @@ void ForwardPass::linkGizmos(IMGizmo* _gizmos)
 	gizmos = _gizmos;
 }
 
+void ForwardPass::linkCulling(const CullingPass* _culling)
+{
+	culling = _culling;
+}
+
 void ForwardPass::setClearColor(glm::vec4 _clearColor)
 {
 	clearColor = _clearColor;
 }
 
-void ForwardPass::renderMesh(TransformComponent& transform, MeshRendererComponent& renderer)
+void ForwardPass::renderMeshes(const RenderQueue& renderQueue)
 {
-	// Transform components model and mvp must have been calculated beforehand
+	// Collect instances of identical mesh and material runs
+	Instancing::gather(renderQueue, true, instances, batches);
+	Instancing::upload(instances, batches);
 
-	// Renderer must be enabled
-	if (!renderer.enabled) return;
+	// Bind geometry arena
+	glBindVertexArray(GeometryArena::getVAO());
 
-	// Make sure mesh is available
-	if (!renderer.mesh) return;
+	// Render batches of each material with a single indirect draw call
+	uint32_t currentShaderId = 0;
+	uint32_t nBatches = static_cast<uint32_t>(batches.size());
+	for (uint32_t first = 0; first < nBatches;) {
+		const IMaterial* material = batches[first].material;
 
-	// Set shader uniforms
-	Shader* shader = renderer.material->getShader();
-	shader->setMatrix4("mvpMatrix", transform.mvp);
-	shader->setMatrix4("modelMatrix", transform.model);
-	shader->setMatrix3("normalMatrix", transform.normal);
+		// Find end of material run
+		uint32_t end = first + 1;
+		while (end < nBatches && batches[end].material == material) end++;
 
-	// Bind mesh
-	glBindVertexArray(renderer.mesh->getVAO());
+		// Bind shader if not bound already
+		uint32_t shaderId = material->getShaderId();
+		if (shaderId != currentShaderId) {
+			material->getShader()->bind();
+			currentShaderId = shaderId;
+		}
 
-	// Render mesh
-	glDrawElements(GL_TRIANGLES, renderer.mesh->getIndiceCount(), GL_UNSIGNED_INT, 0);
+		// Bind material and render all batches using it
+		material->bind();
+		Instancing::drawBatches(first, end - first);
+		first = end;
+	}
 }
 
-void ForwardPass::renderMeshes()
+void ForwardPass::renderCulledMeshes()
 {
-	uint32_t currentShaderId = 0;
-	uint32_t currentMaterialId = 0;
+	// Bind geometry arena
+	glBindVertexArray(GeometryArena::getVAO());
 
-	// Render each entity
-	for (auto& [entity, transform, renderer] : ECS::getRenderQueue()) {
+	// Render each bucket with a single indirect draw call
+	uint32_t currentShaderId = 0;
+	const std::vector<CullingPass::Bucket>& buckets = culling->getBuckets();
+	for (uint32_t i = 0; i < buckets.size(); i++) {
+		const IMaterial* material = buckets[i].material;
 
-		uint32_t shaderId = renderer.material->getShaderId();
+		// Bind shader if not bound already
+		uint32_t shaderId = material->getShaderId();
 		if (shaderId != currentShaderId) {
-			renderer.material->getShader()->bind();
+			material->getShader()->bind();
 			currentShaderId = shaderId;
 		}
 
-		uint32_t materialId = renderer.material->getId();
-		if (materialId != currentMaterialId) {
-			renderer.material->bind();
-			currentMaterialId = materialId;
-		}
-
-		renderMesh(transform, renderer);
-
+		// Bind material and render the surviving batches of the bucket
+		material->bind();
+		culling->drawBucket(i);
 	}
 }
\ No newline at end of file
@@ -4,11 +4,14 @@
 #include <vector>
 #include <glm.hpp>
 
+#include "../src/core/ecs/ecs.h"
 #include "../src/core/ecs/components.h"
 #include "../src/core/viewport/viewport.h"
 #include "../src/core/rendering/gizmos/imgizmo.h"
+#include "../src/core/rendering/instancing/instancing.h"
 
 class Skybox;
+class CullingPass;
 
 class ForwardPass
 {
@@ -18,8 +21,8 @@ public:
 	void create(const uint32_t msaaSamples); // Creates forward pass
 	void destroy(); // Destroys forward pass
 
-	// Forward passes all entity render targets and returns color output
-	uint32_t render(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection);
+	// Forward passes all entity render targets of the given render queue and returns color output
+	uint32_t render(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection, const RenderQueue& renderQueue);
 
 	uint32_t getDepthOutput(); // Returns depth output
 
@@ -29,12 +32,16 @@ public:
 	void linkGizmos(IMGizmo* gizmos);
 	bool drawGizmos;
 
+	// Links a culling pass whose latest culled buckets are drawn instead of the render queue (nullptr to draw the render queue)
+	void linkCulling(const CullingPass* culling);
+
 	void setClearColor(glm::vec4 clearColor); // Clear color for forward pass
 private:
 	const Viewport& viewport; // Viewport forward pass instance is linked to
 
 	Skybox* skybox; // Skybox that will be rendered during forward pass (optional)
 	IMGizmo* gizmos; // Gizmo instance that will be rendered during forward pass (optional)
+	const CullingPass* culling; // Culling pass providing gpu culled draws (optional)
 	
 	glm::vec4 clearColor; // Clear color for forward pass
 
@@ -46,6 +53,9 @@ private:
 	uint32_t multisampledRbo;		 // Anti-aliasing renderbuffer
 	uint32_t multisampledColorBuffer; // Anti-aliasing color buffer texture
 
-	void renderMesh(TransformComponent& transform, MeshRendererComponent& renderer);
-	void renderMeshes();
+	std::vector<Instancing::Instance> instances; // Instances of the render queue, reused across frames
+	std::vector<Instancing::Batch> batches; // Instanced draw batches of the render queue, reused across frames
+
+	void renderMeshes(const RenderQueue& renderQueue); // Renders all meshes of the given render queue in instanced indirect draw calls
+	void renderCulledMeshes(); // Renders the buckets of the linked culling pass in indirect draw calls
 };
\ No newline at end of file
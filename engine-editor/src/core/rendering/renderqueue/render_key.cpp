@@ -0,0 +1,91 @@
+#include "render_key.h"
+
+#include <cstring>
+
+namespace RenderKey {
+
+	constexpr uint32_t PASS_BITS = 2;
+	constexpr uint32_t SHADER_BITS = 10;
+	constexpr uint32_t MATERIAL_BITS = 14;
+	constexpr uint32_t MESH_BITS = 14;
+	constexpr uint32_t DEPTH_BITS = 24;
+
+	static_assert(PASS_BITS + SHADER_BITS + MATERIAL_BITS + MESH_BITS + DEPTH_BITS == 64, "Render key fields must fill 64 bits");
+
+	constexpr uint32_t DEPTH_SHIFT = 0;
+	constexpr uint32_t MESH_SHIFT = DEPTH_SHIFT + DEPTH_BITS;
+	constexpr uint32_t MATERIAL_SHIFT = MESH_SHIFT + MESH_BITS;
+	constexpr uint32_t SHADER_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+	constexpr uint32_t PASS_SHIFT = SHADER_SHIFT + SHADER_BITS;
+
+	// Masks given value to the given amount of bits and moves it to its field
+	constexpr uint64_t _field(uint64_t value, uint32_t bits, uint32_t shift)
+	{
+		return (value & ((1ull << bits) - 1)) << shift;
+	}
+
+	uint64_t pack(Pass pass, uint32_t shaderId, uint32_t materialId, uint32_t meshId, float viewDepth)
+	{
+		return _field(static_cast<uint64_t>(pass), PASS_BITS, PASS_SHIFT) |
+			_field(shaderId, SHADER_BITS, SHADER_SHIFT) |
+			_field(materialId, MATERIAL_BITS, MATERIAL_SHIFT) |
+			_field(meshId, MESH_BITS, MESH_SHIFT) |
+			_field(quantizeDepth(viewDepth), DEPTH_BITS, DEPTH_SHIFT);
+	}
+
+	uint32_t quantizeDepth(float viewDepth)
+	{
+		// Depths behind the camera are clamped to the near end
+		if (!(viewDepth > 0.0f)) return 0;
+
+		// Bit pattern of positive floats increases monotonically, keep the most significant 24 bits below the sign bit
+		uint32_t bits;
+		std::memcpy(&bits, &viewDepth, sizeof(float));
+		return bits >> (32 - DEPTH_BITS - 1);
+	}
+
+	void sort(RenderQueue& renderQueue, RenderQueue& scratch)
+	{
+		const size_t n = renderQueue.size();
+		if (n < 2) return;
+
+		scratch.resize(n);
+
+		// Build histograms of all eight key bytes in a single pass
+		uint32_t histograms[8][256] = {};
+		for (const RenderQueueItem& item : renderQueue) {
+			for (uint32_t byte = 0; byte < 8; byte++) {
+				histograms[byte][(item.key >> (byte * 8)) & 0xFF]++;
+			}
+		}
+
+		RenderQueue* source = &renderQueue;
+		RenderQueue* destination = &scratch;
+
+		for (uint32_t byte = 0; byte < 8; byte++) {
+			uint32_t* histogram = histograms[byte];
+
+			// Skip byte if all keys share the same value in it
+			if (histogram[((*source)[0].key >> (byte * 8)) & 0xFF] == n) continue;
+
+			// Convert counts to offsets
+			uint32_t offset = 0;
+			for (uint32_t i = 0; i < 256; i++) {
+				uint32_t count = histogram[i];
+				histogram[i] = offset;
+				offset += count;
+			}
+
+			// Scatter items by current byte
+			for (const RenderQueueItem& item : *source) {
+				(*destination)[histogram[(item.key >> (byte * 8)) & 0xFF]++] = item;
+			}
+
+			std::swap(source, destination);
+		}
+
+		// Make sure sorted result ends up in the render queue
+		if (source != &renderQueue) renderQueue.swap(scratch);
+	}
+
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../src/core/ecs/ecs.h"
+
+namespace RenderKey
+{
+	// Render pass bucket, most significant part of a render key
+	enum class Pass : uint64_t
+	{
+		SOLID_GEOMETRY = 0
+	};
+
+	// Packs the given render state into a 64-bit sort key
+	// Layout (msb to lsb): pass (2 bits) | shader (10 bits) | material (14 bits) | mesh (14 bits) | view depth (24 bits)
+	// Ids exceeding their field width are wrapped, which only affects batching order
+	uint64_t pack(Pass pass, uint32_t shaderId, uint32_t materialId, uint32_t meshId, float viewDepth);
+
+	// Returns the order preserving 24-bit quantization of a view space depth
+	uint32_t quantizeDepth(float viewDepth);
+
+	// Sorts the render queue by its keys using a stable least significant digit radix sort
+	// Scratch is used as a buffer and may be reused across calls to avoid allocations
+	void sort(RenderQueue& renderQueue, RenderQueue& scratch);
+};
@@ -7,6 +7,8 @@
 #include "../src/core/rendering/model/mesh.h"
 #include "../src/core/rendering/skybox/skybox.h"
 #include "../src/core/rendering/material/imaterial.h"
+#include "../src/core/rendering/instancing/instancing.h"
+#include "../src/core/rendering/geometry/geometry_arena.h"
 #include "../src/core/rendering/transformation/transformation.h"
 #include "../src/core/rendering/material/unlit/unlit_material.h"
 
@@ -24,7 +26,9 @@ outputColor(0),
 multisampledFbo(0),
 multisampledRbo(0),
 multisampledColorBuffer(0),
-selectionMaterial(nullptr)
+selectionMaterial(nullptr),
+instances(),
+batches()
 {
 }
 
@@ -109,7 +113,7 @@ void SceneViewForwardPass::destroy() {
 	multisampledFbo = 0;
 }
 
-uint32_t SceneViewForwardPass::render(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection, const Camera& camera, const std::vector<EntityContainer*>& selectedEntities)
+uint32_t SceneViewForwardPass::render(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection, const Camera& camera, const std::vector<EntityContainer*>& selectedEntities, const RenderQueue& renderQueue)
 {
 	// Bind framebuffer
 	glBindFramebuffer(GL_FRAMEBUFFER, multisampledFbo);
@@ -151,11 +155,11 @@ uint32_t SceneViewForwardPass::render(const glm::mat4& view, const glm::mat4& pr
 	}
 
 	// Render each entity
-	renderMeshes(selectedEntities);
+	renderMeshes(selectedEntities, renderQueue);
 
 	// Render selected entity with outline
 	for (auto& entity : selectedEntities) {
-		renderSelectedEntity(entity, viewProjection, camera);
+		renderSelectedEntity(entity, camera);
 	}
 
 	// Disable wireframe if enabled
@@ -191,66 +195,44 @@ void SceneViewForwardPass::linkGizmos(IMGizmo* _gizmos)
 	gizmos = _gizmos;
 }
 
-void SceneViewForwardPass::renderMesh(TransformComponent& transform, MeshRendererComponent& renderer)
+void SceneViewForwardPass::renderMeshes(const std::vector<EntityContainer*>& skippedEntities, const RenderQueue& renderQueue)
 {
-	// Transform components model and mvp must have been calculated beforehand
+	// Skip selected entity, it's rendered separately with an outline
+	// tmp
+	Entity skippedEntity = skippedEntities.size() > 0 ? skippedEntities[0]->root : entt::null;
 
-	// Renderer must be enabled
-	if (!renderer.enabled) return;
+	// Collect instances of identical mesh and material runs
+	Instancing::gather(renderQueue, true, instances, batches, skippedEntity);
+	Instancing::upload(instances, batches);
 
-	// Make sure mesh is available
-	if (!renderer.mesh) return;
+	// Bind geometry arena
+	glBindVertexArray(GeometryArena::getVAO());
 
-	// Set shader uniforms
-	Shader* shader = renderer.material->getShader();
-	shader->setMatrix4("mvpMatrix", transform.mvp);
-	shader->setMatrix4("modelMatrix", transform.model);
-	shader->setMatrix3("normalMatrix", transform.normal);
-
-	// Bind mesh
-	glBindVertexArray(renderer.mesh->getVAO());
-
-	// Render mesh
-	glDrawElements(GL_TRIANGLES, renderer.mesh->getIndiceCount(), GL_UNSIGNED_INT, 0);
-}
-
-void SceneViewForwardPass::renderMeshes(const std::vector<EntityContainer*>& skippedEntities)
-{
+	// Render batches of each material with a single indirect draw call
 	uint32_t currentShaderId = 0;
-	uint32_t currentMaterialId = 0;
+	uint32_t nBatches = static_cast<uint32_t>(batches.size());
+	for (uint32_t first = 0; first < nBatches;) {
+		const IMaterial* material = batches[first].material;
 
-	uint16_t newBoundShaders = 0;
-	uint16_t newBoundMaterials = 0;
+		// Find end of material run
+		uint32_t end = first + 1;
+		while (end < nBatches && batches[end].material == material) end++;
 
-	// Render each entity except for skipped one
-	for (auto& [entity, transform, renderer] : ECS::getRenderQueue()) {
-
-		// Skip if target entity is selected entity
-		// tmp
-		if (skippedEntities.size() > 0) {
-			if (skippedEntities[0]->root == entity) continue;
-		}
-
-		uint32_t shaderId = renderer.material->getShaderId();
+		// Bind shader if not bound already
+		uint32_t shaderId = material->getShaderId();
 		if (shaderId != currentShaderId) {
-			renderer.material->getShader()->bind();
+			material->getShader()->bind();
 			currentShaderId = shaderId;
-			newBoundShaders++;
 		}
 
-		uint32_t materialId = renderer.material->getId();
-		if (materialId != currentMaterialId) {
-			renderer.material->bind();
-			currentMaterialId = materialId;
-			newBoundMaterials++;
-		}
-
-		renderMesh(transform, renderer);
-
+		// Bind material and render all batches using it
+		material->bind();
+		Instancing::drawBatches(first, end - first);
+		first = end;
 	}
 }
 
-void SceneViewForwardPass::renderSelectedEntity(EntityContainer* entity, const glm::mat4& viewProjection, const Camera& camera)
+void SceneViewForwardPass::renderSelectedEntity(EntityContainer* entity, const Camera& camera)
 {
 	// Make sure selected entity is renderable
 	if (!entity->has<MeshRendererComponent>()) return;
@@ -259,8 +241,8 @@ void SceneViewForwardPass::renderSelectedEntity(EntityContainer* entity, const g
 	TransformComponent& transform = entity->transform;
 	MeshRendererComponent& renderer = entity->get<MeshRendererComponent>();
 
-	// Renderer must be enabled
-	if (!renderer.enabled) return;
+	// Renderer must be enabled and have a mesh
+	if (!renderer.enabled || !renderer.mesh) return;
 
 	// Get camera transform
 	TransformComponent& cameraTransform = std::get<0>(camera);
@@ -275,12 +257,8 @@ void SceneViewForwardPass::renderSelectedEntity(EntityContainer* entity, const g
 	// Forward render entities base mesh
 	Shader* shader = renderer.material->getShader();
 	shader->bind();
-	shader->setMatrix4("mvpMatrix", transform.mvp);
-	shader->setMatrix4("modelMatrix", transform.model);
-	shader->setMatrix3("normalMatrix", transform.normal);
 	renderer.material->bind();
-	glBindVertexArray(renderer.mesh->getVAO());
-	glDrawElements(GL_TRIANGLES, renderer.mesh->getIndiceCount(), GL_UNSIGNED_INT, 0);
+	Instancing::drawSingle(*renderer.mesh, transform.model, transform.normal);
 
 	// Don't render outline if wireframe is enabled
 	if (wireframe) return;
@@ -305,17 +283,13 @@ void SceneViewForwardPass::renderSelectedEntity(EntityContainer* entity, const g
 	outlineTransform.rotation = transform.rotation;
 	outlineTransform.scale = transform.scale + thickness;
 	outlineTransform.parent = transform.parent;
-	Transform::evaluate(outlineTransform, viewProjection);
+	Transform::evaluate(outlineTransform);
 
 	// Render mesh as outline
 	shader = selectionMaterial->getShader();
 	shader->bind();
-	shader->setMatrix4("mvpMatrix", outlineTransform.mvp);
-	shader->setMatrix4("modelMatrix", outlineTransform.model);
-	shader->setMatrix3("normalMatrix", outlineTransform.normal);
 	selectionMaterial->bind();
-	glBindVertexArray(renderer.mesh->getVAO());
-	glDrawElements(GL_TRIANGLES, renderer.mesh->getIndiceCount(), GL_UNSIGNED_INT, 0);
+	Instancing::drawSingle(*renderer.mesh, outlineTransform.model, outlineTransform.normal);
 
 	// Reset state
 	glDisable(GL_BLEND);
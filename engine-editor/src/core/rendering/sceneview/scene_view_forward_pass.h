@@ -7,6 +7,7 @@
 #include "../src/core/viewport/viewport.h"
 #include "../src/core/ecs/ecs_collection.h"
 #include "../src/core/rendering/gizmos/imgizmo.h"
+#include "../src/core/rendering/instancing/instancing.h"
 
 class Skybox;
 class IMaterial;
@@ -21,7 +22,7 @@ public:
 	void destroy(); // Destroys forward pass
 
 	// Scene view forward passes all entity render targets and returns color output
-	uint32_t render(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection, const Camera& camera, const std::vector<EntityContainer*>& selectedEntities);
+	uint32_t render(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection, const Camera& camera, const std::vector<EntityContainer*>& selectedEntities, const RenderQueue& renderQueue);
 
 	void linkSkybox(Skybox* skybox);
 	bool drawSkybox; // Draw skybox in scene view
@@ -46,10 +47,12 @@ private:
 
 	UnlitMaterial* selectionMaterial; // Material for selection outline
 
+	std::vector<Instancing::Instance> instances; // Instances of the render queue, reused across frames
+	std::vector<Instancing::Batch> batches; // Instanced draw batches of the render queue, reused across frames
+
 	// Default scene view clearing color rgb values
 	static constexpr float defaultClearColor[3] = { 0.015f, 0.015f, 0.015f };
 
-	void renderMesh(TransformComponent& transform, MeshRendererComponent& renderer); // Renders a given entities mesh
-	void renderMeshes(const std::vector<EntityContainer*>& skippedEntities); // Renders all meshes
-	void renderSelectedEntity(EntityContainer* entity, const glm::mat4& viewProjection, const Camera& camera); // Renders the selected entity with an outline
+	void renderMeshes(const std::vector<EntityContainer*>& skippedEntities, const RenderQueue& renderQueue); // Renders all meshes of the given render queue
+	void renderSelectedEntity(EntityContainer* entity, const Camera& camera); // Renders the selected entity with an outline
 };
\ No newline at end of file
@@ -1,11 +1,13 @@
 #include "shader.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <glad/glad.h>
 #include <gtc/type_ptr.hpp>
 
 #include "../../utils/console.h"
 #include "../../utils/iohandler.h"
+#include "../src/core/rendering/uniforms/uniform_buffer.h"
 
 namespace fs = std::filesystem;
 
@@ -41,41 +43,51 @@ uint32_t Shader::id() const
 	return _id;
 }
 
-void Shader::setBool(const std::string& identifier, bool value)
+void Shader::setBool(UniformId identifier, bool value)
 {
 	glUniform1i(getUniformLocation(identifier), (int32_t)value);
 }
-void Shader::setInt(const std::string& identifier, int32_t value)
+void Shader::setInt(UniformId identifier, int32_t value)
 {
 	glUniform1i(getUniformLocation(identifier), value);
 }
-void Shader::setFloat(const std::string& identifier, float value)
+void Shader::setFloat(UniformId identifier, float value)
 {
 	glUniform1f(getUniformLocation(identifier), value);
 }
-void Shader::setVec2(const std::string& identifier, glm::vec2 value)
+void Shader::setVec2(UniformId identifier, glm::vec2 value)
 {
 	glUniform2f(getUniformLocation(identifier), value.x, value.y);
 }
-void Shader::setVec3(const std::string& identifier, glm::vec3 value)
+void Shader::setVec3(UniformId identifier, glm::vec3 value)
 {
 	glUniform3f(getUniformLocation(identifier), value.x, value.y, value.z);
 }
-void Shader::setVec4(const std::string& identifier, glm::vec4 value)
+void Shader::setVec4(UniformId identifier, glm::vec4 value)
 {
 	glUniform4f(getUniformLocation(identifier), value.x, value.y, value.z, value.w);
 }
-void Shader::setMatrix3(const std::string& identifier, glm::mat3 value)
+void Shader::setMatrix3(UniformId identifier, glm::mat3 value)
 {
 	glUniformMatrix3fv(getUniformLocation(identifier), 1, GL_FALSE, glm::value_ptr(value));
 }
-void Shader::setMatrix4(const std::string& identifier, glm::mat4 value)
+void Shader::setMatrix4(UniformId identifier, glm::mat4 value)
 {
 	glUniformMatrix4fv(getUniformLocation(identifier), 1, GL_FALSE, glm::value_ptr(value));
 }
+void Shader::setVec3Array(UniformId identifier, const glm::vec3* values, int32_t count)
+{
+	glUniform3fv(getUniformLocation(identifier), count, glm::value_ptr(*values));
+}
 
 void Shader::loadData()
 {
+	// Compute shaders consist of a compute stage only
+	if (fs::exists(path + "/.comp")) {
+		data.computeSource = IOHandler::readFile(path + "/.comp");
+		return;
+	}
+
 	data.vertexSource = IOHandler::readFile(path + "/.vert");
 	data.fragmentSource = IOHandler::readFile(path + "/.frag");
 }
@@ -84,10 +96,17 @@ void Shader::releaseData()
 {
 	data.vertexSource.clear();
 	data.fragmentSource.clear();
+	data.computeSource.clear();
 }
 
 void Shader::dispatchGPU()
 {
+	// Dispatch compute shader if there is compute data
+	if (!data.computeSource.empty()) {
+		dispatchCompute();
+		return;
+	}
+
 	// Don't dispatch shader if there is no data
 	if (data.vertexSource.empty() || data.fragmentSource.empty()) return;
 
@@ -115,22 +134,97 @@ void Shader::dispatchGPU()
 	glLinkProgram(_id);
 	if (!programLinked(_id)) return;
 
+	// Link shared uniform blocks to their binding points
+	UniformBuffer::linkBlocks(_id);
+
+	// Resolve uniform locations
+	reflectUniforms();
+
 	// Delete shader sources
 	glDeleteShader(vertexShader);
 	glDeleteShader(fragmentShader);
 }
 
-int32_t Shader::getUniformLocation(const std::string& identifier)
+void Shader::dispatchCompute()
+{
+	// Compile compute shader source
+	const char* computeSource = data.computeSource.c_str();
+	uint32_t computeShader = glCreateShader(GL_COMPUTE_SHADER);
+	glShaderSource(computeShader, 1, &computeSource, nullptr);
+	glCompileShader(computeShader);
+	if (!shaderCompiled("compute", computeShader)) return;
+
+	// Create and link shader program
+	_id = glCreateProgram();
+	glAttachShader(_id, computeShader);
+	glLinkProgram(_id);
+	if (!programLinked(_id)) return;
+
+	// Link shared uniform blocks to their binding points
+	UniformBuffer::linkBlocks(_id);
+
+	// Resolve uniform locations
+	reflectUniforms();
+
+	// Delete shader source
+	glDeleteShader(computeShader);
+}
+
+void Shader::reflectUniforms()
 {
-	// Uniform found in cache, return uniform location
-	if (uniforms.find(identifier) != uniforms.end()) return uniforms[identifier];
+	uniforms.clear();
+
+	// Fetch amount of active uniforms
+	int32_t nUniforms = 0;
+	glGetProgramInterfaceiv(_id, GL_UNIFORM, GL_ACTIVE_RESOURCES, &nUniforms);
+
+	// Fetch maximum name length of active uniforms
+	int32_t maxNameLength = 0;
+	glGetProgramInterfaceiv(_id, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLength);
+	std::vector<char> nameBuffer(std::max(maxNameLength, 1));
+
+	// Register location of each active uniform
+	const GLenum properties[] = { GL_BLOCK_INDEX, GL_LOCATION, GL_ARRAY_SIZE };
+	for (int32_t i = 0; i < nUniforms; i++) {
+		int32_t values[3] = {};
+		glGetProgramResourceiv(_id, GL_UNIFORM, i, 3, properties, 3, nullptr, values);
+
+		// Skip members of uniform blocks, they are set through uniform buffers
+		int32_t blockIndex = values[0], location = values[1], arraySize = values[2];
+		if (blockIndex != -1 || location < 0) continue;
 
-	// Uniform not found in cache, fetch and save uniform location
-	int32_t location = glGetUniformLocation(_id, identifier.c_str());
-	uniforms[identifier] = location;
+		int32_t nameLength = 0;
+		glGetProgramResourceName(_id, GL_UNIFORM, i, static_cast<int32_t>(nameBuffer.size()), &nameLength, nameBuffer.data());
+		std::string name(nameBuffer.data(), nameLength);
+		uniforms.emplace_back(UniformId(name).hash, location);
 
-	// Return newly fetched uniform location
-	return location;
+		// Arrays are reported as "name[0]", register their base name and each element too
+		size_t arrayPosition = name.rfind("[0]");
+		if (arrayPosition == std::string::npos || arrayPosition + 3 != name.size()) continue;
+		std::string baseName = name.substr(0, arrayPosition);
+		uniforms.emplace_back(UniformId(baseName).hash, location);
+		for (int32_t element = 1; element < arraySize; element++) {
+			uniforms.emplace_back(UniformId(baseName + "[" + std::to_string(element) + "]").hash, location + element);
+		}
+	}
+
+	// Sort table for lookups
+	std::sort(uniforms.begin(), uniforms.end());
+
+	// Report uniforms whose name hashes collide
+	for (size_t i = 1; i < uniforms.size(); i++) {
+		if (uniforms[i].first == uniforms[i - 1].first && uniforms[i].second != uniforms[i - 1].second) {
+			Console::out::warning("Shader", "Uniform name hash collision in shader at '" + path + "'");
+		}
+	}
+}
+
+int32_t Shader::getUniformLocation(UniformId identifier) const
+{
+	// Binary search uniform location table
+	auto it = std::lower_bound(uniforms.begin(), uniforms.end(), std::make_pair(identifier.hash, INT32_MIN));
+	if (it == uniforms.end() || it->first != identifier.hash) return -1;
+	return it->second;
 }
 
 bool Shader::shaderCompiled(const char* type, int32_t shader)
@@ -157,7 +251,7 @@ bool Shader::programLinked(int32_t program)
 	// Fetch shader program linking status
 	int32_t success;
 	char shader_log[512];
-	glGetProgramiv(program, GL_COMPILE_STATUS, &success);
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
 
 	// Shader program linking failed, terminate program
 	if (!success)
@@ -3,9 +3,11 @@
 #include <cstdint>
 #include <glm.hpp>
 #include <string>
-#include <unordered_map>
+#include <vector>
+#include <utility>
 
 #include "../src/core/resource/resource.h"
+#include "../src/core/rendering/shader/uniform_id.h"
 
 class Shader : public Resource
 {
@@ -23,14 +25,17 @@ public:
 	// Returns the shader programs backend id
 	uint32_t id() const;
 
-	void setBool(const std::string& identifier, bool value);
-	void setInt(const std::string& identifier, int32_t value);
-	void setFloat(const std::string& identifier, float value);
-	void setVec2(const std::string& identifier, glm::vec2 value);
-	void setVec3(const std::string& identifier, glm::vec3 value);
-	void setVec4(const std::string& identifier, glm::vec4 value);
-	void setMatrix3(const std::string& identifier, glm::mat3 value);
-	void setMatrix4(const std::string& identifier, glm::mat4 value);
+	void setBool(UniformId identifier, bool value);
+	void setInt(UniformId identifier, int32_t value);
+	void setFloat(UniformId identifier, float value);
+	void setVec2(UniformId identifier, glm::vec2 value);
+	void setVec3(UniformId identifier, glm::vec3 value);
+	void setVec4(UniformId identifier, glm::vec4 value);
+	void setMatrix3(UniformId identifier, glm::mat3 value);
+	void setMatrix4(UniformId identifier, glm::mat4 value);
+
+	// Sets the given amount of elements of a vec3 array uniform
+	void setVec3Array(UniformId identifier, const glm::vec3* values, int32_t count);
 
 protected:
 	void loadData() override;
@@ -41,6 +46,7 @@ private:
 	struct Data {
 		std::string vertexSource;
 		std::string fragmentSource;
+		std::string computeSource;
 	};
 
 	// Path of shader source
@@ -52,11 +58,18 @@ private:
 	// Shader program backend id
 	uint32_t _id;
 
-	// Shader program uniform location cache
-	std::unordered_map<std::string, int32_t> uniforms;
+	// Uniform locations of the shader program sorted by uniform id hash, resolved once the program is linked
+	std::vector<std::pair<uint32_t, int32_t>> uniforms;
 
 private:
-	int32_t getUniformLocation(const std::string& identifier);
+	// Compiles and links the compute source into a compute shader program
+	void dispatchCompute();
+
+	// Fills the uniform location table by reflecting the active uniforms of the linked program
+	void reflectUniforms();
+
+	// Returns the location of the given uniform or -1 if the program has no such active uniform
+	int32_t getUniformLocation(UniformId identifier) const;
 
 	bool shaderCompiled(const char* type, int32_t shader);
 	bool programLinked(int32_t program);
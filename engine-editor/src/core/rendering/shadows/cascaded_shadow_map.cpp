@@ -0,0 +1,264 @@
+#include "cascaded_shadow_map.h"
+
+#include <glad/glad.h>
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+#include <gtc/matrix_transform.hpp>
+
+#include "../src/core/utils/console.h"
+#include "../src/core/ecs/ecs_collection.h"
+#include "../src/core/rendering/shader/shader_pool.h"
+#include "../src/core/rendering/transformation/transformation.h"
+
+// Per pass uniforms, hashed at compile time
+constexpr UniformId LIGHT_SPACE_MATRIX = "lightSpaceMatrix";
+
+// Blend between uniform (0) and logarithmic (1) cascade splits
+constexpr float SPLIT_LAMBDA = 0.75f;
+
+// Minimum cosine between the light directions of two updates for cached cascades to be kept
+constexpr float MIN_DIRECTION_COSINE = 0.99999f;
+
+// Precision cascade radii are rounded up to, keeping them constant while the view turns
+constexpr float RADIUS_PRECISION = 16.0f;
+
+CascadedShadowMap::CascadedShadowMap(uint32_t resolution, uint32_t nCascades, float distance) : resolution(resolution),
+nCascades(std::clamp(nCascades, 1u, MAX_CASCADES)),
+distance(distance),
+texture(0),
+framebuffer(0),
+cascades(),
+direction(glm::vec3(0.0f)),
+updates(0),
+shadowPassShader(nullptr),
+casterDepth(0.0f)
+{
+}
+
+void CascadedShadowMap::create()
+{
+	// Get shader
+	shadowPassShader = ShaderPool::get("shadow_pass");
+
+	// Generate framebuffer
+	glGenFramebuffers(1, &framebuffer);
+
+	// Generate texture array with a layer per cascade
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, resolution, resolution, nCascades, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+
+	// Set texture parameters
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+
+	// Set texture border
+	float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	// Set framebuffer attachments
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, 0);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+
+	// Check for framebuffer errors
+	GLenum fboStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if (fboStatus != GL_FRAMEBUFFER_COMPLETE)
+	{
+		Console::out::warning("Cascaded Shadow Map", "Issue while generating framebuffer: " + std::to_string(fboStatus));
+	}
+
+	// Unbind framebuffer
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void CascadedShadowMap::destroy()
+{
+	// Delete texture
+	glDeleteTextures(1, &texture);
+	texture = 0;
+
+	// Delete framebuffer
+	glDeleteFramebuffers(1, &framebuffer);
+	framebuffer = 0;
+
+	// Forget cached cascades
+	for (Cascade& cascade : cascades) cascade = Cascade();
+	direction = glm::vec3(0.0f);
+
+	// Reset shader
+	shadowPassShader = nullptr;
+}
+
+void CascadedShadowMap::castShadows(ShadowCasters& casters, const glm::mat4& view, const glm::mat4& projection)
+{
+	updates++;
+
+	// Get first enabled directional light
+	const TransformComponent* light = nullptr;
+	auto directionalLights = ECS::gRegistry.view<TransformComponent, DirectionalLightComponent>();
+	for (auto [entity, transform, directionalLight] : directionalLights.each()) {
+		if (!directionalLight.enabled) continue;
+		light = &transform;
+		break;
+	}
+
+	// Without a directional light there are no shadows to cast
+	if (!light) {
+		for (Cascade& cascade : cascades) cascade.rendered = false;
+		direction = glm::vec3(0.0f);
+		return;
+	}
+
+	// Cached cascades are outdated once the light turns
+	glm::vec3 lightDirection = Transformation::direction(light->model);
+	if (glm::dot(lightDirection, direction) < MIN_DIRECTION_COSINE) {
+		for (Cascade& cascade : cascades) cascade.rendered = false;
+	}
+	direction = lightDirection;
+
+	// Light view rotating world space into the lights view, cascades are placed within it by their projections
+	glm::vec3 up = std::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+	glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), direction, up);
+
+	// Get light view depth of the casters closest to the light
+	const FrustumCulling::BoundsBatch& bounds = casters.getBounds();
+	glm::vec3 depthAxis = glm::vec3(lightView[0][2], lightView[1][2], lightView[2][2]);
+	casterDepth = -FLT_MAX;
+	for (size_t i = 0; i < bounds.size(); i++) {
+		glm::vec3 center = glm::vec3(bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i]);
+		glm::vec3 extent = glm::vec3(bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i]);
+		casterDepth = std::max(casterDepth, glm::dot(depthAxis, center) + glm::dot(glm::abs(depthAxis), extent));
+	}
+
+	//
+	// RENDER CASCADES
+	//
+
+	// Near and far plane of the perspective projection, shadows are cast up to the shadow distance
+	float near = projection[3][2] / (projection[2][2] - 1.0f);
+	float far = std::min(projection[3][2] / (projection[2][2] + 1.0f), distance);
+	glm::mat4 inverseView = glm::inverse(view);
+
+	// Set viewport, bind framebuffer and shadow pass shader
+	glViewport(0, 0, resolution, resolution);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glEnable(GL_DEPTH_TEST);
+	glEnable(GL_CULL_FACE);
+	glCullFace(GL_FRONT);
+	shadowPassShader->bind();
+
+	float sliceNear = near;
+	for (uint32_t i = 0; i < nCascades; i++) {
+		// Split view depth between uniform and logarithmic splits
+		float t = static_cast<float>(i + 1) / static_cast<float>(nCascades);
+		float uniformSplit = near + (far - near) * t;
+		float logarithmicSplit = near * std::pow(far / near, t);
+		cascades[i].split = uniformSplit + (logarithmicSplit - uniformSplit) * SPLIT_LAMBDA;
+
+		// Fit and render cascades due, others keep their latest render
+		if (isDue(i)) {
+			fit(i, inverseView, projection, lightView, sliceNear, cascades[i].split);
+			render(i, casters);
+		}
+		sliceNear = cascades[i].split;
+	}
+
+	// Unbind framebuffer
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void CascadedShadowMap::bind(uint32_t unit)
+{
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+}
+
+uint32_t CascadedShadowMap::getTexture() const
+{
+	return texture;
+}
+
+uint32_t CascadedShadowMap::getResolution() const
+{
+	return resolution;
+}
+
+uint32_t CascadedShadowMap::getCascadeCount() const
+{
+	return direction == glm::vec3(0.0f) ? 0 : nCascades;
+}
+
+const glm::mat4& CascadedShadowMap::getLightSpace(uint32_t cascade) const
+{
+	return cascades[cascade].lightSpace;
+}
+
+float CascadedShadowMap::getSplit(uint32_t cascade) const
+{
+	return cascades[cascade].split;
+}
+
+float CascadedShadowMap::getTexelSize(uint32_t cascade) const
+{
+	return cascades[cascade].texelSize;
+}
+
+bool CascadedShadowMap::isDue(uint32_t index) const
+{
+	if (!cascades[index].rendered) return true;
+
+	// Each further cascade is rendered half as often, staggered so at most one of them is rendered along with the first cascade
+	uint64_t period = 1ull << index;
+	return updates % period == period / 2;
+}
+
+void CascadedShadowMap::fit(uint32_t index, const glm::mat4& inverseView, const glm::mat4& projection, const glm::mat4& lightView, float near, float far)
+{
+	Cascade& cascade = cascades[index];
+
+	// Get world space corners of the views slice
+	glm::vec3 corners[8];
+	glm::vec3 center = glm::vec3(0.0f);
+	for (uint32_t corner = 0; corner < 8; corner++) {
+		float depth = corner & 4 ? far : near;
+		glm::vec4 viewCorner = glm::vec4((corner & 1 ? 1.0f : -1.0f) * depth / projection[0][0], (corner & 2 ? 1.0f : -1.0f) * depth / projection[1][1], -depth, 1.0f);
+		corners[corner] = glm::vec3(inverseView * viewCorner);
+		center += corners[corner] / 8.0f;
+	}
+
+	// Bounding sphere of the slice, its radius rounded up so it stays constant while the view turns
+	float radius = 0.0f;
+	for (const glm::vec3& corner : corners) radius = std::max(radius, glm::length(corner - center));
+	radius = std::ceil(radius * RADIUS_PRECISION) / RADIUS_PRECISION;
+
+	// Snap sphere center to texels of the light view, so shadow edges don't shimmer while the view moves
+	float texelSize = 2.0f * radius / static_cast<float>(resolution);
+	glm::vec3 lightCenter = glm::vec3(lightView * glm::vec4(center, 1.0f));
+	lightCenter.x = std::floor(lightCenter.x / texelSize) * texelSize;
+	lightCenter.y = std::floor(lightCenter.y / texelSize) * texelSize;
+
+	// Project sphere orthographically, reaching back to the casters closest to the light
+	float closest = std::max(lightCenter.z + radius, casterDepth);
+	glm::mat4 lightProjection = glm::ortho(lightCenter.x - radius, lightCenter.x + radius, lightCenter.y - radius, lightCenter.y + radius, -closest, radius - lightCenter.z);
+
+	cascade.lightSpace = lightProjection * lightView;
+	cascade.texelSize = texelSize;
+	cascade.rendered = true;
+}
+
+void CascadedShadowMap::render(uint32_t index, ShadowCasters& casters)
+{
+	const Cascade& cascade = cascades[index];
+
+	// Render casters into the cascades layer
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, static_cast<GLint>(index));
+	glClear(GL_DEPTH_BUFFER_BIT);
+	shadowPassShader->setMatrix4(LIGHT_SPACE_MATRIX, cascade.lightSpace);
+	casters.draw(cascade.lightSpace);
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <glm.hpp>
+
+#include "../src/core/rendering/shader/shader.h"
+#include "../src/core/rendering/shadows/shadow_casters.h"
+
+// Shadows of the main directional light split into cascades along the view depth of a camera, each cascade rendered into a layer of a single depth texture array
+class CascadedShadowMap
+{
+public:
+	explicit CascadedShadowMap(uint32_t resolution, uint32_t nCascades, float distance);
+
+	// Create the cascaded shadow map
+	void create();
+
+	// Destroy the cascaded shadow map
+	void destroy();
+
+	// Fits the cascades to the given camera view and renders the given casters into the cascades due for the first enabled directional light of the global registry
+	void castShadows(ShadowCasters& casters, const glm::mat4& view, const glm::mat4& projection);
+
+	// Bind the cascades texture array to a given unit
+	void bind(uint32_t unit);
+
+	// Returns the texture array of the cascades
+	uint32_t getTexture() const;
+
+	// Returns the resolution of each cascade
+	uint32_t getResolution() const;
+
+	// Returns the amount of cascades holding shadows (0 if there is no directional light)
+	uint32_t getCascadeCount() const;
+
+	// Returns the light space matrix the given cascade was rendered with
+	const glm::mat4& getLightSpace(uint32_t cascade) const;
+
+	// Returns the view depth the given cascade covers up to
+	float getSplit(uint32_t cascade) const;
+
+	// Returns the world space size of a texel of the given cascade
+	float getTexelSize(uint32_t cascade) const;
+
+	// Maximum amount of cascades (must match the lit shader)
+	static constexpr uint32_t MAX_CASCADES = 4;
+
+private:
+	// Cascade covering a slice of the views depth
+	struct Cascade
+	{
+		// Light space matrix of the latest render
+		glm::mat4 lightSpace = glm::mat4(1.0f);
+
+		// View depth the cascade covers up to
+		float split = 0.0f;
+
+		// World space size of a texel of the latest render
+		float texelSize = 0.0f;
+
+		// If the cascade was rendered for the current light direction
+		bool rendered = false;
+	};
+
+	// Returns if the cascade at the given index is due for rendering during the current update
+	bool isDue(uint32_t index) const;
+
+	// Fits the cascade at the given index to the slice of the given view between the given depths, texel snapped in the given light view
+	void fit(uint32_t index, const glm::mat4& inverseView, const glm::mat4& projection, const glm::mat4& lightView, float near, float far);
+
+	// Renders the given casters within the light space of the cascade at the given index into its layer
+	void render(uint32_t index, ShadowCasters& casters);
+
+	// Resolution of each cascade
+	uint32_t resolution;
+
+	// Amount of cascades
+	uint32_t nCascades;
+
+	// View depth shadows are cast up to
+	float distance;
+
+	// Cascades texture array backend id
+	uint32_t texture;
+
+	// Cascades backend framebuffer id
+	uint32_t framebuffer;
+
+	// Cascades fit to the latest view
+	Cascade cascades[MAX_CASCADES];
+
+	// Light direction the cascades were rendered for (zero if there was no directional light)
+	glm::vec3 direction;
+
+	// Amount of updates so far
+	uint64_t updates;
+
+	// Shadow pass shader
+	Shader* shadowPassShader;
+
+	// Light view depth of the caster closest to the light
+	float casterDepth;
+};
@@ -0,0 +1,57 @@
+#include "shadow_casters.h"
+
+#include <glad/glad.h>
+
+#include "../src/core/rendering/model/mesh.h"
+#include "../src/core/rendering/geometry/geometry_arena.h"
+#include "../src/core/rendering/renderqueue/render_key.h"
+
+ShadowCasters::ShadowCasters() : bounds(),
+visible(),
+queue(),
+sortScratch(),
+instances(),
+batches()
+{
+}
+
+void ShadowCasters::gather()
+{
+	const RenderQueue& renderQueue = ECS::getRenderQueue();
+	bounds.resize(renderQueue.size());
+	for (size_t i = 0; i < renderQueue.size(); i++) {
+		const BoundsComponent& casterBounds = ECS::gRegistry.get<BoundsComponent>(renderQueue[i].entity);
+		bounds.set(i, casterBounds.min, casterBounds.max);
+	}
+}
+
+void ShadowCasters::draw(const glm::mat4& lightSpace)
+{
+	// Cull casters outside of the light space
+	FrustumCulling::Frustum frustum = FrustumCulling::extract(lightSpace);
+	FrustumCulling::test(frustum, bounds, visible);
+
+	// Order visible casters by mesh so identical meshes form instanced batches
+	const RenderQueue& renderQueue = ECS::getRenderQueue();
+	queue.resize(visible.size());
+	for (size_t i = 0; i < visible.size(); i++) {
+		Entity entity = renderQueue[visible[i]].entity;
+		const MeshRendererComponent& renderer = ECS::gRegistry.get<MeshRendererComponent>(entity);
+		uint32_t meshId = renderer.mesh ? renderer.mesh->getId() : 0;
+		queue[i] = { RenderKey::pack(RenderKey::Pass::SOLID_GEOMETRY, 0, 0, meshId, 0.0f), entity };
+	}
+	RenderKey::sort(queue, sortScratch);
+
+	// Collect instances of identical mesh runs
+	Instancing::gather(queue, false, instances, batches);
+	Instancing::upload(instances, batches);
+
+	// Render all batches with a single indirect draw call
+	glBindVertexArray(GeometryArena::getVAO());
+	Instancing::drawBatches(0, static_cast<uint32_t>(batches.size()));
+}
+
+const FrustumCulling::BoundsBatch& ShadowCasters::getBounds() const
+{
+	return bounds;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm.hpp>
+
+#include "../src/core/ecs/ecs_collection.h"
+#include "../src/core/rendering/instancing/instancing.h"
+#include "../src/core/rendering/culling/frustum_culling.h"
+
+// Shadow casters of the global render queue, culled against and drawn instanced into the light spaces of shadow maps
+class ShadowCasters
+{
+public:
+	ShadowCasters();
+
+	// Gathers the world space bounds of all shadow casters, once per update before drawing them
+	void gather();
+
+	// Draws all gathered casters within the given light space into the bound framebuffer using the bound shader
+	void draw(const glm::mat4& lightSpace);
+
+	// Returns the bounds of all gathered casters
+	const FrustumCulling::BoundsBatch& getBounds() const;
+
+private:
+	// Bounds of all casters and indices of the casters within a light space
+	FrustumCulling::BoundsBatch bounds;
+	std::vector<uint32_t> visible;
+
+	// Visible casters sorted by mesh and scratch buffer for sorting them
+	RenderQueue queue;
+	RenderQueue sortScratch;
+
+	// Instances and instanced draw batches of the visible casters
+	std::vector<Instancing::Instance> instances;
+	std::vector<Instancing::Batch> batches;
+};
@@ -11,6 +11,8 @@ namespace fs = std::filesystem;
 
 Cubemap::Cubemap() : source(),
 data(),
+dispatchedFaces(0),
+pendingId(0),
 id(0)
 {
 }
@@ -89,24 +91,38 @@ void Cubemap::releaseData()
 }
 
 void Cubemap::dispatchGPU()
+{
+	// Dispatch all faces at once
+	while (!dispatchChunk());
+}
+
+bool Cubemap::dispatchChunk()
 {
 	// Don't dispatch cubemap if there is no data
-	if (data.empty()) return;
+	if (data.empty()) return true;
 
-	glGenTextures(1, &id);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, id);
+	// First chunk, generate cubemap texture
+	if (dispatchedFaces == 0) {
+		glGenTextures(1, &pendingId);
+	}
+	glBindTexture(GL_TEXTURE_CUBE_MAP, pendingId);
 
-	for (int32_t i = 0; i < data.size(); i++)
+	// Upload next face
+	const FaceData& face = data[dispatchedFaces];
+
+	GLenum format = GL_RGB;
+	if (face.channels == 4)
 	{
-		FaceData face = data[i];
+		format = GL_RGBA;
+	}
 
-		GLenum format = GL_RGB;
-		if (face.channels == 4)
-		{
-			format = GL_RGBA;
-		}
+	glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + dispatchedFaces, 0, GL_SRGB, face.width, face.height, 0, format, GL_UNSIGNED_BYTE, face.data.data());
+	dispatchedFaces++;
 
-		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_SRGB, face.width, face.height, 0, format, GL_UNSIGNED_BYTE, face.data.data());
+	// Cubemap incomplete, continue with next face
+	if (dispatchedFaces < data.size()) {
+		glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+		return false;
 	}
 
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -116,11 +132,24 @@ void Cubemap::dispatchGPU()
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
 	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+	// Cubemap complete, use it from now on
+	id = pendingId;
+	pendingId = 0;
+	dispatchedFaces = 0;
+
+	return true;
+}
+
+size_t Cubemap::getChunkSize()
+{
+	if (dispatchedFaces >= data.size()) return 0;
+	return data[dispatchedFaces].data.size();
 }
 
 Cubemap::ImageData Cubemap::loadImageData(std::string path)
 {
-	stbi_set_flip_vertically_on_load(false);
+	stbi_set_flip_vertically_on_load_thread(false);
 
 	int32_t width, height, channels;
 	unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
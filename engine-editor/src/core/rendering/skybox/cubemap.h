@@ -26,6 +26,8 @@ protected:
 	void loadData() override;
 	void releaseData() override;
 	void dispatchGPU() override;
+	bool dispatchChunk() override;
+	size_t getChunkSize() override;
 
 private:
 	struct Source {
@@ -78,6 +80,12 @@ private:
 	// Cubemap data
 	std::vector<FaceData> data;
 
+	// Amount of faces uploaded by previous dispatch chunks
+	uint32_t dispatchedFaces;
+
+	// Backend id of the cubemap being dispatched, becomes the cubemaps backend id once complete
+	uint32_t pendingId;
+
 	// Backend id of cubemap texture
 	uint32_t id;
 
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+// Generation of texture mip levels on the cpu (on any thread)
+namespace MipGenerator
+{
+
+	// Encoding of an images channels, defining how they are averaged
+	enum class Encoding
+	{
+		// Channels are averaged as they are
+		LINEAR,
+
+		// Color channels are srgb encoded and averaged in linear space, alpha is averaged as it is
+		SRGB,
+
+		// First three channels hold a unit vector which is renormalized after averaging, alpha is averaged as it is
+		NORMAL
+	};
+
+	// Returns the amount of levels of a full mip chain of an image with the given dimensions
+	uint32_t getLevelCount(uint32_t width, uint32_t height);
+
+	// Returns the dimension of the next mip level given the dimension of a level
+	uint32_t getNextDimension(uint32_t dimension);
+
+	// Downsamples the given 8-bit image by a 2x2 box filter into the next mip level
+	void downsample(const uint8_t* source, uint32_t width, uint32_t height, uint32_t channels, Encoding encoding, uint8_t* destination);
+
+};
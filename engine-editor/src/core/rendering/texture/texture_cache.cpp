@@ -0,0 +1,173 @@
+#include "texture_cache.h"
+
+#include <thread>
+#include <fstream>
+#include <cstring>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace TextureCache {
+
+	// Identifier at the start of every cache
+	constexpr char MAGIC[4] = { 'N', 'T', 'E', 'X' };
+
+	// Version of the cache layout itself
+	constexpr uint32_t FORMAT_VERSION = 1;
+
+	// Alignment of every section within the cache
+	constexpr uint64_t SECTION_ALIGNMENT = 16;
+
+	// Maximum amount of mip levels of a cache
+	constexpr uint32_t MAX_LEVELS = 32;
+
+	struct Header
+	{
+		char magic[4];
+		uint32_t formatVersion;
+		uint32_t cookerVersion;
+		uint32_t blockFormat;
+		uint64_t sourceHash;
+		uint32_t levelCount;
+		uint32_t padding;
+	};
+
+	// Entry of the level table, level offsets are relative to the start of the cache
+	struct LevelEntry
+	{
+		uint32_t width;
+		uint32_t height;
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	// Returns the given offset rounded up to the section alignment
+	uint64_t _align(uint64_t offset)
+	{
+		return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+	}
+
+	// Returns if the given range lies within the cache
+	bool _inBounds(const MappedFile& file, uint64_t offset, uint64_t size)
+	{
+		return offset <= file.getSize() && size <= file.getSize() - offset;
+	}
+
+	std::string getCachePath(const std::string& sourcePath)
+	{
+		return sourcePath + ".ntex";
+	}
+
+	bool read(const MappedFile& file, uint64_t sourceHash, TextureCompression::BlockFormat format, std::vector<Level>& levels)
+	{
+		levels.clear();
+		if (!file.isOpen() || !_inBounds(file, 0, sizeof(Header))) return false;
+
+		// Validate header
+		const uint8_t* data = file.getData();
+		Header header;
+		std::memcpy(&header, data, sizeof(Header));
+		if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+		if (header.formatVersion != FORMAT_VERSION || header.cookerVersion != COOKER_VERSION) return false;
+		if (header.blockFormat != static_cast<uint32_t>(format) || header.sourceHash != sourceHash) return false;
+		if (header.levelCount == 0 || header.levelCount > MAX_LEVELS) return false;
+
+		// Read level table
+		uint64_t tableOffset = _align(sizeof(Header));
+		if (!_inBounds(file, tableOffset, static_cast<uint64_t>(header.levelCount) * sizeof(LevelEntry))) return false;
+
+		levels.reserve(header.levelCount);
+		for (uint32_t i = 0; i < header.levelCount; i++) {
+			LevelEntry entry;
+			std::memcpy(&entry, data + tableOffset + i * sizeof(LevelEntry), sizeof(LevelEntry));
+
+			// Validate level
+			if (entry.width == 0 || entry.height == 0) return false;
+			if (entry.size != TextureCompression::getImageSize(format, entry.width, entry.height)) return false;
+			if (!_inBounds(file, entry.offset, entry.size)) return false;
+
+			// Point level into mapping
+			Level level;
+			level.width = entry.width;
+			level.height = entry.height;
+			level.data = data + entry.offset;
+			level.size = static_cast<size_t>(entry.size);
+			levels.push_back(level);
+		}
+
+		return true;
+	}
+
+	bool write(const std::string& path, uint64_t sourceHash, TextureCompression::BlockFormat format, const std::vector<Level>& levels)
+	{
+		if (levels.empty() || levels.size() > MAX_LEVELS) return false;
+
+		//
+		// LAYOUT
+		//
+
+		Header header;
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.formatVersion = FORMAT_VERSION;
+		header.cookerVersion = COOKER_VERSION;
+		header.blockFormat = static_cast<uint32_t>(format);
+		header.sourceHash = sourceHash;
+		header.levelCount = static_cast<uint32_t>(levels.size());
+		header.padding = 0;
+
+		uint64_t tableOffset = _align(sizeof(Header));
+		uint64_t offset = _align(tableOffset + levels.size() * sizeof(LevelEntry));
+
+		std::vector<LevelEntry> table(levels.size());
+		for (size_t i = 0; i < levels.size(); i++) {
+			table[i].width = levels[i].width;
+			table[i].height = levels[i].height;
+			table[i].offset = offset;
+			table[i].size = levels[i].size;
+			offset = _align(offset + levels[i].size);
+		}
+
+		//
+		// WRITE
+		//
+
+		// Write to temporary file first so readers never map a partially written cache (unique per thread as loaders may cook the same source concurrently)
+		std::string temporaryPath = path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+		{
+			std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+			if (!stream.is_open()) return false;
+
+			// Writes the given bytes at the given offset, padding up to it
+			auto writeAt = [&stream](uint64_t at, const void* bytes, uint64_t size) {
+				static const char padding[SECTION_ALIGNMENT] = {};
+				uint64_t position = static_cast<uint64_t>(stream.tellp());
+				if (at > position) stream.write(padding, at - position);
+				if (size > 0) stream.write(static_cast<const char*>(bytes), size);
+			};
+
+			writeAt(0, &header, sizeof(Header));
+			writeAt(tableOffset, table.data(), table.size() * sizeof(LevelEntry));
+			for (size_t i = 0; i < levels.size(); i++) {
+				writeAt(table[i].offset, levels[i].data, levels[i].size);
+			}
+
+			if (!stream.good()) {
+				stream.close();
+				std::error_code error;
+				fs::remove(temporaryPath, error);
+				return false;
+			}
+		}
+
+		// Replace previous cache
+		std::error_code error;
+		fs::rename(temporaryPath, path, error);
+		if (error) {
+			fs::remove(temporaryPath, error);
+			return false;
+		}
+
+		return true;
+	}
+
+}
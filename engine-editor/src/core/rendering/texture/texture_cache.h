@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "../src/core/utils/mapped_file.h"
+#include "../src/core/rendering/texture/texture_compression.h"
+
+// Cooked block compressed texture files (.ntex) next to texture sources, holding the full mip chain of a texture
+namespace TextureCache
+{
+
+	// Version of the texture cooker, caches cooked by another version are stale
+	constexpr uint32_t COOKER_VERSION = 2;
+
+	// Single mip level of a cooked texture
+	struct Level
+	{
+		uint32_t width = 0;
+		uint32_t height = 0;
+
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+	};
+
+	// Returns the path of the cache belonging to the given texture source
+	std::string getCachePath(const std::string& sourcePath);
+
+	// Reads the mip levels of the given mapped cache, the levels point into the mapping
+	// Returns false if the cache is malformed, stale, doesn't match the source hash or holds another format
+	bool read(const MappedFile& file, uint64_t sourceHash, TextureCompression::BlockFormat format, std::vector<Level>& levels);
+
+	// Writes the given mip levels to a cache at the given path, returns if the cache could be written
+	bool write(const std::string& path, uint64_t sourceHash, TextureCompression::BlockFormat format, const std::vector<Level>& levels);
+
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm.hpp>
+
+#include "../src/core/ecs/ecs.h"
+
+class Texture;
+
+// Streams texture levels in and out by the resolution textures are seen at on screen, keeping resident levels within a video memory budget (on main thread)
+namespace TextureStreaming
+{
+
+	// Statistics of the latest update
+	struct Stats
+	{
+		// Amount of streamed textures
+		uint32_t textures = 0;
+
+		// Bytes of the levels resident before the update
+		size_t residentBytes = 0;
+
+		// Bytes the levels required on screen would take without a budget
+		size_t requiredBytes = 0;
+
+		// Bytes of the levels targeted within the budget
+		size_t targetBytes = 0;
+
+		// Amount of textures streaming levels in
+		uint32_t streaming = 0;
+
+		// Amount of textures levels were evicted from
+		uint32_t evicted = 0;
+	};
+
+	// Sets the amount of video memory the levels of streamed textures may take
+	void setBudget(size_t bytes);
+
+	// Returns the amount of video memory the levels of streamed textures may take
+	size_t getBudget();
+
+	// Returns the statistics of the latest update
+	Stats readStats();
+
+	// Adds the given texture to the streamed textures (no-op if already streamed)
+	void add(Texture* texture);
+
+	// Removes the given texture from the streamed textures
+	void remove(Texture* texture);
+
+	// Requests the levels needed to sample the given texture at the given amount of uv units per screen pixel until the next update
+	void request(Texture* texture, float uvPerPixel);
+
+	// Requests the texture levels needed to render the given visible entities from the given camera position, projection and viewport height
+	void requestVisible(const RenderQueue& queue, glm::vec3 cameraPosition, const glm::mat4& projection, float viewportHeight);
+
+	// Streams in levels requested since the last update and evicts levels no longer needed or exceeding the budget
+	void update();
+
+};
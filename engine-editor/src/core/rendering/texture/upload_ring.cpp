@@ -0,0 +1,226 @@
+#include "upload_ring.h"
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <cstring>
+#include <condition_variable>
+#include <glad/glad.h>
+
+namespace UploadRing {
+
+	// Capacity of the ring buffer in bytes
+	constexpr size_t CAPACITY = 64 * 1024 * 1024;
+
+	// Alignment of the regions within the ring buffer
+	constexpr size_t REGION_ALIGNMENT = 256;
+
+	// Allocated range of the ring
+	struct Block
+	{
+		uint64_t id = 0;
+
+		// Start of the range consumed by the block, including padding skipped when wrapping around
+		size_t begin = 0;
+
+		// Offset and end of the blocks data
+		size_t offset = 0;
+		size_t end = 0;
+
+		// Set once the main thread issued all commands reading from the block
+		bool released = false;
+
+		// Fence signaled once the gpu finished reading from the block
+		GLsync fence = nullptr;
+	};
+
+	uint32_t gBuffer = 0;
+	uint8_t* gMapping = nullptr;
+
+	// Thread the ring was created on, which never waits for free space
+	std::thread::id gMainThread;
+
+	// Mutex guarding the ring state
+	std::mutex gMtx;
+
+	// Condition variable notified whenever space is reclaimed or a write finished
+	std::condition_variable gStateChanged;
+
+	// Allocated blocks in order of allocation
+	std::deque<Block> gBlocks;
+
+	// Offset the next block is allocated at
+	size_t gHead = 0;
+
+	// Identifier of the next block
+	uint64_t gNextId = 1;
+
+	// Amount of writes in progress
+	uint32_t gWriters = 0;
+
+	// Returns the given offset rounded up to the region alignment
+	size_t _align(size_t offset)
+	{
+		return (offset + REGION_ALIGNMENT - 1) & ~(REGION_ALIGNMENT - 1);
+	}
+
+	// Tries to reserve a contiguous range of the given size at the head of the ring, returns if the range could be reserved
+	bool _reserve(size_t size, Block& block)
+	{
+		size_t alignedHead = _align(gHead);
+		block.begin = gHead;
+
+		if (gBlocks.empty()) {
+			// Ring is empty, start over at its beginning
+			block.begin = 0;
+			block.offset = 0;
+		}
+		else if (gHead > gBlocks.front().begin) {
+			// Free space is behind the head and before the oldest block
+			if (alignedHead + size <= CAPACITY) {
+				block.offset = alignedHead;
+			}
+			else if (size <= gBlocks.front().begin) {
+				block.offset = 0;
+			}
+			else {
+				return false;
+			}
+		}
+		else {
+			// Free space is between the head and the oldest block
+			if (alignedHead + size > gBlocks.front().begin) return false;
+			block.offset = alignedHead;
+		}
+
+		block.id = gNextId++;
+		block.end = block.offset + size;
+		gHead = block.end;
+
+		return true;
+	}
+
+	void create()
+	{
+		gMainThread = std::this_thread::get_id();
+
+		// Create immutable buffer storage mapped for the lifetime of the ring
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glGenBuffers(1, &gBuffer);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, gBuffer);
+		glBufferStorage(GL_PIXEL_UNPACK_BUFFER, CAPACITY, nullptr, flags);
+		void* mapping = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, CAPACITY, flags);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		std::lock_guard<std::mutex> lock(gMtx);
+		gMapping = static_cast<uint8_t*>(mapping);
+		gBlocks.clear();
+		gHead = 0;
+	}
+
+	void destroy()
+	{
+		{
+			// Wait for pending writes, then stop further writes
+			std::unique_lock<std::mutex> lock(gMtx);
+			gStateChanged.wait(lock, []() { return gWriters == 0; });
+			gMapping = nullptr;
+
+			for (Block& block : gBlocks) {
+				if (block.fence) glDeleteSync(block.fence);
+			}
+			gBlocks.clear();
+			gHead = 0;
+		}
+
+		// Wake loaders waiting for free space
+		gStateChanged.notify_all();
+
+		// Unmap and delete ring buffer
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, gBuffer);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glDeleteBuffers(1, &gBuffer);
+		gBuffer = 0;
+	}
+
+	uint32_t getBuffer()
+	{
+		return gBuffer;
+	}
+
+	Region write(const void* data, size_t size)
+	{
+		// Data can never fit into the ring
+		if (size == 0 || size > CAPACITY) return Region();
+
+		// Reserve range, waiting for the main thread to retire blocks if needed
+		Block block;
+		std::unique_lock<std::mutex> lock(gMtx);
+		bool wait = std::this_thread::get_id() != gMainThread;
+		while (true) {
+			if (!gMapping) return Region();
+			if (_reserve(size, block)) break;
+			if (!wait) return Region();
+			gStateChanged.wait(lock);
+		}
+		gBlocks.push_back(block);
+		gWriters++;
+		uint8_t* destination = gMapping + block.offset;
+		lock.unlock();
+
+		// Copy data into the mapping (coherent, visible to the gpu without flushing)
+		std::memcpy(destination, data, size);
+
+		// Finish write
+		lock.lock();
+		gWriters--;
+		lock.unlock();
+		gStateChanged.notify_all();
+
+		Region region;
+		region.id = block.id;
+		region.offset = block.offset;
+		region.size = size;
+		return region;
+	}
+
+	void release(Region region)
+	{
+		if (!region.id) return;
+
+		std::lock_guard<std::mutex> lock(gMtx);
+		for (Block& block : gBlocks) {
+			if (block.id != region.id) continue;
+
+			// Fence commands issued so far, which include all commands reading from the block
+			block.released = true;
+			block.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			return;
+		}
+	}
+
+	void retire()
+	{
+		bool retired = false;
+		{
+			// Reclaim blocks in order of allocation as long as the gpu finished reading from them
+			std::lock_guard<std::mutex> lock(gMtx);
+			while (!gBlocks.empty() && gBlocks.front().released) {
+				Block& block = gBlocks.front();
+				if (block.fence) {
+					GLenum status = glClientWaitSync(block.fence, 0, 0);
+					if (status == GL_TIMEOUT_EXPIRED) break;
+					glDeleteSync(block.fence);
+				}
+				gBlocks.pop_front();
+				retired = true;
+			}
+			if (gBlocks.empty()) gHead = 0;
+		}
+
+		// Wake loaders waiting for free space
+		if (retired) gStateChanged.notify_all();
+	}
+
+}
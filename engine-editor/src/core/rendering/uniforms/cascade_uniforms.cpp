@@ -0,0 +1,36 @@
+#include "cascade_uniforms.h"
+
+CascadeUniforms::CascadeUniforms() : buffer()
+{
+}
+
+void CascadeUniforms::create()
+{
+	buffer.create(sizeof(Data));
+}
+
+void CascadeUniforms::destroy()
+{
+	buffer.destroy();
+}
+
+void CascadeUniforms::update(const CascadedShadowMap& cascadedShadowMap)
+{
+	// Gather cascades
+	Data data = {};
+	data.nCascades = static_cast<int32_t>(cascadedShadowMap.getCascadeCount());
+	for (uint32_t i = 0; i < cascadedShadowMap.getCascadeCount(); i++) {
+		data.lightSpaces[i] = cascadedShadowMap.getLightSpace(i);
+		data.splits[i] = cascadedShadowMap.getSplit(i);
+		data.texelSizes[i] = cascadedShadowMap.getTexelSize(i);
+	}
+
+	// Upload and bind data
+	buffer.update(&data, sizeof(Data));
+	bind();
+}
+
+void CascadeUniforms::bind() const
+{
+	buffer.bind(UniformBinding::CASCADES);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+#include <glm.hpp>
+
+#include "../src/core/rendering/uniforms/uniform_buffer.h"
+#include "../src/core/rendering/uniforms/storage_buffer.h"
+
+class ShadowAtlas;
+
+// Light sources shared by all lit shaders through the "LightUniforms" block and the "PointLights" and "Spotlights" storage blocks
+class LightUniforms
+{
+public:
+	// Layouts of storage blocks (std430)
+	struct PointLight {
+		glm::vec3 position;
+		float intensity;
+		glm::vec3 color;
+		float range;
+		float falloff;
+		int32_t shadowTile; // Index of the first of its six shadow atlas tiles (-1 if it casts no shadows)
+		float _padding[2];
+	};
+
+	struct Spotlight {
+		glm::vec3 position;
+		float intensity;
+		glm::vec3 direction;
+		float range;
+		glm::vec3 color;
+		float falloff;
+		float innerCos;
+		float outerCos;
+		int32_t shadowTile; // Index of its shadow atlas tile (-1 if it casts no shadows)
+		float _padding;
+	};
+
+	LightUniforms();
+
+	// Creates the lights uniform and storage buffers
+	void create();
+
+	// Destroys the lights uniform and storage buffers
+	void destroy();
+
+	// Gathers all enabled light sources of the global registry along with their tiles in given shadow atlas, uploads them and binds them for all upcoming draws
+	void update(const ShadowAtlas& shadowAtlas);
+
+	// Uploads a single sample directional light and binds it for all upcoming draws (e.g. for previews)
+	void updateSample();
+
+	// Binds the light data for all upcoming draws
+	void bind() const;
+
+	// Returns the uploaded point lights
+	const std::vector<PointLight>& getPointLights() const;
+
+	// Returns the uploaded spotlights
+	const std::vector<Spotlight>& getSpotlights() const;
+
+	// Limitations (must match the lit shader), point lights and spotlights are unlimited
+	static constexpr int32_t MAX_DIRECTIONAL_LIGHTS = 1;
+
+private:
+	// Layouts of uniform block (std140)
+	struct DirectionalLight {
+		glm::vec3 direction;
+		float intensity;
+		glm::vec3 color;
+		float _padding0;
+		glm::vec3 position;
+		float _padding1;
+	};
+
+	struct Data {
+		DirectionalLight directionalLights[MAX_DIRECTIONAL_LIGHTS];
+		int32_t nDirectionalLights;
+		int32_t nPointLights;
+		int32_t nSpotlights;
+		int32_t _padding;
+	};
+
+	// Uploads and binds given light data along with the gathered point lights and spotlights
+	void upload(Data& data);
+
+	// Uniform buffer holding directional light data and light counts
+	UniformBuffer buffer;
+
+	// Storage buffers holding point lights and spotlights
+	StorageBuffer pointLightBuffer;
+	StorageBuffer spotlightBuffer;
+
+	// Gathered point lights and spotlights, reused across frames
+	std::vector<PointLight> pointLights;
+	std::vector<Spotlight> spotlights;
+};
@@ -0,0 +1,50 @@
+#include "storage_buffer.h"
+
+#include <algorithm>
+#include <glad/glad.h>
+
+StorageBuffer::StorageBuffer() : _id(0),
+capacity(0)
+{
+}
+
+void StorageBuffer::create()
+{
+	capacity = MIN_CAPACITY;
+
+	// Generate buffer and allocate its memory
+	glGenBuffers(1, &_id);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, _id);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, capacity, nullptr, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void StorageBuffer::destroy()
+{
+	glDeleteBuffers(1, &_id);
+	_id = 0;
+	capacity = 0;
+}
+
+void StorageBuffer::upload(const void* data, size_t size)
+{
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, _id);
+
+	// Grow buffer if data doesn't fit, orphan its storage otherwise so pending draws don't stall
+	if (size > capacity) capacity = std::max(size, capacity * 2);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, capacity, nullptr, GL_DYNAMIC_DRAW);
+
+	// Upload data
+	if (size) glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void StorageBuffer::bind(uint32_t binding) const
+{
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, _id);
+}
+
+uint32_t StorageBuffer::id() const
+{
+	return _id;
+}
@@ -0,0 +1,73 @@
+#include "uniform_buffer.h"
+
+#include <glad/glad.h>
+
+#include "../src/core/utils/console.h"
+
+UniformBuffer::UniformBuffer() : _id(0),
+size(0)
+{
+}
+
+void UniformBuffer::create(uint32_t _size)
+{
+	size = _size;
+
+	// Generate buffer and allocate its memory
+	glGenBuffers(1, &_id);
+	glBindBuffer(GL_UNIFORM_BUFFER, _id);
+	glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformBuffer::destroy()
+{
+	glDeleteBuffers(1, &_id);
+	_id = 0;
+	size = 0;
+}
+
+void UniformBuffer::update(const void* data, uint32_t dataSize, uint32_t offset)
+{
+	// Make sure data fits into buffer
+	if (offset + dataSize > size) {
+		Console::out::warning("Uniform Buffer", "Data of " + std::to_string(dataSize) + " bytes at offset " + std::to_string(offset) + " exceeds buffer size of " + std::to_string(size) + " bytes");
+		return;
+	}
+
+	// Upload data
+	glBindBuffer(GL_UNIFORM_BUFFER, _id);
+	glBufferSubData(GL_UNIFORM_BUFFER, offset, dataSize, data);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformBuffer::bind(uint32_t binding) const
+{
+	glBindBufferBase(GL_UNIFORM_BUFFER, binding, _id);
+}
+
+uint32_t UniformBuffer::id() const
+{
+	return _id;
+}
+
+void UniformBuffer::linkBlocks(uint32_t program)
+{
+	// Shared uniform blocks by name and binding point
+	struct Block {
+		const char* name;
+		uint32_t binding;
+	};
+	static const Block blocks[] = {
+		{ "ViewUniforms", UniformBinding::VIEW },
+		{ "LightUniforms", UniformBinding::LIGHTS },
+		{ "ShadowUniforms", UniformBinding::SHADOWS },
+		{ "CascadeUniforms", UniformBinding::CASCADES }
+	};
+
+	// Link each block the program declares
+	for (const Block& block : blocks) {
+		uint32_t index = glGetUniformBlockIndex(program, block.name);
+		if (index != GL_INVALID_INDEX) glUniformBlockBinding(program, index, block.binding);
+	}
+}
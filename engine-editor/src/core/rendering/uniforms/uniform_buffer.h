@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+// Binding points of uniform blocks shared between shaders
+namespace UniformBinding
+{
+	// Per-view camera data (block "ViewUniforms")
+	constexpr uint32_t VIEW = 0;
+
+	// Per-frame light sources (block "LightUniforms")
+	constexpr uint32_t LIGHTS = 1;
+
+	// Per-frame shadow configuration (block "ShadowUniforms")
+	constexpr uint32_t SHADOWS = 2;
+
+	// Per-view cascaded shadows of the main directional light (block "CascadeUniforms")
+	constexpr uint32_t CASCADES = 3;
+};
+
+class UniformBuffer
+{
+public:
+	UniformBuffer();
+
+	// Creates the uniform buffer with given size in bytes
+	void create(uint32_t size);
+
+	// Destroys the uniform buffer
+	void destroy();
+
+	// Uploads given data to the uniform buffer at given offset
+	void update(const void* data, uint32_t size, uint32_t offset = 0);
+
+	// Binds the uniform buffer to given uniform block binding point
+	void bind(uint32_t binding) const;
+
+	// Returns the uniform buffers backend id
+	uint32_t id() const;
+
+	// Links all shared uniform blocks a shader program declares to their binding points
+	static void linkBlocks(uint32_t program);
+
+private:
+	// Uniform buffer backend id
+	uint32_t _id;
+
+	// Size of uniform buffer in bytes
+	uint32_t size;
+};
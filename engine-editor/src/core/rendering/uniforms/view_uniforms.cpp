@@ -0,0 +1,39 @@
+#include "view_uniforms.h"
+
+ViewUniforms::ViewUniforms() : buffer()
+{
+}
+
+void ViewUniforms::create()
+{
+	buffer.create(sizeof(Data));
+}
+
+void ViewUniforms::destroy()
+{
+	buffer.destroy();
+}
+
+void ViewUniforms::update(const glm::mat4& view, const glm::mat4& projection, const glm::vec2& resolution, float gamma, bool enableSSAO, bool castShadows)
+{
+	// Compute views data
+	Data data;
+	data.view = view;
+	data.projection = projection;
+	data.viewProjection = projection * view;
+	data.viewNormal = glm::mat4(glm::transpose(glm::inverse(glm::mat3(view))));
+	data.cameraPosition = glm::vec3(glm::inverse(view)[3]);
+	data.gamma = gamma;
+	data.resolution = resolution;
+	data.enableSSAO = enableSSAO;
+	data.castShadows = castShadows;
+
+	// Upload and bind data
+	buffer.update(&data, sizeof(Data));
+	bind();
+}
+
+void ViewUniforms::bind() const
+{
+	buffer.bind(UniformBinding::VIEW);
+}
@@ -1,24 +1,70 @@
 #include "resource_loader.h"
 
 #include <chrono>
-
-ResourceLoader::ResourceLoader()
+#include <algorithm>
+
+ResourceLoader::ResourceLoader(uint32_t nWorkers) : running(true),
+mainMtx(),
+mainUploadSlotAvailable(),
+mainTasks(),
+mainCurrent({ nullptr, ResourcePriority::BACKGROUND, 0 }),
+mainBudgetMilliseconds(2.0f),
+mainBudgetBytes(16 * 1024 * 1024),
+mainMillisecondsPerByte(1.0e-6f),
+mainMillisecondsPerChunk(0.1f),
+mainStats(),
+workers(),
+workerMtx(),
+workerTasksAvailable(),
+workerTasks(),
+workerSequence(0),
+workerTasksPending(0),
+workersActive(0),
+workerTarget(nullptr)
 {
-	// Launch worker
-	running = true;
-	worker = std::thread(&ResourceLoader::asyncWorker, this);
+	// Pick amount of workers, leaving the main thread a core
+	if (nWorkers == 0) {
+		uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		nWorkers = std::clamp(hardwareThreads > 1 ? hardwareThreads - 1 : 1u, 1u, MAX_AUTO_WORKERS);
+	}
+
+	// Launch workers
+	workers.reserve(nWorkers);
+	for (uint32_t i = 0; i < nWorkers; i++) {
+		workers.emplace_back(&ResourceLoader::asyncWorker, this);
+	}
 }
 
 ResourceLoader::~ResourceLoader()
 {
-	// Stop worker
-	running = false;
-	worker.join();
+	// Stop workers, waking any sleeping or stalled worker
+	{
+		std::lock_guard<std::mutex> workerLock(workerMtx);
+		std::lock_guard<std::mutex> mainLock(mainMtx);
+		running = false;
+	}
+	workerTasksAvailable.notify_all();
+	mainUploadSlotAvailable.notify_all();
+
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
 }
 
 ResourceLoader::WorkerState ResourceLoader::readWorkerState() const
 {
-	return WorkerState(workerActive, workerTarget, workerTasksPending);
+	return WorkerState(workersActive > 0, workerTarget, workerTasksPending);
+}
+
+ResourceLoader::UploadStats ResourceLoader::readUploadStats() const
+{
+	return mainStats;
+}
+
+void ResourceLoader::setUploadBudget(float milliseconds, size_t bytes)
+{
+	mainBudgetMilliseconds = milliseconds;
+	mainBudgetBytes = bytes;
 }
 
 void ResourceLoader::createSync(Resource* resource)
@@ -33,18 +79,19 @@ void ResourceLoader::createSync(Resource* resource)
 	resource->releaseData();
 }
 
-void ResourceLoader::createAsync(Resource* resource)
+void ResourceLoader::createAsync(Resource* resource, ResourcePriority priority)
 {
-	// Add task to load tasks queue
-	workerTasks.push(resource); // Possible race condition on the worker tasks queue
-
 	// Update resources state
 	resource->state = ResourceState::QUEUED;
 
-	// Update worker state
-	workerTasksPending++;
+	// Add task to load tasks queue
+	{
+		std::lock_guard<std::mutex> lock(workerMtx);
+		workerTasks.push({ resource, priority, workerSequence++ });
+		workerTasksPending++;
+	}
 
-	// Notify worker
+	// Notify a worker
 	workerTasksAvailable.notify_one();
 }
 
@@ -52,74 +99,102 @@ void ResourceLoader::dispatchNext()
 {
 	// [MAIN THREAD]
 
-	// Only dispatch next resource if allowed by worker before
-	if (!mainDispatchNext) return;
+	using Clock = std::chrono::steady_clock;
+	auto start = Clock::now();
+	UploadStats stats;
+
+	while (true) {
+		// Fetch next resource in order of priority if there is no partially dispatched resource
+		if (!mainCurrent.resource) {
+			{
+				std::lock_guard<std::mutex> lock(mainMtx);
+				if (mainTasks.empty()) break;
+				mainCurrent = mainTasks.top();
+				mainTasks.pop();
+			}
+
+			// Upload queue has room again, wake a stalled worker
+			mainUploadSlotAvailable.notify_one();
+		}
+		Resource* resource = mainCurrent.resource;
+
+		// Stop if the next chunk is predicted to exceed the budget
+		size_t chunkSize = resource->getChunkSize();
+		if (stats.chunks > 0) {
+			float predicted = chunkSize > 0 ? chunkSize * mainMillisecondsPerByte : mainMillisecondsPerChunk;
+			if (stats.bytes + chunkSize > mainBudgetBytes || stats.milliseconds + predicted > mainBudgetMilliseconds) break;
+		}
 
-	// Make sure worker thread is locked during dispatch (since main tasks is a shared resource)
-	std::lock_guard<std::mutex> lock(workerMtx);
-	
-	// Dispatch next resource in queue (only one per frame to prevent heavy main thread blocking)
-	if (!mainTasks.empty()) {
-		// Fetch resource to be dispatched
-		Resource* resource = mainTasks.front();
+		// Dispatch chunk and measure its cost
+		auto chunkStart = Clock::now();
+		bool complete = resource->dispatchChunk();
+		float chunkMilliseconds = std::chrono::duration<float, std::milli>(Clock::now() - chunkStart).count();
 
-		// Dispatch resource and release its data
-		resource->dispatchGPU();
-		resource->releaseData();
+		// Update cost estimates
+		if (chunkSize > 0) {
+			mainMillisecondsPerByte += (chunkMilliseconds / chunkSize - mainMillisecondsPerByte) * COST_SMOOTHING;
+		}
+		else {
+			mainMillisecondsPerChunk += (chunkMilliseconds - mainMillisecondsPerChunk) * COST_SMOOTHING;
+		}
 
-		// Update resources state
-		resource->state = ResourceState::READY;
+		stats.milliseconds = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+		stats.bytes += chunkSize;
+		stats.chunks++;
+
+		// Finish fully dispatched resource
+		if (complete) {
+			resource->releaseData();
+			resource->state = ResourceState::READY;
+			workerTasksPending--;
+			stats.completed++;
+			mainCurrent.resource = nullptr;
+		}
 
-		// Pop resource from queue safely
-		popSafe(mainTasks);
+		// Budget spent
+		if (stats.milliseconds >= mainBudgetMilliseconds) break;
 	}
 
-	// Resource dispatched, prevent another dispatch
-	mainDispatchNext = false;
-
-	// Unlock worker mutex and continue worker thread
-	workerAwaitingDispatch.notify_one();
+	mainStats = stats;
 }
 
 void ResourceLoader::asyncWorker()
 {
 	// [WORKER THREAD]
 
-	while (running) {
+	while (true) {
+		// Wait for next task
+		Task task;
+		{
+			std::unique_lock<std::mutex> lock(workerMtx);
+			workerTasksAvailable.wait(lock, [&]() { return !running || !workerTasks.empty(); });
+			if (!running) return;
 
-		std::unique_lock<std::mutex> lock(workerMtx);
-
-		// Condition: Queue with tasks to load must not be empty
-		if (workerTasks.empty()) {
-			workerTasksAvailable.wait(lock, [&]() { return !workerTasks.empty(); });
+			task = workerTasks.top();
+			workerTasks.pop();
 		}
 
-		while (!workerTasks.empty()) {
-			// Fetch resource to be loaded
-			Resource* resource = workerTasks.front();
-
-			// Update resources state
-			resource->state = ResourceState::CREATING;
+		// Sync worker state
+		Resource* resource = task.resource;
+		resource->state = ResourceState::CREATING;
+		workersActive++;
+		workerTarget = resource;
 
-			// Sync worker state
-			workerTasksPending = workerTasks.size();
-			workerActive = true;
-			workerTarget = resource;
+		// Load resource data (concurrently with other workers and the main threads dispatches)
+		resource->loadData();
 
-			// Load resource data
-			resource->loadData();
+		// Sync worker state
+		Resource* expected = resource;
+		workerTarget.compare_exchange_strong(expected, nullptr);
+		workersActive--;
 
-			// Update queues
-			popSafe(workerTasks);
-			mainTasks.push(resource);
+		// Queue resource for dispatch, stalling while the upload queue is full
+		{
+			std::unique_lock<std::mutex> lock(mainMtx);
+			mainUploadSlotAvailable.wait(lock, [&]() { return !running || mainTasks.size() < UPLOAD_QUEUE_CAPACITY; });
+			if (!running) return;
 
-			mainDispatchNext = true;
-			workerAwaitingDispatch.wait(lock, [&]() { return !mainDispatchNext; });
+			mainTasks.push(task);
 		}
-
-		// Sync worker state
-		workerTasksPending = 0;
-		workerActive = false;
-		workerTarget = nullptr;
 	}
-}
\ No newline at end of file
+}
@@ -1,4 +1,4 @@
-#version 330 core
+#version 430 core
 
 #define PI 3.14159265359
 
@@ -8,8 +8,7 @@
 #define EXPONENTIAL_SQUARED_FOG 3
 
 #define MAX_DIRECTIONAL_LIGHTS 1
-#define MAX_POINT_LIGHTS 15
-#define MAX_SPOT_LIGHTS 8
+#define MAX_CASCADES 4
 
 out vec4 FragColor;
 
@@ -18,7 +17,6 @@ in vec2 v_uv;
 in mat3 v_tbn;
 in mat3 v_tbnTransposed;
 in vec3 v_fragmentWorldPosition;
-in vec4 v_fragmentLightSpacePosition;
 
 vec2 viewportUv;
 vec2 uv;
@@ -26,63 +24,108 @@ vec3 normal;
 
 struct Configuration {
     // General parameters
-    float gamma;
     bool solidMode;
-    vec2 viewportResolution;
 
-    // Shadow parameters
+    // Shadow samplers
+    sampler2D shadowAtlas;
+    sampler3D shadowDisk;
+    sampler2DArray cascadedShadowMap;
+
+    // SSAO
+    sampler2D ssaoBuffer;
+};
+uniform Configuration configuration;
+
+layout(std140) uniform ViewUniforms {
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+    mat4 viewProjectionMatrix;
+    mat4 viewNormalMatrix;
+    vec3 cameraPosition;
+    float gamma;
+    vec2 viewportResolution;
+    bool enableSSAO;
     bool castShadows;
-    sampler2D shadowMap;
-    float shadowMapResolutionWidth;
-    float shadowMapResolutionHeight;
+};
 
-    sampler3D shadowDisk;
+layout(std140) uniform ShadowUniforms {
+    vec2 shadowAtlasResolution;
     float shadowDiskWindowSize;
     float shadowDiskFilterSize;
     float shadowDiskRadius;
+};
 
-    // World parameters
-    vec3 cameraPosition;
-
-    // Lighting parameters
-    int numDirectionalLights;
-    int numPointLights;
-    int numSpotLights;
-
-    // SSAO
-    bool enableSSAO;
-    sampler2D ssaoBuffer;
+layout(std140) uniform CascadeUniforms {
+    mat4 cascadeLightSpaces[MAX_CASCADES];
+    vec4 cascadeSplits;
+    vec4 cascadeTexelSizes;
+    int numCascades;
 };
-uniform Configuration configuration;
 
 struct DirectionalLight {
-    float intensity;
     vec3 direction;
+    float intensity;
     vec3 color;
     vec3 position; // boilerplate for directional shadows
 };
-uniform DirectionalLight directionalLights[MAX_DIRECTIONAL_LIGHTS];
 
 struct PointLight {
     vec3 position;
-    vec3 color;
     float intensity;
+    vec3 color;
     float range;
     float falloff;
+    int shadowTile; // first of six cube face tiles, -1 if casting no shadows
 };
-uniform PointLight pointLights[MAX_POINT_LIGHTS];
 
 struct Spotlight {
     vec3 position;
-    vec3 direction;
-    vec3 color;
     float intensity;
+    vec3 direction;
     float range;
+    vec3 color;
     float falloff;
     float innerCos;
     float outerCos;
+    int shadowTile; // -1 if casting no shadows
+};
+
+layout(std140) uniform LightUniforms {
+    DirectionalLight directionalLights[MAX_DIRECTIONAL_LIGHTS];
+    int numDirectionalLights;
+    int numPointLights;
+    int numSpotLights;
+};
+
+layout(std430, binding = 8) readonly buffer PointLights {
+    PointLight pointLights[];
+};
+
+layout(std430, binding = 9) readonly buffer Spotlights {
+    Spotlight spotlights[];
+};
+
+// Froxel grid of the view, each cluster listing the point lights and spotlights reaching it
+layout(std430, binding = 10) readonly buffer LightClusters {
+    uvec4 clusterGrid; // amount of clusters along x, y and z, tile size in pixels
+    vec4 clusterSlicing; // scale and bias mapping the logarithm of view depth to slices
+    uvec4 clusters[]; // offset of light indices, amount of point lights, amount of spotlights
+};
+
+layout(std430, binding = 11) readonly buffer LightIndices {
+    uint lightIndices[];
+};
+
+// Tiles of the shadow atlas, each holding the shadow map of a spotlight or a point lights cube face
+struct ShadowTile {
+    mat4 lightSpace;
+    vec4 rect; // offset and size in atlas uv space
+    float texelScale; // world space texel size per unit of distance to the light
+};
+
+layout(std430, binding = 12) readonly buffer ShadowTiles {
+    ShadowTile shadowTiles[];
 };
-uniform Spotlight spotlights[MAX_SPOT_LIGHTS];
 
 struct Fog {
     int type;
@@ -140,13 +183,6 @@ float sqr(float x)
 // SHADOWING
 //
 
-// get fragment position as shadow coordinates
-vec3 getShadowCoords() {
-    vec3 projectionCoords = v_fragmentLightSpacePosition.xyz / v_fragmentLightSpacePosition.w;
-    vec3 shadowCoords = projectionCoords * 0.5 + vec3(0.5);
-    return shadowCoords;
-}
-
 // get bias for directional light
 float getShadowBias(vec3 lightDirection) {
     // float diffuseFactor = dot(normal, -lightDirection);
@@ -155,63 +191,54 @@ float getShadowBias(vec3 lightDirection) {
     return bias;
 }
 
-// get hard shadow casted by directional light
-float getShadowHard(vec3 lightDirection)
+// get index of the cube face of a point light facing the given direction (+x, -x, +y, -y, +z, -z)
+int getCubeFace(vec3 direction)
 {
-    // make sure shadows are enabled
-    if (!configuration.castShadows) return 0.0;
-
-    // get shadow coordinates
-    vec3 shadowCoords = getShadowCoords();
-
-    // if shadow coordinate's depth is beyond 1.0, fragment isn't in shadow
-    if (shadowCoords.z > 1.0) return 0.0;
-
-    // check if fragment is in shadow
-    float depth = texture(configuration.shadowMap, shadowCoords.xy).r;
-    float bias = getShadowBias(lightDirection);
-    float shadow = shadowCoords.z - bias > depth ? 1.0 : 0.0;
-
-    // return shadow value
-    return shadow;
+    vec3 a = abs(direction);
+    if (a.x >= a.y && a.x >= a.z) return direction.x > 0.0 ? 0 : 1;
+    if (a.y >= a.z) return direction.y > 0.0 ? 2 : 3;
+    return direction.z > 0.0 ? 4 : 5;
 }
 
-// get soft shadow casted by directional light
-float getShadowSoft(vec3 lightDirection)
+// get soft shadow casted by a light from its shadow atlas tile at given distance to the light
+float getShadowSoft(int tileIndex, vec3 lightDirection, float lightDistance)
 {
     // make sure shadows are enabled
-    if (!configuration.castShadows) return 0.0;
+    if (!castShadows) return 0.0;
+
+    ShadowTile tile = shadowTiles[tileIndex];
 
-    // get shadow coordinates
-    vec3 shadowCoords = getShadowCoords();
+    // offset position along the normal by the tiles texel size at the lights distance to prevent self-shadowing artifacts
+    vec3 position = v_fragmentWorldPosition + normalize(v_normal) * tile.texelScale * lightDistance * 1.5;
+    vec4 lightSpacePosition = tile.lightSpace * vec4(position, 1.0);
+    vec3 shadowCoords = lightSpacePosition.xyz / lightSpacePosition.w * 0.5 + vec3(0.5);
 
-    // if shadow coordinate's depth is beyond 1.0, fragment isn't in shadow
+    // if shadow coordinate's depth is beyond 1.0 or outside of the tile, fragment isn't in shadow
     if (shadowCoords.z > 1.0) return 0.0;
+    if (any(lessThan(shadowCoords.xy, vec2(0.0))) || any(greaterThan(shadowCoords.xy, vec2(1.0)))) return 0.0;
+
+    // calculate texel size of the atlas
+    vec2 texelSize = 1.0 / shadowAtlasResolution;
+
+    // map shadow coordinates into the tile, samples are clamped to the tile so they never reach into neighbouring tiles
+    vec2 tileCoords = tile.rect.xy + shadowCoords.xy * tile.rect.zw;
+    vec2 tileMin = tile.rect.xy + texelSize * 0.5;
+    vec2 tileMax = tile.rect.xy + tile.rect.zw - texelSize * 0.5;
 
     // initialize offset for sampling shadow map at different positions
     ivec3 offsetCoord;
 
     // get fractional part of fragment's screen position (for sampling)
-    vec2 f = mod(gl_FragCoord.xy, vec2(configuration.shadowDiskWindowSize));
+    vec2 f = mod(gl_FragCoord.xy, vec2(shadowDiskWindowSize));
 
     // assign fractional part to y and z components of offset
     offsetCoord.yz = ivec2(f);
 
-    // create a vec4 for shadow coordinates with a z of 1.0 for sampling
-    vec4 sc = vec4(shadowCoords, 1.0);
-
     // initialize sum for accumulated shadow result
     float sum = 0.0;
 
     // calculate number of samples to take based on filter size
-    int samplesDiv2 = int(configuration.shadowDiskFilterSize * configuration.shadowDiskFilterSize / 2.0);
-
-    // calculate texel size for shadow map based on its dimensions
-    float texelWidth = 1.0 / configuration.shadowMapResolutionWidth;
-    float texelHeight = 1.0 / configuration.shadowMapResolutionHeight;
-
-    // store texel size in a vec2
-    vec2 texelSize = vec2(texelWidth, texelHeight);
+    int samplesDiv2 = int(shadowDiskFilterSize * shadowDiskFilterSize / 2.0);
 
     // calculate a small bias to prevent self-shadowing artifacts
     float bias = getShadowBias(lightDirection);
@@ -222,18 +249,16 @@ float getShadowSoft(vec3 lightDirection)
         offsetCoord.x = i; // set x offset for this sample
 
         // fetch offsets from shadow disk texture, scaled by shadow radius
-        vec4 Offsets = texelFetch(configuration.shadowDisk, offsetCoord, 0) * configuration.shadowDiskRadius;
+        vec4 Offsets = texelFetch(configuration.shadowDisk, offsetCoord, 0) * shadowDiskRadius;
 
-        // sample shadow map at first offset location
-        sc.xy = shadowCoords.xy + Offsets.rg * texelSize;
-        depth = texture(configuration.shadowMap, sc.xy).x;
+        // sample shadow atlas at first offset location
+        depth = texture(configuration.shadowAtlas, clamp(tileCoords + Offsets.rg * texelSize, tileMin, tileMax)).x;
 
         // compare depth to shadow coordinate z value to determine if in shadow
         shadowCoords.z - bias > depth ? sum += 1.0 : sum += 0.0;
 
-        // sample shadow map at second offset location
-        sc.xy = shadowCoords.xy + Offsets.ba * texelSize;
-        depth = texture(configuration.shadowMap, sc.xy).x;
+        // sample shadow atlas at second offset location
+        depth = texture(configuration.shadowAtlas, clamp(tileCoords + Offsets.ba * texelSize, tileMin, tileMax)).x;
 
         // compare depth again
         shadowCoords.z - bias > depth ? sum += 1.0 : sum += 0.0;
@@ -249,18 +274,16 @@ float getShadowSoft(vec3 lightDirection)
             offsetCoord.x = i;
 
             // fetch more offsets from shadow disk texture
-            vec4 Offsets = texelFetch(configuration.shadowDisk, offsetCoord, 0) * configuration.shadowDiskRadius;
+            vec4 Offsets = texelFetch(configuration.shadowDisk, offsetCoord, 0) * shadowDiskRadius;
 
-            // sample shadow map at first offset location
-            sc.xy = shadowCoords.xy + Offsets.rg * texelSize;
-            depth = texture(configuration.shadowMap, sc.xy).x;
+            // sample shadow atlas at first offset location
+            depth = texture(configuration.shadowAtlas, clamp(tileCoords + Offsets.rg * texelSize, tileMin, tileMax)).x;
 
             // compare depth to shadow coordinate z value
             shadowCoords.z - bias > depth ? sum += 1.0 : sum += 0.0;
 
             // sample at second offset location
-            sc.xy = shadowCoords.xy + Offsets.ba * texelSize;
-            depth = texture(configuration.shadowMap, sc.xy).x;
+            depth = texture(configuration.shadowAtlas, clamp(tileCoords + Offsets.ba * texelSize, tileMin, tileMax)).x;
 
             // compare depth again
             shadowCoords.z - bias > depth ? sum += 1.0 : sum += 0.0;
@@ -274,13 +297,52 @@ float getShadowSoft(vec3 lightDirection)
     return shadow;
 }
 
+// get shadow casted by the main directional light from the first cascade covering the fragment
+float getCascadedShadow()
+{
+    // make sure shadows are enabled
+    if (!castShadows) return 0.0;
+
+    // get view depth of fragment
+    float viewDepth = -(viewMatrix * vec4(v_fragmentWorldPosition, 1.0)).z;
+
+    for (int i = 0; i < numCascades; i++) {
+        // skip cascades ending before the fragment
+        if (viewDepth > cascadeSplits[i]) continue;
+
+        // offset position along the normal by the cascades texel size to prevent self-shadowing artifacts
+        vec3 position = v_fragmentWorldPosition + normalize(v_normal) * cascadeTexelSizes[i] * 1.5;
+        vec3 shadowCoords = (cascadeLightSpaces[i] * vec4(position, 1.0)).xyz * 0.5 + vec3(0.5);
+
+        // cached cascades may lag behind the view, fall back to the next cascade if this one doesn't cover the fragment
+        if (any(lessThan(shadowCoords.xy, vec2(0.0))) || any(greaterThan(shadowCoords.xy, vec2(1.0)))) continue;
+
+        // if shadow coordinate's depth is beyond 1.0, fragment isn't in shadow
+        if (shadowCoords.z > 1.0) return 0.0;
+
+        // average depth comparisons of the surrounding 3x3 texels
+        vec2 texelSize = 1.0 / vec2(textureSize(configuration.cascadedShadowMap, 0).xy);
+        float sum = 0.0;
+        for (int x = -1; x <= 1; x++) {
+            for (int y = -1; y <= 1; y++) {
+                float depth = texture(configuration.cascadedShadowMap, vec3(shadowCoords.xy + vec2(x, y) * texelSize, float(i))).r;
+                sum += shadowCoords.z - 0.0005 > depth ? 1.0 : 0.0;
+            }
+        }
+        return sum / 9.0;
+    }
+
+    // fragment is beyond the shadow distance
+    return 0.0;
+}
+
 //
 // FOG
 //
 
 // get linear fog factor
 float getLinearFog(float start, float end) {
-    float depth = length(v_fragmentWorldPosition - configuration.cameraPosition);
+    float depth = length(v_fragmentWorldPosition - cameraPosition);
     float fogRange = end - start;
     float fogDistance = end - depth;
     float factor = clamp(fogDistance / fogRange, 0.0, 1.0);
@@ -289,14 +351,14 @@ float getLinearFog(float start, float end) {
 
 // get exponential fog factor
 float getExponentialFog(float density) {
-    float depth = length(v_fragmentWorldPosition - configuration.cameraPosition);
+    float depth = length(v_fragmentWorldPosition - cameraPosition);
     float factor = 1 / exp(depth * density);
     return factor;
 }
 
 // get exponential squared fog factor
 float getExponentialSquaredFog(float density) {
-    float depth = length(v_fragmentWorldPosition - configuration.cameraPosition);
+    float depth = length(v_fragmentWorldPosition - cameraPosition);
     float factor = 1 / exp(sqr(depth * density));
     return factor;
 }
@@ -404,7 +466,7 @@ vec3 evaluateLightSource(
 // parallax occlusion mapping of given texture coordinates
 vec2 POM_getUv(vec2 uvInput) {
     // calculate view direction in tangent space
-    vec3 tangentCameraPosition = v_tbnTransposed * configuration.cameraPosition;
+    vec3 tangentCameraPosition = v_tbnTransposed * cameraPosition;
     vec3 tangentFragmentPosition = v_tbnTransposed * v_fragmentWorldPosition;
     vec3 V = normalize(tangentCameraPosition - tangentFragmentPosition);
 
@@ -586,11 +648,12 @@ vec3 getNormal() {
 
     // normal mapping enabled
 
-    // sample normal map
-    vec3 N = texture(material.normalMap, uv).rgb;
+    // sample normal map (only x and y are stored by two channel block compressed normal maps)
+    vec3 N;
+    N.xy = texture(material.normalMap, uv).rg * 2.0 - vec2(1.0);
 
-    // normalize sampled normal
-    N = N * 2.0 - vec3(1.0);
+    // reconstruct z of unit length normal
+    N.z = sqrt(max(1.0 - dot(N.xy, N.xy), 0.0));
 
     // scale normal x and y by normal map intensity
     N.xy *= material.normalMapIntensity;
@@ -611,7 +674,7 @@ vec3 getAlbedo()
     // sample albedo map if enabled
     if (material.enableAlbedoMap) {
         vec3 albedoSample = texture(material.albedoMap, uv).rgb;
-        albedo = pow(albedoSample, vec3(configuration.gamma));
+        albedo = pow(albedoSample, vec3(gamma));
     }
 
     // tint albedo by materials base color
@@ -678,7 +741,7 @@ float getSSAO() {
     float ssao = 1.0;
 
     // ssao enabled, sample by ssao buffer
-    if (configuration.enableSSAO) {
+    if (enableSSAO) {
         ssao = texture(configuration.ssaoBuffer, viewportUv).r;
     }
 
@@ -705,6 +768,18 @@ vec3 getEmission() {
     return emission;
 }
 
+//
+// LIGHT CLUSTERS
+//
+
+// get cluster of fragment
+uvec4 getCluster() {
+    float viewDepth = -(viewMatrix * vec4(v_fragmentWorldPosition, 1.0)).z;
+    uvec2 tile = min(uvec2(gl_FragCoord.xy) / clusterGrid.w, clusterGrid.xy - 1u);
+    uint slice = uint(clamp(log(max(viewDepth, 1e-4)) * clusterSlicing.x + clusterSlicing.y, 0.0, float(clusterGrid.z - 1u)));
+    return clusters[(slice * clusterGrid.y + tile.y) * clusterGrid.x + tile.x];
+}
+
 //
 // ATTENUATION CALCULATION
 //
@@ -759,7 +834,7 @@ vec4 shadePBR() {
     float ssao = getSSAO();
 
     vec3 N = normal;
-    vec3 V = normalize(configuration.cameraPosition - v_fragmentWorldPosition); // view direction
+    vec3 V = normalize(cameraPosition - v_fragmentWorldPosition); // view direction
 
     float dialectricReflecitivity = 0.04;
     vec3 F0 = mix(vec3(dialectricReflecitivity), albedo, metallic); // base reflectivity
@@ -778,11 +853,14 @@ vec4 shadePBR() {
     // fragment doesnt have emission and therefore reflects light from light sources
     else {
 
+        // get point lights and spotlights reaching fragment
+        uvec4 cluster = getCluster();
+
         //
         // DIRECTIONAL LIGHTS
         //
 
-        for (int i = 0; i < configuration.numDirectionalLights; i++)
+        for (int i = 0; i < numDirectionalLights; i++)
         {
             DirectionalLight directionalLight = directionalLights[i];
 
@@ -790,7 +868,7 @@ vec4 shadePBR() {
             vec3 L = normalize(-directionalLight.direction);
 
             float shadow = 0.0;
-            //shadow += getShadowSoft(L);
+            if (i == 0) shadow += getCascadedShadow();
            
             // PARALLAX OCCLUSION MAPPED SHADOW FOR DIRECTIONAL LIGHT //
             /*if (material.enableHeightMap && i == 0) {
@@ -816,14 +894,15 @@ vec4 shadePBR() {
         // POINT LIGHTS
         //
 
-        for (int i = 0; i < configuration.numPointLights; i++) {
-            PointLight pointLight = pointLights[i];
+        for (uint i = 0u; i < cluster.y; i++) {
+            PointLight pointLight = pointLights[lightIndices[cluster.x + i]];
 
             float distance = length(pointLight.position - v_fragmentWorldPosition);
             float attenuation = getAttenuation_range_falloff_cusp(distance, pointLight.range, pointLight.falloff);
             vec3 L = normalize(pointLight.position - v_fragmentWorldPosition);
 
             float shadow = 0.0;
+            if (pointLight.shadowTile >= 0) shadow += getShadowSoft(pointLight.shadowTile + getCubeFace(-L), L, distance);
             
             // PARALLAX OCCLUSION MAPPED SHADOW FOR POINT LIGHT //
             /*if (material.enableHeightMap && i == 0) {
@@ -848,8 +927,8 @@ vec4 shadePBR() {
         // SPOT LIGHTS
         //
 
-        for (int i = 0; i < configuration.numSpotLights; i++) {
-            Spotlight spotlight = spotlights[i];
+        for (uint i = 0u; i < cluster.z; i++) {
+            Spotlight spotlight = spotlights[lightIndices[cluster.x + cluster.y + i]];
 
             float distance = length(spotlight.position - v_fragmentWorldPosition);
             float attenuation = getAttenuation_range_falloff_cusp(distance, spotlight.range, spotlight.falloff);
@@ -860,7 +939,7 @@ vec4 shadePBR() {
             float intensityScaling = clamp((theta - spotlight.outerCos) / epsilon, 0.0, 1.0);
 
             float shadow = 0.0;
-            shadow += getShadowSoft(L);
+            if (spotlight.shadowTile >= 0) shadow += getShadowSoft(spotlight.shadowTile, L, distance);
            
             // PARALLAX OCCLUSION MAPPED SHADOW FOR SPOT LIGHT //
             /*if (material.enableHeightMap && i == 0) {
@@ -890,7 +969,7 @@ vec4 shadePBR() {
 
     // gamma correct if using albedo map
     if (material.enableAlbedoMap) {
-        color = pow(color, vec3(1.0 / configuration.gamma));
+        color = pow(color, vec3(1.0 / gamma));
     }
 
     // get fog
@@ -920,15 +999,14 @@ vec4 shadeSolid()
     // static directional light
     vec3 direction = vec3(-0.5, -0.5, 1.0);
 
-    for (int i = 0; i < configuration.numDirectionalLights; i++)
+    for (int i = 0; i < numDirectionalLights; i++)
     {
         DirectionalLight directionalLight = directionalLights[i];
 
         float attenuation = 1.0;
         vec3 L = normalize(-directionalLight.direction);
 
-        vec3 shadowDirection = normalize(directionalLight.position - v_fragmentWorldPosition);
-        float shadow = getShadowHard(L);
+        float shadow = i == 0 ? getCascadedShadow() : 0.0;
 
         diffuse += max(dot(N, L), 0.0) * directionalLight.color * directionalLight.intensity * attenuation * (1.0 - shadow);
     }
@@ -964,7 +1042,7 @@ vec4 shadeNormal() {
     diffuse = vec3(max(dot(normal, L), 0.0));
     diffuse = mix(diffuse, vec3(0.0), diffuseFactor);
 
-    shadow = getShadowSoft(L) * shadowIntensity;
+    shadow = getCascadedShadow() * shadowIntensity;
 
     // get color from normal and shadow
     vec3 color = colorNormal * diffuse * (1.0 - shadow);
@@ -985,9 +1063,7 @@ vec4 shadeDepth() {
     return vec4(vec3(depth), 1.0);
 }
 vec4 shadeShadowMap() {
-    vec3 projectionCoordinates = v_fragmentLightSpacePosition.xyz / v_fragmentLightSpacePosition.w;
-    projectionCoordinates = projectionCoordinates * 0.5 + 0.5;
-    float depth = texture(configuration.shadowMap, projectionCoordinates.xy).r;
+    float depth = texture(configuration.shadowAtlas, viewportUv).r;
     return vec4(vec3(depth), 1.0);
 }
 vec4 shadeUv(){
@@ -1009,7 +1085,7 @@ vec4 shadeTangentSpace() {
 
 void main()
 {
-    viewportUv = gl_FragCoord.xy / vec2(configuration.viewportResolution.x, configuration.viewportResolution.y);
+    viewportUv = gl_FragCoord.xy / vec2(viewportResolution.x, viewportResolution.y);
     uv = getUv();
     normal = getNormal();
 
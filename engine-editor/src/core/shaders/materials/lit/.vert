@@ -1,30 +1,50 @@
 #version 330 core
 
-layout(location = 0) in vec3 position_in;
-layout(location = 1) in vec3 normal_in;
+layout(location = 0) in vec3 position_in; // quantized within mesh bounds, dequantized by model matrix
+layout(location = 1) in vec2 normal_in; // octahedral encoded
 layout(location = 2) in vec2 uv_in;
-layout(location = 3) in vec3 tangent_in;
-layout(location = 4) in vec3 bitangent_in;
+layout(location = 3) in vec2 tangent_in; // octahedral encoded
+layout(location = 4) in float bitangentSign_in;
 
-uniform mat4 mvpMatrix;
-uniform mat4 modelMatrix;
-uniform mat3 normalMatrix;
-uniform mat4 lightSpaceMatrix;
+layout(location = 5) in mat4 modelMatrix;
+layout(location = 9) in mat3 normalMatrix;
+
+layout(std140) uniform ViewUniforms {
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+    mat4 viewProjectionMatrix;
+    mat4 viewNormalMatrix;
+    vec3 cameraPosition;
+    float gamma;
+    vec2 viewportResolution;
+    bool enableSSAO;
+    bool castShadows;
+};
 
 out vec3 v_normal;
 out vec2 v_uv;
 out mat3 v_tbn;
 out mat3 v_tbnTransposed;
 out vec3 v_fragmentWorldPosition;
-out vec4 v_fragmentLightSpacePosition;
+
+vec3 octDecode(vec2 encoded) {
+    vec3 v = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = max(-v.z, 0.0);
+    v.x += v.x >= 0.0 ? -t : t;
+    v.y += v.y >= 0.0 ? -t : t;
+    return normalize(v);
+}
 
 vec3 getNormal() {
-    return normalize(normalMatrix * normal_in);
+    return normalize(normalMatrix * octDecode(normal_in));
 }
 
 mat3 getTBNMatrix() {
-    vec3 t = normalize(normalMatrix * tangent_in);
-    vec3 b = normalize(normalMatrix * bitangent_in);
+    vec3 objectNormal = octDecode(normal_in);
+    vec3 objectTangent = octDecode(tangent_in);
+    vec3 objectBitangent = cross(objectNormal, objectTangent) * (bitangentSign_in < 0.0 ? -1.0 : 1.0);
+    vec3 t = normalize(normalMatrix * objectTangent);
+    vec3 b = normalize(normalMatrix * objectBitangent);
     vec3 n = v_normal;
     return mat3(t, b, n);
 }
@@ -33,10 +53,6 @@ vec3 getFragmentWorldPosition() {
     return vec3(modelMatrix * vec4(position_in, 1.0));
 }
 
-vec4 getFragmentLightSpacePosition() {
-    return lightSpaceMatrix * vec4(v_fragmentWorldPosition, 1.0);
-}
-
 void main()
 {
     v_normal = getNormal();
@@ -44,7 +60,6 @@ void main()
     v_tbn = getTBNMatrix();
     v_tbnTransposed = transpose(v_tbn);
     v_fragmentWorldPosition = getFragmentWorldPosition();
-    v_fragmentLightSpacePosition = getFragmentLightSpacePosition();
 
-    gl_Position = mvpMatrix * vec4(position_in, 1.0);
+    gl_Position = viewProjectionMatrix * vec4(v_fragmentWorldPosition, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,29 @@
+#version 330 core
+
+out vec4 FragColor;
+
+// Finer level (base level clamped to the finer level, so it's fetched at level 0)
+uniform sampler2D depthInput;
+
+void main()
+{
+    ivec2 inputSize = textureSize(depthInput, 0);
+    ivec2 outputSize = max(inputSize / 2, ivec2(1));
+    ivec2 coord = ivec2(gl_FragCoord.xy);
+
+    // Texels of the finer level covered, the last texels also cover the remainders of odd sized finer levels
+    ivec2 first = coord * 2;
+    ivec2 last = min(first + 1, inputSize - 1);
+    if (coord.x == outputSize.x - 1) last.x = inputSize.x - 1;
+    if (coord.y == outputSize.y - 1) last.y = inputSize.y - 1;
+
+    // Keep the farthest depth
+    float depth = 0.0;
+    for (int y = first.y; y <= last.y; y++) {
+        for (int x = first.x; x <= last.x; x++) {
+            depth = max(depth, texelFetch(depthInput, ivec2(x, y), 0).r);
+        }
+    }
+
+    FragColor = vec4(depth, 0.0, 0.0, 1.0);
+}
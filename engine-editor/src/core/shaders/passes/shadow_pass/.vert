@@ -1,9 +1,10 @@
 #version 330 core
 
-layout(location = 0) in vec3 position_in;
+layout(location = 0) in vec3 position_in; // quantized within mesh bounds, dequantized by model matrix
+
+layout(location = 5) in mat4 modelMatrix;
 
 uniform mat4 lightSpaceMatrix;
-uniform mat4 modelMatrix;
 
 void main()
 {
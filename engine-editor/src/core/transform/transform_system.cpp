@@ -0,0 +1,252 @@
+#include "transform_system.h"
+
+#include <atomic>
+#include <algorithm>
+#include <unordered_map>
+#include <gtc/quaternion.hpp>
+
+#include "../src/core/ecs/ecs.h"
+#include "../src/core/utils/console.h"
+#include "../src/core/jobs/job_system.h"
+#include "../src/core/rendering/transformation/transformation.h"
+
+namespace TransformSystem {
+
+	constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+	// Amount of nodes evaluated per job
+	constexpr uint32_t EVALUATION_BATCH_SIZE = 512;
+
+	// Hierarchy node of a transform
+	struct Node
+	{
+		// Transform component of node
+		TransformComponent* transform;
+
+		// Index of parent node or NO_PARENT
+		uint32_t parent;
+
+		// Parent and local transformation the world matrix was last evaluated with
+		const TransformComponent* cachedParent;
+		glm::vec3 cachedPosition;
+		glm::quat cachedRotation;
+		glm::vec3 cachedScale;
+
+		// Set if node needs to be evaluated regardless of its cached state
+		bool forceEvaluation;
+	};
+
+	// Nodes of all transforms sorted by hierarchy depth, parents always preceding their children
+	std::vector<Node> gNodes;
+
+	// World and normal matrices of all nodes, indexed like the nodes
+	std::vector<glm::mat4> gWorldMatrices;
+	std::vector<glm::mat4> gNormalMatrices;
+
+	// Dirty flags of the latest update, indexed like the nodes
+	std::vector<uint8_t> gDirty;
+
+	// Index of the first node of each hierarchy depth, followed by the total node count
+	std::vector<uint32_t> gLevelOffsets;
+
+	// Set if transforms were added or removed since the last rebuild of the nodes
+	bool gHierarchyOutdated = true;
+
+	// Amount of transforms evaluated during the latest update
+	std::atomic<uint32_t> gEvaluatedCount = 0;
+
+	// Marks the hierarchy as outdated
+	void _invalidateHierarchy(Registry& /*registry*/, Entity /*entity*/)
+	{
+		gHierarchyOutdated = true;
+	}
+
+	// Rebuilds the depth sorted nodes from all transforms of the global registry
+	void _rebuildHierarchy()
+	{
+		// Gather transforms
+		std::vector<TransformComponent*> transforms;
+		std::unordered_map<const TransformComponent*, uint32_t> indices;
+		auto view = ECS::gRegistry.view<TransformComponent>();
+		for (auto [entity, transform] : view.each()) {
+			indices[&transform] = static_cast<uint32_t>(transforms.size());
+			transforms.push_back(&transform);
+		}
+
+		// Resolve hierarchy depth of each transform
+		std::vector<uint32_t> depths(transforms.size(), 0);
+		for (size_t i = 0; i < transforms.size(); i++) {
+			uint32_t depth = 0;
+			const TransformComponent* parent = transforms[i]->parent;
+			while (parent && indices.find(parent) != indices.end() && depth <= transforms.size()) {
+				depth++;
+				parent = parent->parent;
+			}
+
+			// Break cyclic parent chains
+			if (depth > transforms.size()) {
+				Console::out::warning("Transform System", "Cyclic parent chain of transform '" + transforms[i]->name + "', detaching it from its parent");
+				transforms[i]->parent = nullptr;
+				depth = 0;
+			}
+
+			depths[i] = depth;
+		}
+
+		// Sort transforms by depth
+		std::vector<uint32_t> order(transforms.size());
+		for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) { return depths[lhs] < depths[rhs]; });
+
+		// Map original transform indices to sorted node indices
+		std::vector<uint32_t> nodeIndices(transforms.size());
+		for (uint32_t i = 0; i < order.size(); i++) nodeIndices[order[i]] = i;
+
+		// Remember previous nodes to carry over the state of unchanged transforms
+		std::unordered_map<const TransformComponent*, uint32_t> previousIndices;
+		for (uint32_t i = 0; i < gNodes.size(); i++) previousIndices[gNodes[i].transform] = i;
+
+		std::vector<Node> nodes;
+		std::vector<glm::mat4> worldMatrices(order.size(), glm::mat4(1.0f));
+		std::vector<glm::mat4> normalMatrices(order.size(), glm::mat4(1.0f));
+
+		// Create nodes
+		nodes.reserve(order.size());
+		for (uint32_t index : order) {
+			TransformComponent* transform = transforms[index];
+
+			// Resolve parent node, parents outside of the registry are treated as roots
+			uint32_t parent = NO_PARENT;
+			if (transform->parent) {
+				auto it = indices.find(transform->parent);
+				if (it != indices.end()) parent = nodeIndices[it->second];
+			}
+
+			Node node;
+			node.transform = transform;
+			node.parent = parent;
+			node.cachedParent = transform->parent;
+			node.cachedPosition = transform->position;
+			node.cachedRotation = transform->rotation;
+			node.cachedScale = transform->scale;
+			node.forceEvaluation = true;
+
+			// Carry over evaluated state if transform existed with the same parent before
+			auto previous = previousIndices.find(transform);
+			if (previous != previousIndices.end() && gNodes[previous->second].cachedParent == transform->parent) {
+				const Node& previousNode = gNodes[previous->second];
+				node.cachedPosition = previousNode.cachedPosition;
+				node.cachedRotation = previousNode.cachedRotation;
+				node.cachedScale = previousNode.cachedScale;
+				node.forceEvaluation = previousNode.forceEvaluation;
+				worldMatrices[nodes.size()] = gWorldMatrices[previous->second];
+				normalMatrices[nodes.size()] = gNormalMatrices[previous->second];
+			}
+
+			nodes.push_back(node);
+		}
+
+		// Find first node of each depth level
+		gLevelOffsets.clear();
+		for (uint32_t i = 0; i < order.size(); i++) {
+			if (i == 0 || depths[order[i]] != depths[order[i - 1]]) gLevelOffsets.push_back(i);
+		}
+		gLevelOffsets.push_back(static_cast<uint32_t>(order.size()));
+
+		// Replace nodes and matrices
+		gNodes = std::move(nodes);
+		gWorldMatrices = std::move(worldMatrices);
+		gNormalMatrices = std::move(normalMatrices);
+		gDirty.assign(gNodes.size(), 0);
+
+		gHierarchyOutdated = false;
+	}
+
+	// Evaluates the node at the given index if it or its parent chain changed, returns true if it was evaluated
+	bool _evaluateNode(uint32_t i)
+	{
+		Node& node = gNodes[i];
+		TransformComponent& transform = *node.transform;
+
+		// Check if local transformation changed
+		bool localChanged = node.forceEvaluation ||
+			transform.position != node.cachedPosition ||
+			transform.rotation != node.cachedRotation ||
+			transform.scale != node.cachedScale;
+
+		// Check if parent chain changed
+		bool parentChanged = node.parent != NO_PARENT && gDirty[node.parent];
+
+		// Skip clean nodes
+		gDirty[i] = localChanged || parentChanged;
+		if (!gDirty[i]) return false;
+
+		// Compute world matrix
+		glm::mat4 local = Transformation::model(transform.position, transform.rotation, transform.scale);
+		gWorldMatrices[i] = node.parent != NO_PARENT ? gWorldMatrices[node.parent] * local : local;
+
+		// Compute normal matrix
+		gNormalMatrices[i] = Transformation::normal(gWorldMatrices[i]);
+
+		// Write results back to transform
+		transform.model = gWorldMatrices[i];
+		transform.normal = gNormalMatrices[i];
+
+		// Cache evaluated state
+		node.cachedPosition = transform.position;
+		node.cachedRotation = transform.rotation;
+		node.cachedScale = transform.scale;
+		node.forceEvaluation = false;
+
+		return true;
+	}
+
+	void setup()
+	{
+		ECS::gRegistry.on_construct<TransformComponent>().connect<&_invalidateHierarchy>();
+		ECS::gRegistry.on_destroy<TransformComponent>().connect<&_invalidateHierarchy>();
+	}
+
+	void update()
+	{
+		// Make sure no parent has been reassigned since the last rebuild
+		if (!gHierarchyOutdated) {
+			for (const Node& node : gNodes) {
+				if (node.transform->parent != node.cachedParent) {
+					gHierarchyOutdated = true;
+					break;
+				}
+			}
+		}
+
+		// Rebuild hierarchy if needed
+		if (gHierarchyOutdated) _rebuildHierarchy();
+
+		gEvaluatedCount = 0;
+
+		// Evaluate level by level so parents are always up to date before their children, nodes within a level are independent
+		for (size_t level = 0; level + 1 < gLevelOffsets.size(); level++) {
+			uint32_t levelBegin = gLevelOffsets[level];
+			uint32_t levelSize = gLevelOffsets[level + 1] - levelBegin;
+
+			JobSystem::parallelFor(levelSize, EVALUATION_BATCH_SIZE, [levelBegin](uint32_t begin, uint32_t end) {
+				uint32_t evaluated = 0;
+				for (uint32_t i = levelBegin + begin; i < levelBegin + end; i++) {
+					if (_evaluateNode(i)) evaluated++;
+				}
+				gEvaluatedCount += evaluated;
+			});
+		}
+	}
+
+	const std::vector<glm::mat4>& getWorldMatrices()
+	{
+		return gWorldMatrices;
+	}
+
+	uint32_t getEvaluatedCount()
+	{
+		return gEvaluatedCount;
+	}
+
+}
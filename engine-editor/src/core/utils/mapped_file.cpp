@@ -0,0 +1,111 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+MappedFile::MappedFile() : data(nullptr),
+size(0),
+file(nullptr),
+mapping(nullptr)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const std::string& path)
+{
+	close();
+
+#ifdef _WIN32
+	// Open file
+	HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE) return false;
+	file = fileHandle;
+
+	// Empty files can't be mapped
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+		close();
+		return false;
+	}
+
+	// Map file
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mappingHandle) {
+		close();
+		return false;
+	}
+	mapping = mappingHandle;
+
+	data = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (!data) {
+		close();
+		return false;
+	}
+	size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	// Open file
+	int descriptor = ::open(path.c_str(), O_RDONLY);
+	if (descriptor < 0) return false;
+
+	// Empty files can't be mapped
+	struct stat fileStat;
+	if (fstat(descriptor, &fileStat) != 0 || fileStat.st_size == 0) {
+		::close(descriptor);
+		return false;
+	}
+
+	// Map file (the mapping stays valid after closing the descriptor)
+	void* view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+	::close(descriptor);
+	if (view == MAP_FAILED) return false;
+
+	data = static_cast<const uint8_t*>(view);
+	size = static_cast<size_t>(fileStat.st_size);
+	mapping = view;
+#endif
+
+	return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if (data) UnmapViewOfFile(data);
+	if (mapping) CloseHandle(mapping);
+	if (file) CloseHandle(file);
+#else
+	if (mapping) munmap(mapping, size);
+#endif
+
+	data = nullptr;
+	size = 0;
+	file = nullptr;
+	mapping = nullptr;
+}
+
+bool MappedFile::isOpen() const
+{
+	return data != nullptr;
+}
+
+const uint8_t* MappedFile::getData() const
+{
+	return data;
+}
+
+size_t MappedFile::getSize() const
+{
+	return size;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+// Read only memory mapping of a whole file
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Maps the file at the given path, closing any previous mapping, returns if the file could be mapped
+	bool open(const std::string& path);
+
+	// Unmaps the file
+	void close();
+
+	// Returns if a file is mapped
+	bool isOpen() const;
+
+	// Returns the first byte of the mapped file
+	const uint8_t* getData() const;
+
+	// Returns the size of the mapped file in bytes
+	size_t getSize() const;
+
+private:
+	const uint8_t* data;
+	size_t size;
+
+	// Native file and mapping handles
+	void* file;
+	void* mapping;
+};
@@ -44,6 +44,7 @@ void _physics_example() {
 
 	// Directional light (sun)
 	EntityContainer sun("Sun", ECS::createEntity());
+	sun.transform.rotation = glm::quat(glm::vec3(0.0f, 0.0f, 1.0f), glm::normalize(glm::vec3(-0.7f, -0.8f, 1.0f)));
 	DirectionalLightComponent& sunLight = sun.add<DirectionalLightComponent>();
 	sunLight.intensity = 0.3f;
 	sunLight.color = glm::vec3(1.0, 1.0, 1.0f);
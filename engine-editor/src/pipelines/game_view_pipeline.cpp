@@ -8,7 +8,8 @@
 #include "../src/core/rendering/culling/bounding_volume.h"
 #include "../src/core/rendering/skybox/skybox.h"
 #include "../src/core/ecs/ecs_collection.h"
-#include "../src/core/rendering/shadows/shadow_map.h"
+#include "../src/core/rendering/shadows/shadow_atlas.h"
+#include "../src/core/rendering/texture/texture_streaming.h"
 
 #include "../src/ui/windows/viewport_window.h"
 #include "../src/runtime/runtime.h"
@@ -21,13 +22,20 @@ msaaSamples(4),
 profile(),
 skybox(nullptr),
 gizmos(nullptr),
+viewUniforms(),
+lightClusters(),
+cascadedShadowMap(2048, 4, 200.0f),
+cascadeUniforms(),
 preprocessorPass(),
 prePass(viewport),
+hizPass(viewport),
+cullingPass(),
 forwardPass(viewport),
 ssaoPass(viewport),
 velocityBuffer(viewport),
 postProcessingPipeline(viewport, false),
 cameraAvailable(false),
+gpuCulling(false),
 ssaoOutput(0),
 velocityOutput(0)
 {
@@ -35,12 +43,24 @@ velocityOutput(0)
 
 void GameViewPipeline::create()
 {
+	// Create view uniforms, light clusters and cascades
+	viewUniforms.create();
+	lightClusters.create();
+	cascadedShadowMap.create();
+	cascadeUniforms.create();
+
 	// Create passes
 	createPasses();
 }
 
 void GameViewPipeline::destroy()
 {
+	// Destroy view uniforms, light clusters and cascades
+	viewUniforms.destroy();
+	lightClusters.destroy();
+	cascadedShadowMap.destroy();
+	cascadeUniforms.destroy();
+
 	// Destroy passes
 	destroyPasses();
 }
@@ -63,26 +83,53 @@ void GameViewPipeline::render()
 	glm::mat4 view = Transformation::view(cameraTransform.position, cameraTransform.rotation);
 	glm::mat4 projection = Transformation::projection(cameraHandle.fov, viewport.getAspect(), cameraHandle.near, cameraHandle.far);
 	glm::mat4 viewProjection = projection * view;
-	glm::mat3 viewNormal = glm::transpose(glm::inverse(glm::mat3(view)));
+
+	// Upload view data for all upcoming draws
+	viewUniforms.update(view, projection, viewport.getResolution(), profile.color.gamma, profile.ambientOcclusion.enabled, true);
+
+	// Assign lights to the clusters of the view
+	Profiler::start("light_clusters");
+	lightClusters.update(Runtime::getLightUniforms(), view, projection, viewport.getResolution());
+	Profiler::stop("light_clusters");
+
+	//
+	// CASCADED SHADOW PASS
+	// Render the cascades of the main directional light fit to the cameras view
+	//
+	Profiler::start("cascaded_shadow_pass");
+	cascadedShadowMap.castShadows(Runtime::getShadowCasters(), view, projection);
+	cascadeUniforms.update(cascadedShadowMap);
+	Profiler::stop("cascaded_shadow_pass");
 
 	//
 	// PREPROCESSOR PASS
-	// Evaluate and update transforms, perform culling etc.
+	// Perform culling against the view frustum and previous depth and sort visible entities
 	// 
 	Profiler::start("preprocessor_pass");
-	preprocessorPass.perform(viewProjection);
+	preprocessorPass.perform(viewProjection, hizPass.readOccluders());
 	Profiler::stop("preprocessor_pass");
 
+	// Request texture levels needed for visible entities
+	TextureStreaming::requestVisible(preprocessorPass.getVisibleQueue(), cameraTransform.position, projection, viewport.getHeight());
+
 	//
 	// PRE PASS
 	// Create geometry pass with depth buffer before forward pass
 	//
 	Profiler::start("pre_pass");
-	prePass.render(viewProjection, viewNormal);
+	prePass.render(preprocessorPass.getVisibleQueue());
 	Profiler::stop("pre_pass");
 	const uint32_t PRE_PASS_DEPTH_OUTPUT = prePass.getDepthOutput();
 	const uint32_t PRE_PASS_NORMAL_OUTPUT = prePass.getNormalOutput();
 
+	//
+	// HI-Z PASS
+	// Build depth pyramid from pre pass depth for occlusion culling of the upcoming frames
+	//
+	Profiler::start("hiz_pass");
+	hizPass.render(PRE_PASS_DEPTH_OUTPUT, viewProjection);
+	Profiler::stop("hiz_pass");
+
 	//
 	// SCREEN SPACE AMBIENT OCCLUSION PASS
 	// Calculate screen space ambient occlusion if enabled
@@ -105,30 +152,38 @@ void GameViewPipeline::render()
 	velocityOutput = 0;
 
 	if (velocityBufferNeeded) {
-		velocityOutput = velocityBuffer.render(view, projection, profile);
+		velocityOutput = velocityBuffer.render(profile, preprocessorPass.getVisibleQueue());
 	}
 
 	const uint32_t VELOCITY_BUFFER_OUTPUT = velocityOutput;
 	Profiler::stop("velocity_buffer");
 
+	//
+	// CULLING PASS
+	// Cull forward pass instances against the view frustum and the current depth pyramid on the gpu and generate their draws
+	// Performed right before the forward pass, as it writes the shared instance buffer
+	//
+	if (gpuCulling) {
+		Profiler::start("culling_pass");
+		cullingPass.perform(preprocessorPass.getVisibleQueue(), viewProjection, hizPass.getOutput());
+		Profiler::stop("culling_pass");
+	}
+
 	//
 	// FORWARD PASS: Perform rendering for every object with materials, lighting etc.
 	//
 
 	// Prepare lit material with current render data
-	LitMaterial::viewport = &viewport; // Redundant most of the times atm
-	LitMaterial::cameraTransform = &cameraTransform; // Redundant most of the times atm
 	LitMaterial::ssaoInput = SSAO_OUTPUT;
-	LitMaterial::profile = &profile;
-	LitMaterial::castShadows = true;
 	LitMaterial::mainShadowDisk = Runtime::getMainShadowDisk();
-	LitMaterial::mainShadowMap = Runtime::getMainShadowMap();
+	LitMaterial::mainShadowAtlas = &Runtime::getShadowAtlas();
+	LitMaterial::mainCascadedShadowMap = &cascadedShadowMap;
 
 	Profiler::start("forward_pass");
 	forwardPass.drawSkybox = drawSkybox;
 	forwardPass.drawGizmos = drawGizmos && gizmos;
 	if (forwardPass.drawGizmos) forwardPass.linkGizmos(gizmos);
-	uint32_t FORWARD_PASS_OUTPUT = forwardPass.render(view, projection, viewProjection);
+	uint32_t FORWARD_PASS_OUTPUT = forwardPass.render(view, projection, viewProjection, preprocessorPass.getVisibleQueue());
 	Profiler::stop("forward_pass");
 
 	//
@@ -212,7 +267,14 @@ uint32_t GameViewPipeline::getVelocityOutput() const
 void GameViewPipeline::createPasses()
 {
 	prePass.create();
+	hizPass.create();
 	forwardPass.create(msaaSamples);
+
+	// Draw forward pass instances culled on the gpu if supported
+	gpuCulling = CullingPass::supported();
+	if (gpuCulling) cullingPass.create();
+	forwardPass.linkCulling(gpuCulling ? &cullingPass : nullptr);
+
 	ssaoPass.create();
 	velocityBuffer.create();
 	postProcessingPipeline.create();
@@ -221,6 +283,8 @@ void GameViewPipeline::createPasses()
 void GameViewPipeline::destroyPasses()
 {
 	prePass.destroy();
+	hizPass.destroy();
+	if (gpuCulling) cullingPass.destroy();
 	forwardPass.destroy();
 	ssaoPass.destroy();
 	velocityBuffer.destroy();
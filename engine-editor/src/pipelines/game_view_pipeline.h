@@ -6,8 +6,14 @@
 #include "../src/core/rendering/gizmos/gizmos.h"
 #include "../src/core/rendering/passes/ssao_pass.h"
 #include "../src/core/rendering/passes/pre_pass.h"
+#include "../src/core/rendering/passes/hiz_pass.h"
 #include "../src/core/rendering/passes/forward_pass.h"
+#include "../src/core/rendering/passes/culling_pass.h"
 #include "../src/core/rendering/passes/preprocessor_pass.h"
+#include "../src/core/rendering/uniforms/view_uniforms.h"
+#include "../src/core/rendering/culling/light_clusters.h"
+#include "../src/core/rendering/uniforms/cascade_uniforms.h"
+#include "../src/core/rendering/shadows/cascaded_shadow_map.h"
 #include "../src/core/rendering/velocitybuffer/velocity_buffer.h"
 #include "../src/core/rendering/postprocessing/post_processing.h"
 #include "../src/core/rendering/postprocessing/post_processing_pipeline.h"
@@ -82,6 +88,10 @@ private:
 	PostProcessing::Profile profile;
 	Skybox* skybox; // Optional skybox
 	IMGizmo* gizmos; // Optional gizmos
+	ViewUniforms viewUniforms; // Cameras per-view uniform data
+	LightClusters lightClusters; // Lights reaching each cluster of the cameras view
+	CascadedShadowMap cascadedShadowMap; // Directional light shadows fit to the cameras view
+	CascadeUniforms cascadeUniforms; // Cascades per-view uniform data
 
 	//
 	// Render settings
@@ -95,6 +105,8 @@ private:
 
 	PreprocessorPass preprocessorPass;
 	PrePass prePass;
+	HiZPass hizPass;
+	CullingPass cullingPass;
 	ForwardPass forwardPass;
 	SSAOPass ssaoPass;
 	VelocityBuffer velocityBuffer;
@@ -105,6 +117,7 @@ private:
 	//
 
 	bool cameraAvailable;
+	bool gpuCulling; // If forward pass instances are culled on the gpu
 
 	uint32_t ssaoOutput;
 	uint32_t velocityOutput;
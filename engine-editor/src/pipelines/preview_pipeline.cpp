@@ -7,10 +7,14 @@
 #include "../src/core/rendering/shader/shader.h"
 #include "../src/core/rendering/shader/shader_pool.h"
 #include "../src/core/rendering/primitives/global_quad.h"
+#include "../src/core/rendering/instancing/instancing.h"
 #include "../src/core/rendering/material/lit/lit_material.h"
 #include "../src/core/rendering/transformation/transformation.h"
 
 PreviewPipeline::PreviewPipeline() : fbo(0),
+viewUniforms(),
+lightUniforms(),
+lightClusters(),
 outputs(),
 renderInstructions()
 {
@@ -21,6 +25,11 @@ void PreviewPipeline::create()
 	// Generate framebuffer
 	glCreateFramebuffers(1, &fbo);
 	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+	// Create view and light uniforms and light clusters
+	viewUniforms.create();
+	lightUniforms.create();
+	lightClusters.create();
 }
 
 void PreviewPipeline::destroy()
@@ -29,6 +38,11 @@ void PreviewPipeline::destroy()
 	glDeleteFramebuffers(1, &fbo);
 	fbo = 0;
 
+	// Destroy view and light uniforms and light clusters
+	viewUniforms.destroy();
+	lightUniforms.destroy();
+	lightClusters.destroy();
+
 	// Delete all outputs
 	for (PreviewOutput output : outputs) {
 		glDeleteTextures(1, &output.texture);
@@ -84,6 +98,9 @@ void PreviewPipeline::render()
 	// Bind framebuffer
 	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
 
+	// Previews are lit by a sample directional light
+	if (!renderInstructions.empty()) lightUniforms.updateSample();
+
 	// Perform all render instructions
 	for (PreviewRenderInstruction instruction : renderInstructions) {
 		
@@ -116,27 +133,21 @@ void PreviewPipeline::render()
 		Shader* shader = instruction.modelMaterial->getShader();
 		shader->bind();
 		instruction.modelMaterial->bind();
-		instruction.modelMaterial->setSampleDirectionalLight();
 
 		// Calculate and sync transform matrices
 		glm::mat4 _model = Transformation::model(instruction.modelTransform.position, instruction.modelTransform.rotation, instruction.modelTransform.scale);
 		glm::mat4 _view = Transformation::view(instruction.cameraTransform.position, instruction.cameraTransform.rotation);
 		glm::mat4 _projection = Transformation::projection(45.0f, output.viewport.getAspect(), 0.3f, 1000.0f);
-		glm::mat4 _mvp = _projection * _view * _model;
 		glm::mat4 _normal = Transformation::normal(_model);
-		shader->setMatrix4("mvpMatrix", _mvp);
-		shader->setMatrix4("modelMatrix", _model);
-		shader->setMatrix3("normalMatrix", _normal);
+		viewUniforms.update(_view, _projection, output.viewport.getResolution());
+		lightClusters.update(lightUniforms, _view, _projection, output.viewport.getResolution());
 
-		// Bind and render all meshes of model
+		// Render all meshes of model
 		for (int i = 0; i < instruction.model->nLoadedMeshes(); i++) {
 			const Mesh* mesh = instruction.model->queryMesh(i);
-			glBindVertexArray(mesh->getVAO());
-			glDrawElements(GL_TRIANGLES, mesh->getIndiceCount(), GL_UNSIGNED_INT, 0);
+			Instancing::drawSingle(*mesh, _model, _normal);
 		}
 
-		instruction.modelMaterial->syncLightUniforms();
-
 	}
 
 	// Clear render instructions
@@ -5,6 +5,9 @@
 
 #include "../src/core/ecs/components.h"
 #include "../src/core/viewport/viewport.h"
+#include "../src/core/rendering/uniforms/view_uniforms.h"
+#include "../src/core/rendering/uniforms/light_uniforms.h"
+#include "../src/core/rendering/culling/light_clusters.h"
 
 class Model;
 class LitMaterial;
@@ -53,6 +56,9 @@ public:
 private:
 	uint32_t fbo;
 	uint32_t rbo;
+	ViewUniforms viewUniforms;
+	LightUniforms lightUniforms;
+	LightClusters lightClusters;
 	std::vector<PreviewOutput> outputs;
 	std::vector<PreviewRenderInstruction> renderInstructions;
 };
\ No newline at end of file
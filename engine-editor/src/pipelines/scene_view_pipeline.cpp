@@ -4,10 +4,11 @@
 #include "../src/core/input/input.h"
 #include "../src/core/physics/physics.h"
 #include "../src/core/diagnostics/profiler.h"
-#include "../src/core/rendering/shadows/shadow_map.h"
+#include "../src/core/rendering/shadows/shadow_atlas.h"
 #include "../src/core/rendering/transformation/transformation.h"
 #include "../src/core/rendering/culling/bounding_volume.h"
 #include "../src/core/rendering/material/lit/lit_material.h"
+#include "../src/core/rendering/texture/texture_streaming.h"
 
 #include "../src/runtime/runtime.h"
 #include "../src/ui/windows/viewport_window.h"
@@ -26,8 +27,13 @@ defaultProfile(),
 flyCameraTransform(),
 flyCameraRoot(),
 flyCamera(flyCameraTransform, flyCameraRoot),
+viewUniforms(),
+lightClusters(),
+cascadedShadowMap(2048, 4, 200.0f),
+cascadeUniforms(),
 preprocessorPass(),
 prePass(viewport),
+hizPass(viewport),
 sceneViewForwardPass(viewport),
 ssaoPass(viewport),
 postProcessingPipeline(viewport, false),
@@ -56,6 +62,12 @@ void SceneViewPipeline::create()
 	// Setup fly camera
 	std::get<1>(flyCamera).fov = 90.0f;
 
+	// Create view uniforms, light clusters and cascades
+	viewUniforms.create();
+	lightClusters.create();
+	cascadedShadowMap.create();
+	cascadeUniforms.create();
+
 	// Create passes
 	createPasses();
 
@@ -65,6 +77,12 @@ void SceneViewPipeline::create()
 
 void SceneViewPipeline::destroy()
 {
+	// Destroy view uniforms, light clusters and cascades
+	viewUniforms.destroy();
+	lightClusters.destroy();
+	cascadedShadowMap.destroy();
+	cascadeUniforms.destroy();
+
 	// Destroy passes
 	destroyPasses();
 }
@@ -85,7 +103,19 @@ void SceneViewPipeline::render()
 	view = Transformation::view(cameraTransform.position, cameraTransform.rotation);
 	projection = Transformation::projection(cameraHandle.fov, viewport.getAspect(), cameraHandle.near, cameraHandle.far);
 	glm::mat4 viewProjection = projection * view;
-	glm::mat3 viewNormal = glm::transpose(glm::inverse(glm::mat3(view)));
+
+	// Upload view data for all upcoming draws
+	viewUniforms.update(view, projection, viewport.getResolution(), targetProfile.color.gamma, targetProfile.ambientOcclusion.enabled, renderShadows);
+
+	// Assign lights to the clusters of the view
+	lightClusters.update(Runtime::getLightUniforms(), view, projection, viewport.getResolution());
+
+	//
+	// CASCADED SHADOW PASS
+	// Render the cascades of the main directional light fit to the cameras view if shadows are shown
+	//
+	if (renderShadows) cascadedShadowMap.castShadows(Runtime::getShadowCasters(), view, projection);
+	cascadeUniforms.update(cascadedShadowMap);
 
 	// Start new gizmo frame
 	IMGizmo& gizmos = Runtime::getSceneGizmos();
@@ -94,18 +124,29 @@ void SceneViewPipeline::render()
 
 	//
 	// PREPROCESSOR PASS
-	// Evaluate and update transforms, perform culling etc.
+	// Perform culling against the view frustum and previous depth and sort visible entities
+	// Hidden entities are kept when rendering wireframe, where they are seen
 	// 
-	preprocessorPass.perform(viewProjection);
+	const OcclusionCulling::DepthPyramid* occluders = hizPass.readOccluders();
+	preprocessorPass.perform(viewProjection, wireframe ? nullptr : occluders);
+
+	// Request texture levels needed for visible entities
+	TextureStreaming::requestVisible(preprocessorPass.getVisibleQueue(), cameraTransform.position, projection, viewport.getHeight());
 
 	//
 	// PRE PASS
 	// Create geometry pass with depth buffer before forward pass
 	//
-	prePass.render(viewProjection, viewNormal);
+	prePass.render(preprocessorPass.getVisibleQueue());
 	const uint32_t PRE_PASS_DEPTH_OUTPUT = prePass.getDepthOutput();
 	const uint32_t PRE_PASS_NORMAL_OUTPUT = prePass.getNormalOutput();
 
+	//
+	// HI-Z PASS
+	// Build depth pyramid from pre pass depth for occlusion culling of the upcoming frames
+	//
+	hizPass.render(PRE_PASS_DEPTH_OUTPUT, viewProjection);
+
 	//
 	// SCREEN SPACE AMBIENT OCCLUSION PASS
 	// Calculate screen space ambient occlusion if enabled
@@ -127,19 +168,16 @@ void SceneViewPipeline::render()
 	//
 
 	// Prepare lit material with current render data
-	LitMaterial::viewport = &viewport; // Redundant most of the times atm
-	LitMaterial::cameraTransform = &cameraTransform; // Redundant most of the times atm
 	LitMaterial::ssaoInput = SSAO_OUTPUT;
-	LitMaterial::profile = &targetProfile;
-	LitMaterial::castShadows = renderShadows;
 	LitMaterial::mainShadowDisk = Runtime::getMainShadowDisk();
-	LitMaterial::mainShadowMap = Runtime::getMainShadowMap();
+	LitMaterial::mainShadowAtlas = &Runtime::getShadowAtlas();
+	LitMaterial::mainCascadedShadowMap = &cascadedShadowMap;
 
 	sceneViewForwardPass.wireframe = wireframe;
 	sceneViewForwardPass.drawSkybox = showSkybox;
 	sceneViewForwardPass.linkSkybox(Runtime::getGameViewPipeline().getLinkedSkybox());
 	sceneViewForwardPass.drawGizmos = showGizmos;
-	uint32_t FORWARD_PASS_OUTPUT = sceneViewForwardPass.render(view, projection, viewProjection, camera, selectedEntities);
+	uint32_t FORWARD_PASS_OUTPUT = sceneViewForwardPass.render(view, projection, viewProjection, camera, selectedEntities, preprocessorPass.getVisibleQueue());
 
 	//
 	// POST PROCESSING PASS
@@ -224,6 +262,7 @@ const glm::mat4& SceneViewPipeline::getProjection() const
 void SceneViewPipeline::createPasses()
 {
 	prePass.create();
+	hizPass.create();
 	sceneViewForwardPass.create(msaaSamples);
 	sceneViewForwardPass.linkGizmos(&Runtime::getSceneGizmos());
 	ssaoPass.create();
@@ -233,6 +272,7 @@ void SceneViewPipeline::createPasses()
 void SceneViewPipeline::destroyPasses()
 {
 	prePass.destroy();
+	hizPass.destroy();
 	sceneViewForwardPass.destroy();
 	ssaoPass.destroy();
 	postProcessingPipeline.destroy();
@@ -9,7 +9,12 @@
 #include "../src/core/rendering/gizmos/gizmos.h"
 #include "../src/core/rendering/passes/ssao_pass.h"
 #include "../src/core/rendering/passes/pre_pass.h"
+#include "../src/core/rendering/passes/hiz_pass.h"
 #include "../src/core/rendering/passes/preprocessor_pass.h"
+#include "../src/core/rendering/uniforms/view_uniforms.h"
+#include "../src/core/rendering/culling/light_clusters.h"
+#include "../src/core/rendering/uniforms/cascade_uniforms.h"
+#include "../src/core/rendering/shadows/cascaded_shadow_map.h"
 #include "../src/core/rendering/velocitybuffer/velocity_buffer.h"
 #include "../src/core/rendering/postprocessing/post_processing.h"
 #include "../src/core/rendering/sceneview/scene_view_forward_pass.h"
@@ -101,6 +106,10 @@ private:
 	TransformComponent flyCameraTransform;
 	CameraComponent flyCameraRoot;
 	Camera flyCamera;
+	ViewUniforms viewUniforms;
+	LightClusters lightClusters;
+	CascadedShadowMap cascadedShadowMap;
+	CascadeUniforms cascadeUniforms;
 
 	//
 	// Linked passes
@@ -108,6 +117,7 @@ private:
 
 	PreprocessorPass preprocessorPass;
 	PrePass prePass;
+	HiZPass hizPass;
 	SceneViewForwardPass sceneViewForwardPass;
 	SSAOPass ssaoPass;
 	PostProcessingPipeline postProcessingPipeline;
@@ -13,16 +13,21 @@
 #include "../src/core/rendering/shader/shader.h"
 #include "../src/core/rendering/skybox/cubemap.h"
 #include "../src/core/rendering/texture/texture.h"
+#include "../src/core/rendering/texture/texture_compression.h"
 #include "../src/ui/windows/insight_panel_window.h"
 #include "../src/core/rendering/shader/shader_pool.h"
-#include "../src/core/rendering/shadows/shadow_map.h"
+#include "../src/core/rendering/shadows/shadow_atlas.h"
 #include "../src/core/rendering/shadows/shadow_disk.h"
+#include "../src/core/rendering/passes/preprocessor_pass.h"
+#include "../src/core/rendering/uniforms/light_uniforms.h"
+#include "../src/core/rendering/uniforms/shadow_uniforms.h"
 #include "../src/ui/inspectables/welcome_inspectable.h"
 #include "../src/core/rendering/material/lit/lit_material.h"
 #include "../src/core/rendering/transformation/transformation.h"
 
 #include "../src/core/utils/console.h"
 #include "../src/core/time/time.h"
+#include "../src/core/jobs/job_system.h"
 #include "../src/core/physics/physics.h"
 #include "../src/core/viewport/viewport.h"
 #include "../src/core/ecs/ecs_collection.h"
@@ -48,7 +53,12 @@ namespace Runtime {
 
 	// Shadow
 	ShadowDisk* gMainShadowDisk = nullptr;
-	ShadowMap* gMainShadowMap = nullptr;
+	ShadowCasters gShadowCasters;
+	ShadowAtlas gShadowAtlas(4096);
+
+	// Per-frame uniforms of lights and shadow configuration
+	LightUniforms gLightUniforms;
+	ShadowUniforms gShadowUniforms;
 
 	// Default assets
 	Texture* gDefaultTexture = new Texture();
@@ -97,11 +107,20 @@ namespace Runtime {
 
 	void _createResources() {
 
+#ifdef _DEBUG
+		// Verify block compression round trips before any texture is cooked
+		if (!TextureCompression::selfTest()) Console::out::warning("Runtime", "Texture compression self test failed, cooked textures may be corrupted");
+#endif
+
 		// Create pipelines
 		gSceneViewPipeline.create();
 		gGameViewPipeline.create();
 		gPreviewPipeline.create();
 
+		// Create frame uniforms
+		gLightUniforms.create();
+		gShadowUniforms.create();
+
 		// Create game physics instance
 		gGamePhysics.create();
 
@@ -109,44 +128,44 @@ namespace Runtime {
 		gSceneGizmos.create();
 
 		// TMP:
-		// Create main shadow disk and main shadow map
+		// Create main shadow disk
 		uint32_t diskWindowSize = 4;
 		uint32_t diskFilterSize = 8;
 		uint32_t diskRadius = 5;
 		gMainShadowDisk = new ShadowDisk(diskWindowSize, diskFilterSize, diskRadius);
-		gMainShadowMap = new ShadowMap(4096, 4096);
-		gMainShadowMap->create();
+
+		// Create shadow atlas of point lights and spotlights
+		gShadowAtlas.create();
 
 	}
 
 	void _renderShadowsGlobal()
 	{
-		// WARNING
-		// 
-		// Right now, the shadow passes will use the "current model matrix" from the mesh renderer.
-		// As the shadows will be rendered before the other rendering pipelines,
-		// which prepare the mesh renderer by among other things calculating and 
-		// settings its "current model matrix", the "current model matrix" will always be
-		// one frame delayed, ultimately delaying object movement for shadows by one frame
-		//
-		// Fix: Calculate transform matrices before rendering shadows
-
 		//
 		// SHADOW PASS
-		// Render shadow map
+		// Render shadow atlas tiles of point lights and spotlights
 		//
 
-		// Make sure shadow map is created
-		if (!gMainShadowMap) return;
+		Profiler::start("shadow_pass");
 
-		// Temporary: Render first spotlight to be found in registry
-		auto spotlights = ECS::gRegistry.view<TransformComponent, SpotlightComponent>();
-		for (auto [entity, transform, spotlight] : spotlights.each()) {
-			Profiler::start("shadow_pass");
-			gMainShadowMap->castShadows(spotlight, transform);
-			Profiler::stop("shadow_pass");
-			break;
-		}
+		// Gather shadow casters once for the atlas and all cascaded shadow maps of this frame
+		gShadowCasters.gather();
+
+		// Size atlas tiles by their coverage of the game camera while the game is running, of the scene views camera otherwise
+		std::optional<Camera> gameCamera = ECS::getLatestCamera();
+		const TransformComponent& cameraTransform = gGameState == GameState::GAME_RUNNING && gameCamera ? std::get<0>(*gameCamera) : std::get<0>(gSceneViewPipeline.getFlyCamera());
+		gShadowAtlas.castShadows(gShadowCasters, Transformation::toBackendPosition(cameraTransform.position));
+
+		Profiler::stop("shadow_pass");
+	}
+
+	void _updateFrameUniforms()
+	{
+		// Upload light sources
+		gLightUniforms.update(gShadowAtlas);
+
+		// Upload shadow configuration
+		if (gMainShadowDisk) gShadowUniforms.update(gShadowAtlas, *gMainShadowDisk);
 	}
 
 	void _stepGame() {
@@ -200,8 +219,14 @@ namespace Runtime {
 		// UPDATE GAME IF GAME IS RUNNING
 		if (gGameState == GameState::GAME_RUNNING) _stepGame();
 
+		// EVALUATE TRANSFORMS AND BOUNDS ONCE FOR ALL VIEWS
+		Profiler::start("prepare_frame");
+		PreprocessorPass::prepareFrame();
+		Profiler::stop("prepare_frame");
+
 		// RENDER NEXT FRAME
 		_renderShadowsGlobal();
+		_updateFrameUniforms();
 		gSceneViewPipeline.render();
 		gGameViewPipeline.render();
 		gPreviewPipeline.render();
@@ -224,6 +249,9 @@ namespace Runtime {
 
 	int START_LOOP()
 	{
+		// SETUP JOB SYSTEM
+		JobSystem::setup();
+
 		// CREATE CONTEXT
 		_createApplicationContext();
 
@@ -239,11 +267,8 @@ namespace Runtime {
 		// SETUP GAME
 		gameSetup();
 
-		// GENERATE INITIAL RENDER QUEUE
-		ECS::generateRenderQueue();
-
 		// TMP LOADING DEFAULT CUBEMAP ASYNCHRONOUSLY HERE
-		ApplicationContext::getResourceLoader().createAsync(gDefaultCubemap);
+		ApplicationContext::getResourceLoader().createAsync(gDefaultCubemap, ResourcePriority::CRITICAL);
 
 		// SHOW WELCOME INSPECTABLE
 		InsightPanelWindow::inspect<WelcomeInspectable>();
@@ -265,9 +290,19 @@ namespace Runtime {
 		gGameViewPipeline.destroy();
 		gPreviewPipeline.destroy();
 
+		// Destroy frame uniforms
+		gLightUniforms.destroy();
+		gShadowUniforms.destroy();
+
+		// Destroy shadow atlas
+		gShadowAtlas.destroy();
+
 		// Destroy physics
 		gGamePhysics.destroy();
 
+		// Shutdown job system
+		JobSystem::shutdown();
+
 		// Destroy context
 		ApplicationContext::destroy();
 
@@ -363,9 +398,19 @@ namespace Runtime {
 		return gMainShadowDisk;
 	}
 
-	ShadowMap* getMainShadowMap()
+	ShadowAtlas& getShadowAtlas()
+	{
+		return gShadowAtlas;
+	}
+
+	ShadowCasters& getShadowCasters()
+	{
+		return gShadowCasters;
+	}
+
+	const LightUniforms& getLightUniforms()
 	{
-		return gMainShadowMap;
+		return gLightUniforms;
 	}
 
 }
\ No newline at end of file
@@ -14,7 +14,8 @@
 namespace fs = std::filesystem;
 
 class ShadowDisk;
-class ShadowMap;
+class ShadowAtlas;
+class ShadowCasters;
 
 class Model;
 class LitMaterial;
@@ -78,5 +79,17 @@ namespace Runtime
 	//
 
 	ShadowDisk* getMainShadowDisk();
-	ShadowMap* getMainShadowMap();
+
+	// Returns the shadow atlas of point lights and spotlights
+	ShadowAtlas& getShadowAtlas();
+
+	// Returns the shadow casters gathered for the current frame
+	ShadowCasters& getShadowCasters();
+
+	//
+	// Light getters
+	//
+
+	// Returns the light sources of the current frame
+	const LightUniforms& getLightUniforms();
 };
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <implot.h>
 
 #include "../src/core/time/time.h"
+#include "../src/core/jobs/job_system.h"
 #include "../src/core/diagnostics/profiler.h"
 #include "../src/core/diagnostics/diagnostics.h"
 
@@ -76,7 +77,12 @@ void DiagnosticsWindow::render()
 
 		IMComponents::indicatorLabel("Rendering:", Profiler::getMs("render"), "ms");
 		IMComponents::indicatorLabel("Physics:", Profiler::getMs("physics"), "ms");
+		IMComponents::indicatorLabel("Frame Preparation:", Profiler::getMs("prepare_frame"), "ms");
+		for (uint32_t i = 0; i < JobSystem::getThreadCount(); i++) {
+			IMComponents::indicatorLabel("  Thread " + std::to_string(i) + ":", Profiler::getMs("prepare_frame_thread_" + std::to_string(i)), "ms");
+		}
 		IMComponents::indicatorLabel("Shadow Pass:", Profiler::getMs("shadow_pass"), "ms");
+		IMComponents::indicatorLabel("Cascaded Shadow Pass:", Profiler::getMs("cascaded_shadow_pass"), "ms");
 		IMComponents::indicatorLabel("Preprocessor Pass:", Profiler::getMs("preprocessor_pass"), "ms");
 		IMComponents::indicatorLabel("Pre Pass:", Profiler::getMs("pre_pass"), "ms");
 		IMComponents::indicatorLabel("SSAO Pass:", Profiler::getMs("ssao"), "ms");
@@ -6,7 +6,6 @@
 #include "../src/core/time/time.h"
 #include "../src/core/utils/console.h"
 #include "../src/core/rendering/transformation/transformation.h"
-#include "../src/core/rendering/shadows/shadow_map.h"
 
 GameWindow::GameWindow() : currentContentAvail(ImVec2(0.0f, 0.0f)),
 lastContentAvail(ImVec2(0.0f, 0.0f)),